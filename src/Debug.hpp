@@ -8,6 +8,15 @@
 #include <streambuf>
 #include <chrono>
 #include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
 #include <cassert>
 
 #if !defined(USE_STD_PUT_TIME)
@@ -26,8 +35,299 @@
     #define CHESSPP_LOG_FILE_OPEN_MODE std::ios::app
 #endif
 
+//Logs a message to std::clog from code that runs often, such as every move or
+//every piece created, unless compiled out with CHESSPP_NO_HOT_LOGS or the log
+//level is above Debug. The message may chain with <<, e.g. "at " << pos
+#ifdef CHESSPP_NO_HOT_LOGS
+    #define CHESSPP_HOT_LOG(message) ((void)0)
+#else
+    #define CHESSPP_HOT_LOG(message) (LogUtil::enabled(LogUtil::Level::Debug) ? void(std::clog << message << std::endl) : void())
+#endif
+
 class LogUtil //replaces std::clog, std::cerr, std::cout with file streams
 {
+public:
+    //The least severe level logged can be changed at runtime, or set with the CHESSPP_LOG_LEVEL environment variable
+    enum class Level : int
+    {
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+    //Asynchronous logging only formats lines on the thread that logs them, a background thread writes them to the files
+    enum class Mode
+    {
+        Synchronous,
+        Asynchronous
+    };
+
+    static bool enabled(Level l) noexcept
+    {
+        return int(l) >= threshold().load(std::memory_order_relaxed);
+    }
+    static void setLevel(Level l) noexcept
+    {
+        threshold().store(int(l), std::memory_order_relaxed);
+    }
+
+private:
+    static std::atomic<int> &threshold() noexcept
+    {
+        static std::atomic<int> t {levelFromEnvironment()};
+        return t;
+    }
+    static int levelFromEnvironment() noexcept
+    {
+        char const *l = std::getenv("CHESSPP_LOG_LEVEL");
+        if(!l)                             return int(Level::Debug);
+        if(std::strcmp(l, "info")    == 0) return int(Level::Info);
+        if(std::strcmp(l, "warning") == 0) return int(Level::Warning);
+        if(std::strcmp(l, "error")   == 0) return int(Level::Error);
+        return int(Level::Debug);
+    }
+
+    //returns std::string containing current system time.
+    //should eventually be updated to use std::put_time
+    static std::string timestamp(std::time_t curr_time_raw = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()))
+    {
+        std::tm *lt = std::localtime(&curr_time_raw);
+
+        std::stringstream time;
+#if USE_STD_PUT_TIME
+        time << "[" << std::put_time(lt, "%T") << "] ";
+#else
+        time << "[" << boost::posix_time::to_simple_string(boost::posix_time::time_duration(lt->tm_hour, lt->tm_min, lt->tm_sec)) << "] ";
+#endif
+        return time.str();
+    }
+
+    /**
+     * A bounded multiple-producer single-consumer queue of chunks of
+     * log text. Producers take tickets with an atomic increment and
+     * only wait if the queue is full; the consumer never blocks them.
+     */
+    class LogUtil_ring
+    {
+    public:
+        static constexpr std::size_t Capacity = 4096; //a power of two
+        static constexpr std::size_t Payload = 240;
+
+        class Record
+        {
+        public:
+            std::atomic<std::size_t> sequence;
+            std::time_t time;
+            std::uint8_t sink;
+            std::uint8_t length;
+            bool ends_line;
+            char text[Payload];
+        };
+
+    private:
+        std::unique_ptr<Record[]> records {new Record[Capacity]};
+        std::atomic<std::size_t> head {0}; //next ticket of the producers
+        char padding[64];                  //keeps head and tail on separate cache lines
+        std::size_t tail = 0;              //next record of the consumer
+
+    public:
+        LogUtil_ring() noexcept
+        {
+            for(std::size_t i = 0; i < Capacity; ++i)
+            {
+                records[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        void push(std::uint8_t sink, std::time_t time, char const *text, std::size_t length, bool ends_line) noexcept
+        {
+            std::size_t ticket = head.fetch_add(1, std::memory_order_relaxed);
+            Record &r = records[ticket & (Capacity - 1)];
+            while(r.sequence.load(std::memory_order_acquire) != ticket)
+            {
+                std::this_thread::yield(); //full, the writer is behind
+            }
+            r.time = time;
+            r.sink = sink;
+            r.length = std::uint8_t(length);
+            r.ends_line = ends_line;
+            std::memcpy(r.text, text, length);
+            r.sequence.store(ticket + 1, std::memory_order_release);
+        }
+        //Only called by the consumer, returns nullptr if there is nothing to take
+        Record *front() noexcept
+        {
+            Record &r = records[tail & (Capacity - 1)];
+            if(r.sequence.load(std::memory_order_acquire) != tail + 1)
+            {
+                return nullptr;
+            }
+            return &r;
+        }
+        void pop() noexcept
+        {
+            records[tail & (Capacity - 1)].sequence.store(tail + Capacity, std::memory_order_release);
+            ++tail;
+        }
+    };
+
+    /**
+     * Collects what each thread logs into whole lines, then queues
+     * them for the writer thread, so that logging never waits on the
+     * files and lines of different threads are not mixed.
+     */
+    class LogUtil_async_buffer : public std::streambuf
+    {
+        //Trivially destructible, so that it can still be used while the program exits
+        class Pending
+        {
+        public:
+            char text[LogUtil_ring::Payload];
+            std::size_t length;
+        };
+
+        LogUtil_ring &ring;
+        std::uint8_t sink;
+
+        Pending &pending() noexcept
+        {
+            thread_local Pending lines[3]; //by sink
+            return lines[sink];
+        }
+        void emit(Pending &line, bool ends_line) noexcept
+        {
+            std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            ring.push(sink, now, line.text, line.length, ends_line);
+            line.length = 0;
+        }
+
+    public:
+        LogUtil_async_buffer(LogUtil_ring &ring_, std::uint8_t sink_) noexcept
+        : ring(ring_) //can't use {}
+        , sink{sink_}
+        {
+        }
+
+    private:
+        LogUtil_async_buffer(LogUtil_async_buffer const &) = delete;
+        LogUtil_async_buffer &operator=(LogUtil_async_buffer const &) = delete;
+
+        std::streamsize xsputn(char const *s, std::streamsize n) override
+        {
+            Pending &line = pending();
+            for(char const *e = s + n; s != e; ++s)
+            {
+                if(*s == '\n')
+                {
+                    emit(line, true);
+                    continue;
+                }
+                if(line.length == sizeof(line.text))
+                {
+                    emit(line, false); //long lines are queued in pieces
+                }
+                line.text[line.length++] = *s;
+            }
+            return n;
+        }
+        int_type overflow(int_type ch) override
+        {
+            if(ch != traits_type::eof())
+            {
+                char c = traits_type::to_char_type(ch);
+                xsputn(&c, 1);
+            }
+            return traits_type::not_eof(ch);
+        }
+        int sync() override
+        {
+            Pending &line = pending();
+            if(line.length > 0)
+            {
+                emit(line, false);
+            }
+            return 0;
+        }
+    };
+
+    /**
+     * Writes what the async buffers queue to the log files, adding
+     * timestamps, which it formats again only when the second changes.
+     */
+    class LogUtil_writer
+    {
+        LogUtil_ring &ring;
+        std::ostream *sinks[3];
+        bool timestamp_on_next_text[3] = {true, true, true};
+        std::time_t cached_time = 0;
+        std::string cached_stamp;
+        std::atomic<bool> running {true};
+        std::thread thread;
+
+        void write(LogUtil_ring::Record const &r)
+        {
+            std::ostream &sink = *sinks[r.sink];
+            if(timestamp_on_next_text[r.sink] && r.length > 0 && !std::isspace(r.text[0]))
+            {
+                if(r.time != cached_time || cached_stamp.empty())
+                {
+                    cached_time = r.time;
+                    cached_stamp = timestamp(r.time);
+                }
+                sink << cached_stamp;
+            }
+            if(r.length > 0) timestamp_on_next_text[r.sink] = false;
+            sink.write(r.text, r.length);
+            if(r.ends_line)
+            {
+                sink << '\n';
+                timestamp_on_next_text[r.sink] = true;
+            }
+        }
+        void run()
+        {
+            for(;;)
+            {
+                bool stopping = !running.load(std::memory_order_acquire);
+                bool wrote = false;
+                while(auto *r = ring.front())
+                {
+                    write(*r);
+                    ring.pop();
+                    wrote = true;
+                }
+                if(wrote)
+                {
+                    for(auto *s : sinks) s->flush();
+                }
+                else if(stopping)
+                {
+                    return;
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+
+    public:
+        LogUtil_writer(LogUtil_ring &ring_, std::ostream &log, std::ostream &err, std::ostream &out)
+        : ring(ring_) //can't use {}
+        , sinks{&log, &err, &out}
+        , thread{[this]{ run(); }}
+        {
+        }
+        LogUtil_writer(LogUtil_writer const &) = delete;
+        LogUtil_writer &operator=(LogUtil_writer const &) = delete;
+        //Writes what is left before returning
+        ~LogUtil_writer()
+        {
+            running.store(false, std::memory_order_release);
+            thread.join();
+        }
+    };
+
     class LogUtil_buffer : public std::streambuf
     {
         bool timestamp_on_next_text = true;
@@ -90,47 +390,56 @@ class LogUtil //replaces std::clog, std::cerr, std::cout with file streams
             return timestamp_and_flush() ? 0 : -1;
         }
 
-        //returns std::string containing current system time.
-        //should eventually be updated to use std::put_time
-        static std::string timestamp()
-        {
-            std::time_t curr_time_raw = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-            std::tm *lt = std::localtime(&curr_time_raw);
-
-            std::stringstream time;
-#if USE_STD_PUT_TIME
-            time << "[" << std::put_time(lt, "%T") << "] ";
-#else
-            time << "[" << boost::posix_time::to_simple_string(boost::posix_time::time_duration(lt->tm_hour, lt->tm_min, lt->tm_sec)) << "] ";
-#endif
-            return time.str();
-        }
     };
 
     std::ofstream log {"debug_log.log", std::ios::out|CHESSPP_LOG_FILE_OPEN_MODE}
                 , err {"debug_err.log", std::ios::out|CHESSPP_LOG_FILE_OPEN_MODE}
                 , out {"debug_out.log", std::ios::out|CHESSPP_LOG_FILE_OPEN_MODE};
-    LogUtil_buffer logbuf {log}
-                 , errbuf {err}
-                 , outbuf {out};
-    std::streambuf *clogbuf {log ? std::clog.rdbuf(&logbuf) : std::clog.rdbuf()}
-                 , *cerrbuf {err ? std::cerr.rdbuf(&errbuf) : std::cerr.rdbuf()}
-                 , *coutbuf {out ? std::cout.rdbuf(&outbuf) : std::cout.rdbuf()};
-    LogUtil() = default;
+    std::unique_ptr<LogUtil_ring> ring;
+    std::unique_ptr<LogUtil_writer> writer; //after the files and the ring, so it finishes writing first
+    std::unique_ptr<std::streambuf> logbuf
+                                  , errbuf
+                                  , outbuf;
+    std::streambuf *clogbuf {nullptr}
+                 , *cerrbuf {nullptr}
+                 , *coutbuf {nullptr};
+    LogUtil(Mode mode)
+    {
+        if(mode == Mode::Asynchronous)
+        {
+            ring.reset(new LogUtil_ring);
+            writer.reset(new LogUtil_writer{*ring, log, err, out});
+            logbuf.reset(new LogUtil_async_buffer{*ring, 0});
+            errbuf.reset(new LogUtil_async_buffer{*ring, 1});
+            outbuf.reset(new LogUtil_async_buffer{*ring, 2});
+        }
+        else
+        {
+            logbuf.reset(new LogUtil_buffer{log});
+            errbuf.reset(new LogUtil_buffer{err});
+            outbuf.reset(new LogUtil_buffer{out});
+        }
+        clogbuf = log ? std::clog.rdbuf(logbuf.get()) : std::clog.rdbuf();
+        cerrbuf = err ? std::cerr.rdbuf(errbuf.get()) : std::cerr.rdbuf();
+        coutbuf = out ? std::cout.rdbuf(outbuf.get()) : std::cout.rdbuf();
+    }
     LogUtil(LogUtil const &) = delete;
     LogUtil(LogUtil &&) = delete;
     LogUtil &operator=(LogUtil const &) = delete;
     LogUtil &operator=(LogUtil &&) = delete;
 public:
-    static void enableRedirection() noexcept
+    //Only the first call has an effect
+    static void enableRedirection(Mode mode = Mode::Asynchronous) noexcept
     {
-        static LogUtil lu;
+        static LogUtil lu {mode};
     }
     ~LogUtil()
     {
+        std::clog.flush(), std::cerr.flush(), std::cout.flush();
         std::clog.rdbuf(clogbuf), clogbuf = nullptr;
         std::cerr.rdbuf(cerrbuf), cerrbuf = nullptr;
         std::cout.rdbuf(coutbuf), coutbuf = nullptr;
+        writer.reset(); //drains the ring
     }
 };
 
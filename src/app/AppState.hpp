@@ -8,9 +8,16 @@ namespace chesspp
 {
     namespace app
     {
-        //Pure virtual abstract base class for game state management
+        /**
+         * Pure virtual abstract base class for game state management.
+         * A state is only rendered after it has been invalidated, so
+         * an idle window waits for events instead of redrawing, unless
+         * it sets a frame rate to be rendered at for animation.
+         */
         class AppState : public virtual SfmlEventHandler
         {
+            bool invalid = true;
+
         public:
             AppState(sf::RenderWindow &disp)
             : display(disp) //cannot use {}
@@ -19,8 +26,34 @@ namespace chesspp
 
             virtual void onRender() = 0;
 
+            //Asks for the state to be rendered again
+            void invalidate() noexcept
+            {
+                invalid = true;
+            }
+            bool dirty() const noexcept
+            {
+                return invalid;
+            }
+            //Whether the state renders every frame rather than when invalidated
+            bool animated() const noexcept
+            {
+                return frame_rate > 0;
+            }
+            unsigned frameRate() const noexcept
+            {
+                return frame_rate;
+            }
+            //Called by Application, onRender() may invalidate the state again
+            void render()
+            {
+                invalid = false;
+                onRender();
+            }
+
         protected:
             sf::RenderWindow &display;
+            unsigned frame_rate = 0; //frames per second while animated, 0 when not
         };
     }
 }
@@ -1,22 +1,67 @@
 #include "Application.hpp"
 
+#include "util/Allocations.hpp"
+
+#include <thread>
+#include <algorithm>
+
 namespace chesspp
 {
     namespace app
     {
+        constexpr std::chrono::milliseconds Application::JobPoll;
+
         int Application::execute()
         {
+            using Clock_t = std::chrono::steady_clock;
             running = true;
             sf::Event event;
+            Clock_t::time_point frame = Clock_t::now();
             while(running)
             {
-                while(display.pollEvent(event))
+                if(!state->animated() && !state->dirty())
+                {
+                    if(!job_queue.busy())
+                    {
+                        //nothing can change before the next event
+                        if(display.waitEvent(event))
+                        {
+                            onEvent(event);
+                        }
+                    }
+                    else
+                    {
+                        //a job's completion may change the state, but it can't wake waitEvent()
+                        std::this_thread::sleep_for(JobPoll);
+                    }
+                }
+                while(running && display.pollEvent(event))
                 {
                     onEvent(event);
                 }
+                job_queue.drain();
+                if(!running) break;
 
-                state->onRender();
-                display.display();
+                if(state->animated() || state->dirty())
+                {
+                    {
+                        CHESSPP_PROFILE_SCOPE("frame");
+                        CHESSPP_PROFILE_ALLOCATIONS("frame");
+                        state->render();
+                        display.display();
+                    }
+                    if(util::Profiler::enabled())
+                    {
+                        profile = util::Profiler::frame();
+                    }
+                }
+                if(state->animated())
+                {
+                    //sleep off the rest of the frame, without catching up on missed ones
+                    auto period = std::chrono::duration_cast<Clock_t::duration>(std::chrono::duration<double>(1.0/state->frameRate()));
+                    frame = std::max(frame + period, Clock_t::now());
+                    std::this_thread::sleep_until(frame);
+                }
             }
 
             return 0;
@@ -39,6 +84,7 @@ namespace chesspp
                 }
             case sf::Event::Resized:
                 {
+                    state->invalidate();
                     state->onResized(e.size.width, e.size.height);
                     break;
                 }
@@ -49,6 +95,7 @@ namespace chesspp
                 }
             case sf::Event::GainedFocus:
                 {
+                    state->invalidate(); //the window may have been covered
                     state->onGainedFocus();
                     break;
                 }
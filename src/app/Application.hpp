@@ -2,10 +2,14 @@
 #define ChessPlusPlus_App_ApplicationManagementClass_HeaderPlusPlus
 
 #include "AppState.hpp"
+#include "JobQueue.hpp"
 #include "config/ResourcesConfig.hpp"
+#include "res/ImageLoader.hpp"
+#include "util/Profiler.hpp"
 
 #include <memory>
 #include <utility>
+#include <chrono>
 
 namespace chesspp
 {
@@ -16,7 +20,13 @@ namespace chesspp
             config::ResourcesConfig res_config;
             sf::RenderWindow &display;
             bool running = false;
+            JobQueue job_queue; //before state, so states can cancel their jobs when destroyed
+            std::unique_ptr<res::ImageLoader> image_loader;
             std::unique_ptr<AppState> state;
+            util::Profiler::Frame_t profile; //of the last frame rendered
+
+            //How often to check for finished jobs while there is nothing to render
+            static constexpr std::chrono::milliseconds JobPoll {10};
 
             void onEvent(sf::Event &e);
 
@@ -44,6 +54,29 @@ namespace chesspp
             {
                 return res_config;
             }
+            //Completions run on this thread before each onRender()
+            JobQueue &jobs() noexcept
+            {
+                return job_queue;
+            }
+            //Starts decoding images on every core for a later state, unless it was started already
+            void preload(std::vector<std::string> const &paths)
+            {
+                if(!image_loader)
+                {
+                    image_loader.reset(new res::ImageLoader(paths));
+                }
+            }
+            //The images being preloaded, or nullptr
+            res::ImageLoader *preloaded() noexcept
+            {
+                return image_loader.get();
+            }
+            //What ran during the last frame rendered, empty unless built with CHESSPP_PROFILE
+            util::Profiler::Frame_t const &profiled() const noexcept
+            {
+                return profile;
+            }
         };
     }
 }
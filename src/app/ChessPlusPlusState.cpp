@@ -1,27 +1,34 @@
 #include "ChessPlusPlusState.hpp"
 
-#include "util/Utilities.hpp"
+#include "util/Profiler.hpp"
+#include "res/SfmlFileResource.hpp"
 
 #include <iostream>
+#include <sstream>
+#include <iomanip>
 #include <algorithm>
 
 namespace chesspp
 {
     namespace app
     {
+        using Font_res = res::SfmlFileResource<sf::Font>;
+
         ChessPlusPlusState::ChessPlusPlusState(Application &app_, sf::RenderWindow &disp)
         : AppState(disp)                    //can't use {}
         , app(app_)                         //can't use {}
         , res_config(app.resourcesConfig()) //can't use {}
         , board_config{res_config}
-        , graphics{display, res_config, board_config}
+        , graphics{display, res_config, board_config, app.preloaded()}
         , board{board_config}
-        , players{util::KeyIter<config::BoardConfig::Textures_t>
-                               (board_config.texturePaths().cbegin()),
-                  util::KeyIter<config::BoardConfig::Textures_t>
-                               (board_config.texturePaths().cend())}
-        , turn{players.find(board_config.metadata("first turn"))}
+        , players{board_config.suits()}
+        , turn{players.find(board::Board::Suit(std::string(board_config.metadata("first turn"))))}
+        , engine{board_config, board}
+        , font(res_config.resources().from_config<Font_res>("menu", "font")) //can't use {}
+        , profile_text{"", font, 14}
         {
+            profile_text.setColor(sf::Color::White);
+            profile_text.setPosition(4.f, 4.f);
             std::clog << "Number of players: " << players.size() << std::endl;
             if(turn == players.end())
             {
@@ -29,25 +36,54 @@ namespace chesspp
             }
         }
 
+        ChessPlusPlusState::~ChessPlusPlusState()
+        {
+            app.jobs().cancel(thinking); //the search refers to the engine
+        }
+
         void ChessPlusPlusState::nextTurn()
         {
+            invalidate();
             if(++turn == players.end())
             {
                 turn = players.begin();
             }
+            drawn = engine::draw(board);
+            if(drawn != engine::Draw::None)
+            {
+                std::clog << "Draw by " << (drawn == engine::Draw::Repetition? "threefold repetition" : "the fifty-move rule") << std::endl;
+            }
         }
 
         board::Board::Pieces_t::iterator ChessPlusPlusState::find(board::Board::Position_t const &pos) const
         {
-            return std::find_if(board.begin(), board.end(),
-            [&](std::unique_ptr<board::Piece> const &up) -> bool
-            {
-                return up->pos == pos;
-            });
+            return board.pieceAt(pos);
         }
 
         void ChessPlusPlusState::onRender()
         {
+            if(thinking.empty() && drawn == engine::Draw::None && engine.controls(*turn))
+            {
+                selected = board.end();
+                engine.prepare();
+                auto suit = *turn;
+                thinking = app.jobs().submit([this, suit]() -> JobQueue::Completion_t
+                {
+                    auto result = engine.think(suit);
+                    return [this, suit, result]
+                    {
+                        if(engine.play(suit, result))
+                        {
+                            thinking = JobQueue::Job{};
+                            nextTurn();
+                        } //otherwise thinking stays set so the engine doesn't search again
+                    };
+                }, [this]
+                {
+                    engine.stop();
+                });
+            }
+
             graphics.drawBoard(board);
             if(selected != board.end())
             {
@@ -61,19 +97,86 @@ namespace chesspp
                     graphics.drawTrajectory(**piece, (*piece)->suit != *turn);
                 }
             }
+            graphics.flush();
+
+            if(profiling)
+            {
+                std::ostringstream s;
+                s << std::fixed << std::setprecision(2);
+                for(auto const &sample : app.profiled())
+                {
+                    s << sample.name << ": " << sample.count;
+                    if(sample.milliseconds > 0.0)
+                    {
+                        s << " in " << sample.milliseconds << " ms";
+                    }
+                    s << '\n';
+                }
+                if(util::Profiler::tracing())
+                {
+                    s << "tracing (F4 to stop)\n";
+                }
+                profile_text.setString(s.str());
+                display.draw(profile_text);
+            }
+        }
+
+        void ChessPlusPlusState::onClosed()
+        {
+            app.jobs().cancel(thinking);
+        }
+
+        void ChessPlusPlusState::onKeyPressed(sf::Keyboard::Key key, bool alt, bool control, bool shift, bool system)
+        {
+            if(key != sf::Keyboard::F3 && key != sf::Keyboard::F4) return;
+            if(!util::Profiler::enabled())
+            {
+                std::clog << "Profiling was not compiled in, configure with CHESSPP_PROFILE" << std::endl;
+                return;
+            }
+            if(key == sf::Keyboard::F3)
+            {
+                profiling = !profiling;
+                frame_rate = profiling? 30 : 0; //the numbers change every frame
+                invalidate();
+            }
+            else if(!util::Profiler::tracing())
+            {
+                std::clog << "Trace started" << std::endl;
+                util::Profiler::startTrace();
+                invalidate();
+            }
+            else if(util::Profiler::stopTrace("trace.json"))
+            {
+                std::clog << "Trace written to trace.json" << std::endl;
+                invalidate();
+            }
+            else
+            {
+                std::cerr << "Could not write trace.json" << std::endl;
+            }
         }
 
         void ChessPlusPlusState::onMouseMoved(int x, int y)
         {
-            p.x = static_cast<board::Board::Position_t::value_type>(x/board.config.cellWidth());
-            p.y = static_cast<board::Board::Position_t::value_type>(y/board.config.cellHeight());
+            board::Board::Position_t cell
+            {
+                static_cast<board::Board::Position_t::value_type>(x/board.config.cellWidth()),
+                static_cast<board::Board::Position_t::value_type>(y/board.config.cellHeight())
+            };
+            if(!(cell == p))
+            {
+                p = cell;
+                invalidate(); //the hovered trajectory changed
+            }
         }
         void ChessPlusPlusState::onLButtonPressed(int x, int y)
         {
         }
         void ChessPlusPlusState::onLButtonReleased(int x, int y)
         {
-            if(!board.valid(p)) return;
+            if(!board.valid(p) || engine.controls(*turn) || drawn != engine::Draw::None) return;
+            invalidate(); //selecting or deselecting
             if(selected == board.end())
             {
                 selected = find(p); //doesn't matter if board.end(), selected won't change then
@@ -84,46 +187,21 @@ namespace chesspp
             }
             else
             {
-                if(find(p) == board.end() || (*find(p))->suit != (*selected)->suit)[&]
+                if(find(p) == board.end() || (*find(p))->suit != (*selected)->suit)
                 {
+                    //only legal moves, captures are generated first
+                    generate(board, *turn, moves);
+                    auto it = std::find_if(moves.begin(),
+                                           moves.end(),
+                                           [&](engine::Move const &m)
+                                           {
+                                               return m.from == (*selected)->pos && m.to == p;
+                                           });
+                    if(it != moves.end() && engine::MoveGenerator::play(board, *it))
                     {
-                        auto it = std::find_if(board.pieceCapturings().begin(),
-                                               board.pieceCapturings().end(),
-                                               [&](board::Board::Movements_t::value_type const &m)
-                                               {
-                                                   return m.first == selected && m.second == p;
-                                               });
-                        if(it != board.pieceCapturings().end())
-                        {
-                            for(auto jt = board.pieceCapturables().begin(); jt != board.pieceCapturables().end(); ++jt)
-                            {
-                                if(jt->second == p)
-                                {
-                                    if(board.capture(selected, it, jt))
-                                    {
-                                        nextTurn();
-                                        return;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    {
-                        auto it = std::find_if(board.pieceTrajectories().begin(),
-                                               board.pieceTrajectories().end(),
-                                               [&](board::Board::Movements_t::value_type const &m)
-                                               {
-                                                   return m.first == selected && m.second == p;
-                                               });
-                        if(it != board.pieceTrajectories().end())
-                        {
-                            if(board.move(selected, it))
-                            {
-                                nextTurn();
-                            }
-                        }
+                        nextTurn();
                     }
-                }();
+                }
                 selected = board.end(); //deselect
             }
         }
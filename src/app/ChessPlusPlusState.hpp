@@ -3,6 +3,7 @@
 
 #include "gfx/Graphics.hpp"
 #include "board/Board.hpp"
+#include "engine/Player.hpp"
 
 #include "AppState.hpp"
 #include "Application.hpp"
@@ -26,14 +27,28 @@ namespace chesspp
             using Players_t = std::set<board::Board::Suit>;
             Players_t players;
             Players_t::const_iterator turn;
+            engine::Player engine;
+            JobQueue::Job thinking; //the engine's search, empty when not searching
+            engine::MoveGenerator generate;
+            engine::Moves_t moves; //legal moves of the turn, reused
+            engine::Draw drawn = engine::Draw::None; //no more moves are made once the game is drawn
+            sf::Font &font;
+            sf::Text profile_text; //drawn over the board while profiling
+            bool profiling = false;
             void nextTurn();
             board::Board::Pieces_t::iterator find(board::Board::Position_t const &pos) const;
 
         public:
             ChessPlusPlusState(Application &app, sf::RenderWindow &display);
+            virtual ~ChessPlusPlusState();
 
             virtual void onRender() override;
 
+            virtual void onClosed() override;
+
+            //F3 shows what the last frame spent its time on, F4 starts and stops a trace
+            virtual void onKeyPressed(sf::Keyboard::Key key, bool alt, bool control, bool shift, bool system) override;
+
             virtual void onMouseMoved(int x, int y) override;
             virtual void onLButtonPressed(int x, int y) override;
             virtual void onLButtonReleased(int x, int y) override;
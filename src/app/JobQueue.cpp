@@ -0,0 +1,126 @@
+#include "JobQueue.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <exception>
+#include <typeinfo>
+
+namespace chesspp
+{
+    namespace app
+    {
+        JobQueue::JobQueue()
+        : worker{[this]{ run(); }}
+        {
+        }
+        JobQueue::~JobQueue()
+        {
+            std::shared_ptr<Task> running;
+            {
+                std::lock_guard<std::mutex> lock {m};
+                quitting = true;
+                for(auto &t : queued)
+                {
+                    t->cancelled = true;
+                }
+                queued.clear();
+                completed.clear();
+                running = current;
+            }
+            if(running)
+            {
+                running->cancelled = true;
+                if(running->interrupt) running->interrupt();
+            }
+            wake.notify_all();
+            worker.join();
+        }
+
+        void JobQueue::run()
+        {
+            std::unique_lock<std::mutex> lock {m};
+            for(;;)
+            {
+                wake.wait(lock, [this]{ return quitting || !queued.empty(); });
+                if(quitting) return;
+                current = queued.front();
+                queued.pop_front();
+                auto task = current;
+                lock.unlock();
+
+                Completion_t completion;
+                if(!task->cancelled)
+                {
+                    try
+                    {
+                        completion = task->work();
+                    }
+                    catch(std::exception &e)
+                    {
+                        std::cerr << typeid(e).name() << " caught in job: " << e.what() << std::endl;
+                    }
+                }
+
+                lock.lock();
+                current.reset();
+                if(!task->cancelled && completion)
+                {
+                    task->completion = std::move(completion);
+                    completed.push_back(task);
+                }
+                idle.notify_all();
+            }
+        }
+
+        JobQueue::Job JobQueue::submit(Work_t work, Interrupt_t interrupt)
+        {
+            Job job;
+            job.task = std::make_shared<Task>();
+            job.task->work = std::move(work);
+            job.task->interrupt = std::move(interrupt);
+            {
+                std::lock_guard<std::mutex> lock {m};
+                queued.push_back(job.task);
+            }
+            wake.notify_one();
+            return job;
+        }
+
+        void JobQueue::cancel(Job &job)
+        {
+            if(!job.task) return;
+            auto task = std::move(job.task);
+            task->cancelled = true;
+
+            std::unique_lock<std::mutex> lock {m};
+            queued.erase(std::remove(queued.begin(), queued.end(), task), queued.end());
+            completed.erase(std::remove(completed.begin(), completed.end(), task), completed.end());
+            if(current == task)
+            {
+                lock.unlock();
+                if(task->interrupt) task->interrupt();
+                lock.lock();
+                idle.wait(lock, [&]{ return current != task; });
+            }
+        }
+
+        void JobQueue::drain()
+        {
+            std::deque<std::shared_ptr<Task>> done;
+            {
+                std::lock_guard<std::mutex> lock {m};
+                done.swap(completed);
+            }
+            for(auto &t : done)
+            {
+                if(!t->cancelled) t->completion(); //may cancel later ones
+            }
+        }
+
+        bool JobQueue::busy()
+        {
+            std::lock_guard<std::mutex> lock {m};
+            return !queued.empty() || current || !completed.empty();
+        }
+    }
+}
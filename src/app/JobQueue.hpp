@@ -0,0 +1,83 @@
+#ifndef ChessPlusPlus_App_JobQueueClass_HeaderPlusPlus
+#define ChessPlusPlus_App_JobQueueClass_HeaderPlusPlus
+
+#include <functional>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+namespace chesspp
+{
+    namespace app
+    {
+        /**
+         * Runs jobs one at a time on a worker thread so that an
+         * AppState can do heavy work without freezing the window.
+         * The work returns a completion, which drain() runs on the
+         * thread that owns the queue, once per frame from
+         * Application::execute(). A cancelled job's completion is
+         * never run.
+         */
+        class JobQueue
+        {
+        public:
+            using Completion_t = std::function<void ()>;
+            using Work_t = std::function<Completion_t ()>;
+            using Interrupt_t = std::function<void ()>; //called from the owning thread to end running work early
+
+        private:
+            class Task
+            {
+            public:
+                Work_t work;
+                Interrupt_t interrupt;
+                Completion_t completion;
+                std::atomic<bool> cancelled {false};
+            };
+
+        public:
+            //Refers to a submitted job, may be empty
+            class Job
+            {
+                friend class ::chesspp::app::JobQueue;
+                std::shared_ptr<Task> task;
+
+            public:
+                bool empty() const noexcept
+                {
+                    return !task;
+                }
+            };
+
+        private:
+            std::mutex m;
+            std::condition_variable wake, idle;
+            std::deque<std::shared_ptr<Task>> queued, completed;
+            std::shared_ptr<Task> current;
+            bool quitting = false;
+            std::thread worker; //last, it uses the members above
+
+            void run();
+
+        public:
+            JobQueue();
+            JobQueue(JobQueue const &) = delete;
+            JobQueue &operator=(JobQueue const &) = delete;
+            //Cancels every job and waits for the running one
+            ~JobQueue();
+
+            Job submit(Work_t work, Interrupt_t interrupt = nullptr);
+            //Interrupts the job if it is running and waits for it, the job is left empty
+            void cancel(Job &job);
+            //Runs the completions of finished jobs
+            void drain();
+            //Whether any job is queued, running or waiting for drain()
+            bool busy();
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,63 @@
+#include "LoadingState.hpp"
+
+#include "ChessPlusPlusState.hpp"
+#include "res/SfmlFileResource.hpp"
+
+#include <iostream>
+#include <string>
+
+namespace chesspp
+{
+    namespace app
+    {
+        using Font_res = res::SfmlFileResource<sf::Font>;
+        using Texture_res = res::SfmlFileResource<sf::Texture>;
+        LoadingState::LoadingState(Application &app_, sf::RenderWindow &display_)
+        : AppState(display_) //can't use {}
+        , app(app_)          //can't use {}
+        , menu_background{app.resourcesConfig().resources().from_config<Texture_res>("menu", "background")}
+        , font           (app.resourcesConfig().resources().from_config<Font_res>   ("menu", "font")      ) //can't use {}
+        , progress_text{"Loading", font, 40}
+        , bar_frame{sf::Vector2f(display.getSize().x*0.6f, 24.f)}
+        , bar      {sf::Vector2f(0.f, 24.f)}
+        {
+            progress_text.setColor(sf::Color::Black);
+            progress_text.setStyle(sf::Text::Bold);
+
+            //centered horizontally, in the middle vertically
+            bar_frame.setPosition(display.getSize().x*0.2f, display.getSize().y*0.5f);
+            bar_frame.setFillColor(sf::Color::Transparent);
+            bar_frame.setOutlineColor(sf::Color::Black);
+            bar_frame.setOutlineThickness(2.f);
+            bar.setPosition(bar_frame.getPosition());
+            bar.setFillColor(sf::Color::Black);
+
+            frame_rate = 30;
+            auto rate = app.resourcesConfig().setting("menu", "frame rate");
+            if(rate.type() == json_integer && std::int64_t(rate) > 0)
+            {
+                frame_rate = unsigned(std::int64_t(rate));
+            }
+        }
+
+        void LoadingState::onRender()
+        {
+            auto const *loader = app.preloaded();
+            if(!loader || loader->done())
+            {
+                std::clog << "State changing to ChessPlusPlus" << std::endl;
+                return app.changeState<ChessPlusPlusState>(std::ref(app), std::ref(display));
+            }
+
+            progress_text.setString("Loading " + std::to_string(loader->progress()) + " of " + std::to_string(loader->total()));
+            progress_text.setPosition(((display.getSize().x/2) - (progress_text.getLocalBounds().width/2)), (display.getSize().y*0.35));
+            bar.setSize(sf::Vector2f(bar_frame.getSize().x*loader->progress()/loader->total(), bar_frame.getSize().y));
+
+            display.clear();
+            display.draw(menu_background);
+            display.draw(progress_text);
+            display.draw(bar_frame);
+            display.draw(bar);
+        }
+    }
+}
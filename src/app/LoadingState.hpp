@@ -0,0 +1,35 @@
+#ifndef ChessPlusPlus_App_LoadingState_HeaderPlusPlus
+#define ChessPlusPlus_App_LoadingState_HeaderPlusPlus
+
+#include "SFML.hpp"
+
+#include "AppState.hpp"
+#include "Application.hpp"
+
+namespace chesspp
+{
+    namespace app
+    {
+        /**
+         * Shows how many of the preloaded images have been decoded,
+         * then changes to ChessPlusPlusState once they all are.
+         */
+        class LoadingState : public AppState
+        {
+            Application &app;
+
+            sf::Sprite menu_background;
+            sf::Font &font;
+            sf::Text progress_text;
+            sf::RectangleShape bar_frame;
+            sf::RectangleShape bar;
+
+        public:
+            LoadingState(Application &app, sf::RenderWindow &display);
+
+            virtual void onRender() override;
+        };
+    }
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "StartMenuState.hpp"
 
 #include "ChessPlusPlusState.hpp"
+#include "LoadingState.hpp"
 #include "res/SfmlFileResource.hpp"
 
 #include <iostream>
@@ -31,6 +32,15 @@ namespace chesspp
             quit_text.setPosition (((display.getSize().x/2) - (quit_text.getLocalBounds() .width/2)), (display.getSize().y*0.47));
             quit_text.setColor(sf::Color::Black);
             quit_text.setStyle(sf::Text::Bold);
+
+            auto rate = app.resourcesConfig().setting("menu", "frame rate");
+            if(rate.type() == json_integer && std::int64_t(rate) > 0)
+            {
+                frame_rate = unsigned(std::int64_t(rate));
+            }
+
+            //decode the board's images while the menu is shown
+            app.preload(gfx::GraphicsHandler::manifest(app.resourcesConfig()));
         }
 
         void StartMenuState::onRender()
@@ -47,6 +57,11 @@ namespace chesspp
             //If clicked on Start button
             if(start_text.getGlobalBounds().contains(x,y))
             {
+                if(app.preloaded() && !app.preloaded()->done())
+                {
+                    std::clog << "State changing to Loading" << std::endl;
+                    return app.changeState<LoadingState>(std::ref(app), std::ref(display));
+                }
                 std::clog << "State changing to ChessPlusPlus" << std::endl;
                 return app.changeState<ChessPlusPlusState>(std::ref(app), std::ref(display));
             }
@@ -0,0 +1,244 @@
+#include "Bitboards.hpp"
+
+#include <vector>
+#include <initializer_list>
+
+#if !defined(CHESSPP_USE_PEXT)
+    #if defined(__BMI2__)
+        #define CHESSPP_USE_PEXT 1
+    #else
+        #define CHESSPP_USE_PEXT 0
+    #endif
+#endif
+#if CHESSPP_USE_PEXT
+    #include <immintrin.h>
+#endif
+
+namespace chesspp
+{
+    namespace board
+    {
+        namespace
+        {
+            using Bitboard_t = Bitboards::Bitboard_t;
+            using Square_t = Bitboards::Square_t;
+            using Position_t = Bitboards::Position_t;
+            using Offset_t = util::MakeSigned<Position_t::value_type>::type;
+            using Dir = util::Direction;
+
+            static std::size_t const Tiles = Bitboards::Width*Bitboards::Height;
+
+            static unsigned popcount(Bitboard_t b) noexcept
+            {
+                unsigned n = 0;
+                for(; b; b &= b - 1) ++n;
+                return n;
+            }
+
+            //Walks each direction tile by tile, stopping at the first occupied tile
+            static Bitboard_t slowAttacks(Square_t s, Bitboard_t occupancy, std::initializer_list<Dir> dirs)
+            {
+                Bitboard_t attacks = 0;
+                Position_t const from = Bitboards::position(s);
+                for(Dir d : dirs)
+                {
+                    for(Position_t t = Position_t(from).move(d); t.x < Bitboards::Width && t.y < Bitboards::Height; t.move(d))
+                    {
+                        attacks |= Bitboards::bit(t);
+                        if(occupancy & Bitboards::bit(t)) break;
+                    }
+                }
+                return attacks;
+            }
+
+            //The tiles whose occupancy affects a slider, which are its
+            //rays without the last tile before the edge of the board
+            static Bitboard_t relevantMask(Square_t s, std::initializer_list<Dir> dirs)
+            {
+                Bitboard_t mask = 0;
+                Position_t const from = Bitboards::position(s);
+                for(Dir d : dirs)
+                {
+                    for(Position_t t = Position_t(from).move(d), n = Position_t(t).move(d); n.x < Bitboards::Width && n.y < Bitboards::Height; t = n, n.move(d))
+                    {
+                        mask |= Bitboards::bit(t);
+                    }
+                }
+                return mask;
+            }
+
+            class Magic
+            {
+            public:
+                Bitboard_t mask;
+                Bitboard_t magic;
+                unsigned shift;
+                std::size_t offset; //into the attack table
+
+                std::size_t index(Bitboard_t occupancy) const noexcept
+                {
+                #if CHESSPP_USE_PEXT
+                    return offset + _pext_u64(occupancy, mask);
+                #else
+                    return offset + std::size_t(((occupancy & mask) * magic) >> shift);
+                #endif
+                }
+            };
+
+            //Deterministic so that startup does not depend on luck
+            class XorShift
+            {
+                std::uint64_t state = 0x9E3779B97F4A7C15ull;
+            public:
+                std::uint64_t next() noexcept
+                {
+                    state ^= state >> 12;
+                    state ^= state << 25;
+                    state ^= state >> 27;
+                    return state * 0x2545F4914F6CDD1Dull;
+                }
+                std::uint64_t sparse() noexcept
+                {
+                    return next() & next() & next();
+                }
+            };
+
+            class Slider
+            {
+                Magic magics[Tiles];
+                std::vector<Bitboard_t> attacks;
+
+            public:
+                Slider(std::initializer_list<Dir> dirs)
+                {
+                    XorShift rng;
+                    std::vector<Bitboard_t> occupancies, references;
+                    std::vector<unsigned> epoch;
+                    unsigned tries = 0;
+                    for(Square_t s = 0; s < Tiles; ++s)
+                    {
+                        Magic &m = magics[s];
+                        m.mask = relevantMask(s, dirs);
+                        m.shift = 64 - popcount(m.mask);
+                        m.offset = attacks.size();
+                        std::size_t size = std::size_t(1) << popcount(m.mask);
+                        attacks.resize(attacks.size() + size);
+
+                        //enumerate every subset of the mask (carry-rippler)
+                        occupancies.clear();
+                        references.clear();
+                        Bitboard_t occupancy = 0;
+                        do
+                        {
+                            occupancies.push_back(occupancy);
+                            references.push_back(slowAttacks(s, occupancy, dirs));
+                            occupancy = (occupancy - m.mask) & m.mask;
+                        } while(occupancy);
+
+                    #if CHESSPP_USE_PEXT
+                        m.magic = 0;
+                        for(std::size_t i = 0; i < occupancies.size(); ++i)
+                        {
+                            attacks[m.index(occupancies[i])] = references[i];
+                        }
+                    #else
+                        epoch.assign(size, 0);
+                        for(bool found = false; !found; )
+                        {
+                            do
+                            {
+                                m.magic = rng.sparse();
+                            } while(popcount((m.mask * m.magic) >> 56) < 6);
+
+                            ++tries;
+                            found = true;
+                            for(std::size_t i = 0; i < occupancies.size(); ++i)
+                            {
+                                std::size_t idx = m.index(occupancies[i]);
+                                if(epoch[idx - m.offset] != tries)
+                                {
+                                    epoch[idx - m.offset] = tries;
+                                    attacks[idx] = references[i];
+                                }
+                                else if(attacks[idx] != references[i])
+                                {
+                                    found = false; //destructive collision
+                                    break;
+                                }
+                            }
+                        }
+                    #endif
+                    }
+                }
+
+                Bitboard_t operator()(Square_t s, Bitboard_t occupancy) const noexcept
+                {
+                    return attacks[magics[s].index(occupancy)];
+                }
+            };
+
+            class Tables
+            {
+            public:
+                Slider rook   {Dir::North, Dir::East, Dir::South, Dir::West};
+                Slider bishop {Dir::NorthEast, Dir::SouthEast, Dir::SouthWest, Dir::NorthWest};
+                Bitboard_t knight[Tiles];
+                Bitboard_t king[Tiles];
+                Bitboard_t step[9][Tiles]; //indexed by Direction, None is always empty
+
+                Tables()
+                {
+                    for(Square_t s = 0; s < Tiles; ++s)
+                    {
+                        Position_t const from = Bitboards::position(s);
+                        auto tile = [](Position_t const &t) -> Bitboard_t
+                        {
+                            return (t.x < Bitboards::Width && t.y < Bitboards::Height)? Bitboards::bit(t) : 0;
+                        };
+                        auto on = [&](Offset_t x, Offset_t y) -> Bitboard_t
+                        {
+                            return tile(Position_t(from).move(x, y));
+                        };
+
+                        knight[s] = on( 1, -2) | on( 2, -1) | on( 2,  1) | on( 1,  2)
+                                  | on(-1,  2) | on(-2,  1) | on(-2, -1) | on(-1, -2);
+                        king[s]   = on( 0, -1) | on( 1, -1) | on( 1,  0) | on( 1,  1)
+                                  | on( 0,  1) | on(-1,  1) | on(-1,  0) | on(-1, -1);
+
+                        step[static_cast<int>(Dir::None)][s] = 0;
+                        for(Dir d : {Dir::North, Dir::NorthEast, Dir::East, Dir::SouthEast
+                                    ,Dir::South, Dir::SouthWest, Dir::West, Dir::NorthWest})
+                        {
+                            step[static_cast<int>(d)][s] = tile(Position_t(from).move(d));
+                        }
+                    }
+                }
+            };
+            static Tables const tables;
+        }
+
+        constexpr Bitboards::BoardSize_t Bitboards::Width;
+        constexpr Bitboards::BoardSize_t Bitboards::Height;
+
+        Bitboard_t Bitboards::rookAttacks(Square_t s, Bitboard_t occupancy) noexcept
+        {
+            return tables.rook(s, occupancy);
+        }
+        Bitboard_t Bitboards::bishopAttacks(Square_t s, Bitboard_t occupancy) noexcept
+        {
+            return tables.bishop(s, occupancy);
+        }
+        Bitboard_t Bitboards::knightAttacks(Square_t s) noexcept
+        {
+            return tables.knight[s];
+        }
+        Bitboard_t Bitboards::kingAttacks(Square_t s) noexcept
+        {
+            return tables.king[s];
+        }
+        Bitboard_t Bitboards::step(util::Direction d, Square_t s) noexcept
+        {
+            return tables.step[static_cast<int>(d)][s];
+        }
+    }
+}
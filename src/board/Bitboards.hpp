@@ -0,0 +1,122 @@
+#ifndef ChessPlusPlus_Board_StandardBoardBitboardsClass_HeaderPlusPlus
+#define ChessPlusPlus_Board_StandardBoardBitboardsClass_HeaderPlusPlus
+
+#include "config/BoardConfig.hpp"
+#include "util/Position.hpp"
+
+#include <map>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace chesspp
+{
+    namespace board
+    {
+        /**
+         * 64-bit occupancy sets for standard 8x8 boards, one
+         * bit per tile in row-major order, along with lookup
+         * tables for piece attacks. Sliding attacks use magic
+         * bitboards, or PEXT when compiled with BMI2 support.
+         */
+        class Bitboards
+        {
+        public:
+            using Bitboard_t = std::uint64_t;
+            using Square_t = unsigned;
+            using BoardSize_t = config::BoardConfig::BoardSize_t;
+            using Position_t = config::BoardConfig::Position_t;
+            using PieceClass_t = config::BoardConfig::PieceClass_t;
+            using SuitClass_t = config::BoardConfig::SuitClass_t;
+
+            static constexpr BoardSize_t Width = 8;
+            static constexpr BoardSize_t Height = 8;
+
+            static Square_t square(Position_t const &p) noexcept
+            {
+                return Square_t(p.y)*Width + p.x;
+            }
+            static Position_t position(Square_t s) noexcept
+            {
+                return Position_t(BoardSize_t(s%Width), BoardSize_t(s/Width));
+            }
+            static Bitboard_t bit(Position_t const &p) noexcept
+            {
+                return Bitboard_t(1) << square(p);
+            }
+            static Square_t lowest(Bitboard_t b) noexcept
+            {
+            #if defined(_MSC_VER)
+                unsigned long i;
+                _BitScanForward64(&i, b);
+                return static_cast<Square_t>(i);
+            #else
+                return static_cast<Square_t>(__builtin_ctzll(b));
+            #endif
+            }
+
+            /**
+             * Calls f with the position of every tile in b.
+             * \param b the tiles to visit.
+             * \param f callable taking Position_t const &.
+             */
+            template<typename F>
+            static void forEach(Bitboard_t b, F f)
+            {
+                for(; b; b &= b - 1)
+                {
+                    f(position(lowest(b)));
+                }
+            }
+
+            static Bitboard_t rookAttacks  (Square_t s, Bitboard_t occupancy) noexcept;
+            static Bitboard_t bishopAttacks(Square_t s, Bitboard_t occupancy) noexcept;
+            static Bitboard_t queenAttacks (Square_t s, Bitboard_t occupancy) noexcept
+            {
+                return rookAttacks(s, occupancy) | bishopAttacks(s, occupancy);
+            }
+            static Bitboard_t knightAttacks(Square_t s) noexcept;
+            static Bitboard_t kingAttacks  (Square_t s) noexcept;
+            //The tile one step in the given direction, or no tiles if that is off the board
+            static Bitboard_t step(util::Direction d, Square_t s) noexcept;
+
+        private:
+            Bitboard_t all = 0;
+            std::map<SuitClass_t, Bitboard_t> suits;
+            std::map<PieceClass_t, Bitboard_t> classes;
+
+        public:
+            Bitboard_t occupied() const noexcept
+            {
+                return all;
+            }
+            Bitboard_t suit(SuitClass_t const &s) const
+            {
+                auto it = suits.find(s);
+                return it != suits.end()? it->second : 0;
+            }
+            Bitboard_t pieceClass(PieceClass_t const &c) const
+            {
+                auto it = classes.find(c);
+                return it != classes.end()? it->second : 0;
+            }
+
+            void add(Position_t const &p, PieceClass_t const &c, SuitClass_t const &s)
+            {
+                all        |= bit(p);
+                suits[s]   |= bit(p);
+                classes[c] |= bit(p);
+            }
+            void remove(Position_t const &p, PieceClass_t const &c, SuitClass_t const &s)
+            {
+                all        &= ~bit(p);
+                suits[s]   &= ~bit(p);
+                classes[c] &= ~bit(p);
+            }
+        };
+    }
+}
+
+#endif
@@ -1,88 +1,435 @@
 #include "Board.hpp"
+#include "Debug.hpp"
+#include "util/Allocations.hpp"
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
 
 namespace chesspp
 {
     namespace board
     {
+        namespace
+        {
+            //Appends the tiles that out doesn't hold yet to its first n, returns how many it holds
+            static std::size_t distinct(std::initializer_list<Board::Position_t> tiles, Board::Position_t *out, std::size_t n = 0) noexcept
+            {
+                for(auto const &t : tiles)
+                {
+                    if(std::find(out, out + n, t) == out + n) out[n++] = t;
+                }
+                return n;
+            }
+        }
+
+        constexpr Board::PieceIndex_t Board::NoPiece;
+        constexpr std::uint8_t Board::Piece::Orthogonal;
+        constexpr std::uint8_t Board::Piece::Diagonal;
+
         Board::Piece::Piece(Board &b, Position_t const &pos_, Suit const &s_)
         : board(b) //can't use {}
         , p{pos_}
         , s{s_}
         {
-            std::clog << "Creation of " << *this << std::endl;
+            CHESSPP_HOT_LOG("Creation of " << *this);
         }
 
-        void Board::update(Position_t const &pos)
+        void Board::update(Pieces_t::iterator moved, Position_t const &from, Position_t const &to, std::initializer_list<Position_t> vacated)
+        {
+            CHESSPP_PROFILE_SCOPE("Board::update");
+            CHESSPP_PROFILE_ALLOCATIONS("Board::update");
+            if(!incremental)
+            {
+                for(auto &p : pieces)
+                {
+                    p->tick(to);
+                }
+                return rebuild();
+            }
+
+            //Only pieces that could move to or capture at a changed tile,
+            //or which asked to be ticked, need their trajectories recalculated
+            assert(vacated.size() <= 3);
+            Position_t changed[5];
+            std::size_t n = distinct(vacated, changed, distinct({from, to}, changed));
+            stale.assign(pieces.slots(), false);
+            for(auto it = pieces.begin(); it != pieces.end(); ++it)
+            {
+                bool ticked = (*it)->needsTick();
+                (*it)->tick(to);
+                if(it == moved || ticked || affected(it, changed, n))
+                {
+                    stale[(*it)->index] = true;
+                }
+            }
+            regenerate();
+        }
+        void Board::verify(Position_t const &from, Position_t const &to)
+        {
+#ifdef CHESSPP_VERIFY_UPDATES
+            using Flat_t = std::vector<std::pair<PieceIndex_t, Position_t>>;
+            auto flatten = [](Movements_t const &m) -> Flat_t
+            {
+                Flat_t f;
+                for(auto const &e : m.all())
+                {
+                    f.emplace_back(e.piece, e.tile);
+                }
+                std::sort(f.begin(), f.end());
+                return f;
+            };
+            Zobrist::Key_t h = 0;
+            for(auto it = pieces.begin(); it != pieces.end(); ++it)
+            {
+                auto const &p = **it;
+                h ^= Zobrist::piece(seeds[p.index], p.pos) ^ Zobrist::state(seeds[p.index], p.pos, p.saveState());
+            }
+            if(h != zobrist)
+            {
+                std::cerr << "incremental hash after move from " << from << " to " << to << " differs from full rehash" << std::endl;
+            }
+            Flat_t t = flatten(trajectories), c = flatten(capturings), b = flatten(capturables);
+            rebuild();
+            if(t != flatten(trajectories) || c != flatten(capturings) || b != flatten(capturables))
+            {
+                std::cerr << "incremental update after move from " << from << " to " << to << " differs from full rebuild" << std::endl;
+            }
+#else
+            (void)from;
+            (void)to;
+#endif
+        }
+        void Board::rebuild()
+        {
+            stale.assign(pieces.slots(), true);
+            regenerate();
+        }
+        void Board::regenerate()
+        {
+            //Pieces are visited in index order so that each one
+            //occupies a single contiguous range of every list
+            std::size_t const n = pieces.slots();
+            for(auto *m : {&trajectories, &capturings, &capturables})
+            {
+                m->start(n);
+            }
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                bool live = pieces.alive(i);
+                if(live && !stale[i])
+                {
+                    for(auto *m : {&trajectories, &capturings, &capturables})
+                    {
+                        m->keep(PieceIndex_t(i));
+                    }
+                    continue;
+                }
+                for(auto *m : {&trajectories, &capturings, &capturables})
+                {
+                    m->open(PieceIndex_t(i));
+                }
+                if(live)
+                {
+                    (*pieces.find(i))->makeTrajectory();
+                }
+                for(auto *m : {&trajectories, &capturings, &capturables})
+                {
+                    m->close();
+                }
+            }
+            for(auto *m : {&trajectories, &capturings, &capturables})
+            {
+                m->finish();
+            }
+            ++revisions;
+        }
+        void Board::rehash(PieceIndex_t piece)
+        {
+            zobrist ^= keys[piece];
+            keys[piece] = 0;
+            if(pieces.alive(piece))
+            {
+                auto const &p = **pieces.find(piece);
+                keys[piece] = Zobrist::piece(seeds[piece], p.pos) ^ Zobrist::state(seeds[piece], p.pos, p.saveState());
+            }
+            zobrist ^= keys[piece];
+        }
+        void Board::place(Pieces_t::iterator piece)
+        {
+            auto const &p = **piece;
+            tiles[tileIndex(p.pos)] = piece;
+            if(bits)
+            {
+                bits->add(p.pos, p.pclass, p.suit);
+            }
+            if(wide)
+            {
+                wide->add(p.pos, p.pclass, p.suit);
+            }
+        }
+        void Board::lift(Pieces_t::iterator piece)
         {
-            trajectories.clear();
-            capturings.clear();
-            capturables.clear();
-            for(auto &p : pieces)
+            auto const &p = **piece;
+            tiles[tileIndex(p.pos)] = pieces.end();
+            if(bits)
+            {
+                bits->remove(p.pos, p.pclass, p.suit);
+            }
+            if(wide)
             {
-                p->tick(pos);
-                p->makeTrajectory();
+                wide->remove(p.pos, p.pclass, p.suit);
             }
         }
+        bool Board::affected(Pieces_t::iterator piece, Position_t const *tiles, std::size_t count) const
+        {
+            for(auto const *m : {&trajectories, &capturings, &capturables})
+            {
+                for(auto const &e : m->of((*piece)->index))
+                {
+                    if(std::find(tiles, tiles + count, e.tile) != tiles + count)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
 
         bool Board::capture(Pieces_t::iterator source, Movements_t::const_iterator target, Movements_t::const_iterator capturable)
         {
-            if(source == pieces.end())
+            Position_t at; //where the captured piece stands, before makeMove() takes it
+            if(capturable && capturables.all().contains(capturable) && piece(capturable->piece) != pieces.end())
             {
-                std::cerr << "source iterator of piece to capture with is invalid" << std::endl;
-                return false;
+                at = (*piece(capturable->piece))->pos;
             }
-            if(source != target->first)
+            if(!makeMove(source, target, capturable))
             {
-                std::cerr << "target iterator does not match source iterator, source{" << **source << "}, target {" << **(target->first) << "}" << std::endl;
                 return false;
             }
-            if(capturable->second != target->second)
+            CHESSPP_HOT_LOG("Capture: Moved piece at " << history.back().from << " to " << history.back().to);
+            if(observer)
             {
-                std::cerr << "capturable may not be captured at target" << std::endl;
+                observer->played(*this, history.back().from, history.back().to, capturable? &at : nullptr);
             }
-
-            pieces.erase(capturable->first);
-            std::clog << "Capture: ";
-            return move(source, target); //re-use existing code
+            return true;
         }
         bool Board::move(Pieces_t::iterator source, Movements_t::const_iterator target)
+        {
+            if(!makeMove(source, target))
+            {
+                return false;
+            }
+            CHESSPP_HOT_LOG("Moved piece at " << history.back().from << " to " << history.back().to);
+            if(observer)
+            {
+                observer->played(*this, history.back().from, history.back().to, nullptr);
+            }
+            return true;
+        }
+
+        bool Board::makeMove(Pieces_t::iterator source, Movements_t::const_iterator target, Movements_t::const_iterator capturable)
         {
             if(source == pieces.end())
             {
                 std::cerr << "source iterator of piece to move is invalid" << std::endl;
                 return false;
             }
-            if(target == trajectories.end() && target == capturings.end())
+            if(capturable && !capturings.all().contains(target))
+            {
+                std::cerr << "target iterator of piece to capture with is invalid" << std::endl;
+                return false;
+            }
+            if(!trajectories.all().contains(target) && !capturings.all().contains(target))
             {
                 std::cerr << "target iterator of piece to move to is invalid" << std::endl;
                 return false;
             }
-            if(source != target->first)
+            if(capturable && !capturables.all().contains(capturable))
+            {
+                std::cerr << "capturable iterator of piece to capture is invalid" << std::endl;
+                return false;
+            }
+            if((*source)->index != target->piece)
             {
-                std::cerr << "target iterator does not match source iterator, source{" << **source << "}, target {" << **(target->first) << "}" << std::endl;
+                std::cerr << "target iterator does not match source iterator, source{" << **source << "}, target {" << **piece(target->piece) << "}" << std::endl;
                 return false;
             }
-            if(occupied(target->second))
+            if(capturable && capturable->tile != target->tile)
+            {
+                std::cerr << "capturable may not be captured at target" << std::endl;
+            }
+            auto captured = (capturable? piece(capturable->piece) : pieces.end());
+            if(occupied(target->tile) && pieceAt(target->tile) != captured)
             {
                 std::cerr << "target iterator to move to is occupied:" << std::endl;
-                for(auto &p : pieces)
+                std::cerr << "\t" << **pieceAt(target->tile) << std::endl;
+                return false;
+            }
+
+            //Save everything the move may change before changing anything
+            Undo u {(*source)->index, NoPiece, (*source)->pos, target->tile, saved.size(), NoPiece, target->tile, target->tile, reversible};
+            saved.emplace_back(u.moved, (*source)->saveState());
+            for(auto it = pieces.begin(); it != pieces.end(); ++it)
+            {
+                if(it != source && (*it)->needsTick())
                 {
-                    if(p->pos == target->second)
-                    {
-                        std::cerr << "\t" << *p << std::endl;
-                    }
+                    saved.emplace_back((*it)->index, (*it)->saveState());
                 }
+            }
+
+            Position_t vacated = u.to;
+            if(captured != pieces.end())
+            {
+                u.captured = (*captured)->index;
+                vacated = (*captured)->pos;
+                lift(captured);
+                pieces.erase(captured); //the move lists stay valid until the next update
+            }
+            history.push_back(u);
+
+            lift(source);
+            (*source)->move(u.to); //may carry another piece
+            place(source);
+            u = history.back();
+            update(source, u.from, u.to, {vacated, u.carried_from, u.carried_to});
+
+            //only the pieces whose states were saved can have changed
+            rehash(u.moved);
+            if(u.captured != NoPiece)
+            {
+                rehash(u.captured);
+            }
+            for(auto i = u.states; i < saved.size(); ++i)
+            {
+                rehash(saved[i].first);
+            }
+            static config::BoardConfig::PieceClass_t const Pawn {"Pawn"};
+            bool irreversible = u.captured != NoPiece || (*source)->kind == Piece::Kind::Pawn || (*source)->pclass == Pawn;
+            reversible = irreversible? 0 : reversible + 1;
+            reached.push_back(zobrist);
+            verify(u.from, u.to);
+            return true;
+        }
+        void Board::carry(PieceIndex_t index, Position_t const &to)
+        {
+            auto &u = history.back();
+            auto it = pieces.find(index);
+            u.carried = index;
+            u.carried_from = (*it)->pos;
+            u.carried_to = to;
+            saved.emplace_back(index, (*it)->saveState()); //rehashed and restored with the others
+
+            lift(it);
+            (*it)->move(to);
+            place(it);
+        }
+        bool Board::unmakeMove()
+        {
+            if(history.empty())
+            {
                 return false;
             }
+            Undo const u = history.back();
+            history.pop_back();
+            reached.pop_back();
+            reversible = u.reversible;
 
-            std::clog << "Moved piece at " << (*source)->pos << std::flush;
-            auto t = target->second;
-            (*source)->move(t);
-            update(t);
-            std::clog << " to " << t << std::endl;
+            auto moved = pieces.find(u.moved);
+            lift(moved);
+            (*moved)->p = u.from;
+            --(*moved)->movenum;
+            place(moved);
+            if(u.carried != NoPiece)
+            {
+                auto carried = pieces.find(u.carried);
+                lift(carried);
+                (*carried)->p = u.carried_from;
+                --(*carried)->movenum;
+                place(carried);
+            }
+            Position_t vacated = u.to;
+            if(u.captured != NoPiece)
+            {
+                pieces.restore(u.captured);
+                auto captured = pieces.find(u.captured);
+                vacated = (*captured)->pos;
+                place(captured);
+            }
+            //restore in reverse so the oldest state of a piece wins
+            for(auto i = saved.size(); i-- > u.states; )
+            {
+                (*pieces.find(saved[i].first))->restoreState(saved[i].second);
+            }
+            rehash(u.moved);
+            if(u.captured != NoPiece)
+            {
+                rehash(u.captured);
+            }
+            for(auto i = u.states; i < saved.size(); ++i)
+            {
+                rehash(saved[i].first);
+            }
+
+            if(!incremental)
+            {
+                saved.resize(u.states);
+                rebuild();
+                return true;
+            }
+
+            //Same rule as update(), plus every piece whose state was restored
+            stale.assign(pieces.slots(), false);
+            stale[u.moved] = true;
+            if(u.captured != NoPiece)
+            {
+                stale[u.captured] = true;
+            }
+            for(auto i = u.states; i < saved.size(); ++i)
+            {
+                stale[saved[i].first] = true;
+            }
+            saved.resize(u.states);
+            Position_t changed[5];
+            std::size_t n = distinct({u.from, u.to, vacated, u.carried_from, u.carried_to}, changed);
+            for(auto it = pieces.begin(); it != pieces.end(); ++it)
+            {
+                if(affected(it, changed, n))
+                {
+                    stale[(*it)->index] = true;
+                }
+            }
+            regenerate();
+            verify(u.to, u.from);
             return true;
         }
+
+        Board::Board(Board const &other)
+        : Board(other.config, other.setup, other.setup_moved)
+        {
+            //Pieces are constructed in the same order, so indices match
+            for(auto const &u : other.history)
+            {
+                auto to = [&](Movements moves) -> Movements_t::const_iterator
+                {
+                    auto it = std::find_if(moves.begin(), moves.end(), [&](Movement const &m)
+                    {
+                        return m.tile == u.to;
+                    });
+                    return it != moves.end()? it : nullptr;
+                };
+                auto source = pieces.find(u.moved);
+                if(u.captured != NoPiece)
+                {
+                    makeMove(source, to(capturings.of(u.moved)), to(capturables.of(u.captured)));
+                }
+                else
+                {
+                    auto target = to(trajectories.of(u.moved));
+                    makeMove(source, target? target : to(capturings.of(u.moved)));
+                }
+            }
+        }
     }
 }
@@ -2,17 +2,27 @@
 #define ChessPlusPlus_Board_GeneralizedChessBoardClass_HeaderPlusPlus
 
 #include "config/BoardConfig.hpp"
+#include "Bitboards.hpp"
+#include "WideBitboards.hpp"
+#include "MoveList.hpp"
+#include "PieceArena.hpp"
+#include "Zobrist.hpp"
 #include "util/Position.hpp"
 #include "util/Utilities.hpp"
+#include "util/Profiler.hpp"
 
 #include <map>
 #include <set>
+#include <vector>
+#include <string>
 #include <memory>
+#include <mutex>
 #include <cstdint>
 #include <functional>
 #include <typeindex>
 #include <typeinfo>
 #include <algorithm>
+#include <initializer_list>
 
 namespace chesspp
 {
@@ -27,21 +37,58 @@ namespace chesspp
             //Current most-practical solution - will abstract more later
             using Suit = config::BoardConfig::SuitClass_t;
 
+            using PieceIndex_t = MoveList::PieceIndex_t;
+            using Movement = MoveList::Movement;
+
             class Piece
             {
             public:
                 using Position_t = Board::Position_t;
+                using State_t = std::uint32_t;
+                //The built-in classes, generated through a switch rather than calcTrajectory()
+                enum class Kind : std::uint8_t
+                {
+                    Custom, //any other class, generated by calcTrajectory()
+                    Pawn,
+                    Knight,
+                    Bishop,
+                    Rook,
+                    Queen,
+                    King,
+                    Archer,
+                    Described //a class of a piece plugin, see piece/Described.hpp
+                };
+                //Bits of rays(), by util::Direction d at bit d - 1
+                static constexpr std::uint8_t Orthogonal = 0x55, Diagonal = 0xAA;
 
                 Board &board; //The board this piece belongs to
             private:
                 Position_t p;
                 Suit s;
+                config::BoardConfig::PieceClass_t c; //set by the board after construction
+                PieceIndex_t i = 0;                  //set by the board after construction
+                Kind k = Kind::Custom;
+                std::uint8_t r = 0;
+                void *typed = nullptr;                      //this as the class given to specialize()
+                std::type_info const *typed_class = nullptr; //checked by the board after construction
                 std::size_t movenum = 0;
+
+                static void generate(Piece &p); //dispatches on kind, in piece/Generators.cpp
             public:
                 //const aliases
                 Position_t const &pos = p;          //The position on the board this piece is
                 Suit const &suit = s;               //Which suit the chess piece is
+                config::BoardConfig::PieceClass_t const &pclass = c; //The class this piece was registered as
+                PieceIndex_t const &index = i;      //Stable index of this piece on its board
                 std::size_t const &moves = movenum; //Current move number/number of moves made
+                Kind const &kind = k;               //Custom unless the class is exactly a built-in one
+
+                //The directions the piece captures along like a Bishop, Rook or Queen, if it captures
+                //only that way, by util::Direction d at bit d - 1, 0 for Custom pieces
+                std::uint8_t rays() const noexcept
+                {
+                    return r;
+                }
 
                 Piece(Board &b, Position_t const &pos, Suit const &s);
                 virtual ~Piece() = default;
@@ -51,44 +98,64 @@ namespace chesspp
                 //non-virtual, calls calcTrajectory(), which should call addTrajectory() for each possible tile
                 void makeTrajectory()
                 {
+                    CHESSPP_PROFILE_SCOPE("Piece::makeTrajectory");
                     addCapturable(pos);
-                    calcTrajectory();
-                }
-
-                friend bool operator==(std::unique_ptr<Piece> const &up, Piece const *p) noexcept(noexcept(up.get() == p))
-                {
-                    return up.get() == p;
+                    if(k == Kind::Custom)
+                    {
+                        calcTrajectory();
+                    }
+                    else
+                    {
+                        generate(*this);
+                    }
                 }
 
-                auto self() const -> std::set<std::unique_ptr<Piece>>::iterator
+                auto self() const -> PieceArena<Piece>::iterator
                 {
-                    return std::find(std::begin(board.pieces), std::end(board.pieces), this);
+                    return board.pieces.find(i);
                 }
 
             protected:
                 //should call addTrajectory() for each calculated trajectory
                 //and addCapture() for each possible capture
                 virtual void calcTrajectory() = 0;
+                //Called by the constructors of the built-in classes, the board ignores it
+                //if the piece turns out to be of a class deriving from Derived
+                template<typename Derived>
+                void specialize(Kind kind, Derived *self, std::uint8_t rays = 0) noexcept
+                {
+                    k = kind;
+                    r = rays;
+                    typed = self;
+                    typed_class = &typeid(Derived);
+                }
                 //deriving classes should call this from makeTrajectory to add a calculated trajectory tile
                 void addTrajectory(Position_t const &tile)
                 {
                     if(board.valid(tile))
                     {
-                        board.trajectories.insert(Board::Movements_t::value_type(self(), tile));
+                        board.trajectories.add(i, tile);
                     }
                 }
+                //deriving classes can call this instead to add every tile of a bitboard at once
+                void addTrajectories(Bitboards::Bitboard_t tiles)
+                {
+                    Bitboards::forEach(tiles, [&](Position_t const &tile)
+                    {
+                        board.trajectories.add(i, tile);
+                    });
+                }
+                void addTrajectories(WideBitboards::Bitboard_t const &tiles)
+                {
+                    WideBitboards::forEach(tiles, [&](Position_t const &tile)
+                    {
+                        board.trajectories.add(i, tile);
+                    });
+                }
                 //further deriving classes can call this to remove a trajectory calculated by their parent class
                 void removeTrajectory(Position_t const &tile)
                 {
-                    auto range = board.trajectories.equal_range(self());
-                    for(auto it = range.first; it != range.second; )
-                    {
-                        if(it->second == tile)
-                        {
-                            it = board.trajectories.erase(it);
-                        }
-                        else ++it;
-                    }
+                    board.trajectories.remove(i, tile);
                 }
 
                 //deriving classes should call this from makeTrajectory to add a calculated capturable tile
@@ -96,21 +163,28 @@ namespace chesspp
                 {
                     if(board.valid(tile))
                     {
-                        board.capturings.insert(Board::Movements_t::value_type(self(), tile));
+                        board.capturings.add(i, tile);
                     }
                 }
+                //deriving classes can call this instead to add every tile of a bitboard at once
+                void addCapturings(Bitboards::Bitboard_t tiles)
+                {
+                    Bitboards::forEach(tiles, [&](Position_t const &tile)
+                    {
+                        board.capturings.add(i, tile);
+                    });
+                }
+                void addCapturings(WideBitboards::Bitboard_t const &tiles)
+                {
+                    WideBitboards::forEach(tiles, [&](Position_t const &tile)
+                    {
+                        board.capturings.add(i, tile);
+                    });
+                }
                 //further deriving classes can call this to remove a capturable tile calculated by their parent class
                 void removeCapturing(Position_t const &tile)
                 {
-                    auto range = board.capturings.equal_range(self());
-                    for(auto it = range.first; it != range.second; )
-                    {
-                        if(it->second == tile)
-                        {
-                            it = board.capturings.erase(it);
-                        }
-                        else ++it;
-                    }
+                    board.capturings.remove(i, tile);
                 }
 
                 //deriving classes should call this from makeTrajectory to add a calculated capturable tile
@@ -118,21 +192,13 @@ namespace chesspp
                 {
                     if(board.valid(tile))
                     {
-                        board.capturables.insert(Board::Movements_t::value_type(self(), tile));
+                        board.capturables.add(i, tile);
                     }
                 }
                 //further deriving classes can call this to remove a capturable tile calculated by their parent class
                 void removeCapturable(Position_t const &tile)
                 {
-                    auto range = board.capturables.equal_range(self());
-                    for(auto it = range.first; it != range.second; )
-                    {
-                        if(it->second == tile)
-                        {
-                            it = board.capturables.erase(it);
-                        }
-                        else ++it;
-                    }
+                    board.capturables.remove(i, tile);
                 }
 
             private:
@@ -140,6 +206,12 @@ namespace chesspp
                 virtual void tick(Position_t const &m)
                 {
                 }
+                //Whether the next tick() may change the trajectory even if the
+                //move did not touch any tile this piece moves to or captures at
+                virtual bool needsTick() const
+                {
+                    return false;
+                }
 
                 //Sets the piece position as instructed by the board and recalculates the trajectory
                 void move(Position_t const &to)
@@ -155,6 +227,16 @@ namespace chesspp
                 {
                 }
 
+                //Whatever tick() and moveUpdate() may change, so that the board
+                //can put it back when a move is undone
+                virtual State_t saveState() const
+                {
+                    return 0;
+                }
+                virtual void restoreState(State_t)
+                {
+                }
+
             public:
                 friend class ::chesspp::board::Board;
                 friend std::ostream &operator<<(std::ostream &os, Piece const &p)
@@ -163,18 +245,9 @@ namespace chesspp
                 }
             };
 
-            using Pieces_t = std::set<std::unique_ptr<Piece>>;
-        private:
-            struct Pieces_t_iterator_compare
-            {
-                bool operator()(Pieces_t::iterator const &a, Pieces_t::iterator const &b) const
-                {
-                    return *a < *b;
-                }
-            };
-        public:
-            using Movements_t = std::multimap<Pieces_t::iterator, Position_t, Pieces_t_iterator_compare>;
-            using Factory_t = std::map<config::BoardConfig::PieceClass_t, std::function<Pieces_t::value_type (Board &, Position_t const &, Suit const &)>>; //Used to create new pieces
+            using Pieces_t = PieceArena<Piece>;
+            using Movements_t = MoveList;
+            using Factory_t = std::map<config::BoardConfig::PieceClass_t, std::function<Pieces_t::iterator (Pieces_t &, Board &, Position_t const &, Suit const &)>>; //Used to construct new pieces into the board's arena
 
             //represents an interaction between pieces that allows for complex moves, e.g. castling
             class Interaction
@@ -188,39 +261,144 @@ namespace chesspp
                 }
                 virtual ~Interaction() = 0;
 
-                //
+            protected:
+                //Only from a moveUpdate() during a move of the board, also moves
+                //another piece as part of that move and undoes it with the move
+                void carry(PieceIndex_t piece, Position_t const &to)
+                {
+                    board.carry(piece, to);
+                }
             };
             using Interactions_t = std::map<std::type_index, std::unique_ptr<Interaction>>;
 
+            //Told of each move() and capture() after it was made, e.g. to record the game
+            class Observer
+            {
+            public:
+                virtual ~Observer() = default;
+                //captured is where the captured piece stood, or nullptr if nothing was
+                virtual void played(Board const &b, Position_t const &from, Position_t const &to, Position_t const *captured) = 0;
+            };
+
             config::BoardConfig const &config;
         private:
             Pieces_t pieces;
             Movements_t trajectories; //where pieces can go
             Movements_t capturings;   //where pieces can capture
             Movements_t capturables;  //where pieces can be captured
+            std::vector<bool> stale;  //by piece index, reused by each update
+            std::uint64_t revisions = 0; //counts the times the move lists were regenerated
+
+        public:
+            static constexpr PieceIndex_t NoPiece = PieceIndex_t(-1);
+        private:
+            class Undo
+            {
+            public:
+                PieceIndex_t moved;
+                PieceIndex_t captured; //NoPiece if nothing was captured
+                Position_t from, to;
+                std::size_t states;    //size of saved before the move
+                PieceIndex_t carried;  //NoPiece unless another piece moved with it
+                Position_t carried_from, carried_to; //to if nothing was carried
+                std::size_t reversible; //reversiblePlies() before the move
+            };
+            std::vector<Undo> history;
+            std::vector<Zobrist::Key_t> reached; //hash() of the initial position and after each move
+            std::size_t reversible = 0;          //moves since the last capture or Pawn move
+            std::vector<std::pair<PieceIndex_t, Piece::State_t>> saved; //piece states to restore on undo
+            Zobrist::Key_t zobrist = 0;
+            std::vector<Zobrist::Key_t> seeds, keys; //by piece index, keys are what each piece adds to zobrist
+            //The classes in piece/, which are registered here rather than by static
+            //initializers, as those would be dropped when linking from a static library
+            static Factory_t builtinPieceClasses();
+            //Registers the classes of the piece plugins not loaded yet, in piece/Plugins.cpp
+            static void loadPlugins(std::vector<std::string> const &paths);
             static Factory_t &factory()
             {
-                static Factory_t f;
+                static Factory_t f = builtinPieceClasses();
                 return f;
             }
             Interactions_t interactions;
+            Observer *observer = nullptr;
+            bool incremental = true; //only recalculate pieces affected by a move
+            std::vector<Pieces_t::iterator> tiles; //row-major, pieces.end() where empty
+            std::unique_ptr<Bitboards> bits;       //only for standard 8x8 boards
+            std::unique_ptr<WideBitboards> wide;   //only for boards up to 32x32
+            config::BoardConfig::Layout_t setup;  //the pieces the board started with
+            std::set<Position_t> setup_moved;     //tiles of the setup whose pieces had moved
+
+            std::size_t tileIndex(Position_t const &pos) const noexcept
+            {
+                return std::size_t(pos.y)*config.boardWidth() + pos.x;
+            }
 
         public:
             Board(config::BoardConfig const &conf)
+            : Board(conf, conf.initialLayout())
+            {
+            }
+            //Sets up other pieces than the initial layout. The pieces on the moved tiles
+            //count as having moved twice, so they can't castle, move a Pawn two tiles
+            //or be taken en passant.
+            Board(config::BoardConfig const &conf, config::BoardConfig::Layout_t const &layout, std::set<Position_t> const &moved = {})
             : config(conf) //can't use {}
+            , tiles(std::size_t(conf.boardWidth())*conf.boardHeight(), pieces.end()) //don't use {}
+            , setup(layout) //don't use {}
+            , setup_moved(moved) //don't use {}
             {
-                for(auto const &slot : conf.initialLayout())
+                if(conf.boardWidth() == Bitboards::Width && conf.boardHeight() == Bitboards::Height)
                 {
-                    pieces.emplace(factory().at(slot.second.first)(*this, slot.first, slot.second.second));
+                    bits.reset(new Bitboards);
                 }
-
-                for(auto const &p : pieces)
+                if(conf.boardWidth() <= WideBitboards::MaxWidth && conf.boardHeight() <= WideBitboards::MaxHeight)
+                {
+                    wide.reset(new WideBitboards{conf.boardWidth(), conf.boardHeight()});
+                }
+                loadPieceClasses(conf);
+                for(auto const &slot : layout)
+                {
+                    auto it = factory().at(slot.second.first)(pieces, *this, slot.first, slot.second.second);
+                    (*it)->c = slot.second.first;
+                    (*it)->i = PieceIndex_t(it.index());
+                    if((*it)->k != Piece::Kind::Custom && typeid(**it) != *(*it)->typed_class)
+                    {
+                        (*it)->k = Piece::Kind::Custom; //a class deriving from a built-in one
+                        (*it)->r = 0;
+                    }
+                    if(moved.find(slot.first) != moved.end())
+                    {
+                        (*it)->movenum = 2;
+                    }
+                    seeds.push_back(Zobrist::seed(slot.second.first, slot.second.second));
+                    keys.push_back(0);
+                    place(it);
+                }
+                for(auto it = pieces.begin(); it != pieces.end(); ++it)
                 {
-                    p->makeTrajectory();
+                    rehash((*it)->index);
                 }
+                reached.push_back(zobrist);
+
+                rebuild();
             }
+            //Copies the position by replaying the moves of the other board
+            Board(Board const &other);
+            Board &operator=(Board const &) = delete;
             ~Board() = default;
 
+            //Registers the classes of the piece plugins of the configuration, the first time it is
+            //called for it. Boards call it when constructed, but as registering classes must not
+            //race with constructing boards, programs that construct boards on several threads
+            //call it before starting them.
+            static void loadPieceClasses(config::BoardConfig const &conf)
+            {
+                if(!conf.piecePlugins().empty())
+                {
+                    std::call_once(conf.piecePluginsLoaded(), loadPlugins, std::cref(conf.piecePlugins()));
+                }
+            }
+            //Not while boards are being constructed on other threads
             static Factory_t::iterator registerPieceClass(Factory_t::key_type const &type, Factory_t::mapped_type ctor)
             {
                 return factory().insert({type, ctor}).first;
@@ -238,16 +416,38 @@ namespace chesspp
                 return dynamic_cast<InteractionT &>(*interactions[t]);
             }
 
-            bool occupied(Position_t const &pos) const
+            bool occupied(Position_t const &pos) const noexcept
+            {
+                return valid(pos) && tiles[tileIndex(pos)] != pieces.end();
+            }
+            //Bitboards are only maintained for standard 8x8 boards,
+            //other boards must use occupied() and pieceAt()
+            bool hasBitboards() const noexcept
+            {
+                return bool(bits);
+            }
+            Bitboards const &bitboards() const noexcept
+            {
+                return *bits;
+            }
+            //Wide bitboards are maintained for boards up to 32x32, including 8x8
+            bool hasWideBitboards() const noexcept
+            {
+                return bool(wide);
+            }
+            WideBitboards const &wideBitboards() const noexcept
+            {
+                return *wide;
+            }
+
+            //Returns the piece at the given position, or end() if there is none
+            Pieces_t::iterator pieceAt(Position_t const &pos) const noexcept
             {
-                for(auto const &p : *this)
+                if(!valid(pos))
                 {
-                    if(p->pos == pos)
-                    {
-                        return true;
-                    }
+                    return pieces.end();
                 }
-                return false;
+                return tiles[tileIndex(pos)];
             }
 
             Pieces_t::const_iterator begin() const
@@ -258,91 +458,148 @@ namespace chesspp
             {
                 return pieces.end();
             }
+            //Changes whenever the move lists do, so that what is derived from them can be cached
+            std::uint64_t revision() const noexcept
+            {
+                return revisions;
+            }
+            //The number of pieces still on the board
+            std::size_t pieceCount() const noexcept
+            {
+                return pieces.size();
+            }
 
-            class Movements
+            //Returns the piece with the given index, or end() if it was captured
+            Pieces_t::iterator piece(PieceIndex_t index) const noexcept
             {
-                Movements_t const &m;
-                Movements(Movements_t const &m_)
-                : m(m_) //can't use {}
-                {
-                }
-                Movements(Movements const &) = delete;
-                Movements(Movements &&) = delete;
-                Movements &operator=(Movements const &) = delete;
-                Movements &operator=(Movements &&) = delete;
-                friend class ::chesspp::board::Board;
+                return pieces.find(index);
+            }
 
-            public:
-                Movements_t::const_iterator begin() const
-                {
-                    return m.cbegin();
-                }
-                Movements_t::const_iterator end() const
-                {
-                    return m.cend();
-                }
-            };
-        private:
-            Movements const trajs {trajectories};
-            Movements const captings {capturings};
-            Movements const captables {capturables};
-        public:
-            Movements const &pieceTrajectories() const
+            //Views into the move lists, invalidated by the next move or capture
+            using Movements = Movements_t::Span;
+            Movements pieceTrajectories() const noexcept
             {
-                return trajs;
+                return trajectories.all();
             }
-            Movements const &pieceCapturings() const
+            Movements pieceCapturings() const noexcept
             {
-                return captings;
+                return capturings.all();
             }
-            Movements const &pieceCapturables() const
+            Movements pieceCapturables() const noexcept
             {
-                return captables;
+                return capturables.all();
             }
-            class MovementsRange
+            Movements pieceTrajectory(Piece const &p) const noexcept
             {
-                std::pair<Movements_t::iterator, Movements_t::iterator> r;
-                MovementsRange(std::pair<Movements_t::iterator, Movements_t::iterator> const &r_)
-                : r{r_}
-                {
-                }
-                friend class ::chesspp::board::Board;
+                return trajectories.of(p.index);
+            }
+            Movements pieceCapturing(Piece const &p) const noexcept
+            {
+                return capturings.of(p.index);
+            }
+            Movements pieceCapturable(Piece const &p) const noexcept
+            {
+                return capturables.of(p.index);
+            }
 
-            public:
-                Movements_t::const_iterator begin() const
-                {
-                    return r.first;
-                }
-                Movements_t::const_iterator end() const
+            //Zobrist hash of the pieces and their states, such as castling and en passant
+            Zobrist::Key_t hash() const noexcept
+            {
+                return zobrist;
+            }
+            //Same as hash() but also includes the suit to move
+            Zobrist::Key_t hash(Suit const &turn) const noexcept
+            {
+                return zobrist ^ Zobrist::turn(turn);
+            }
+
+            //The moves made since the last capture or Pawn move, or since the
+            //board was set up, for the fifty-move rule
+            std::size_t reversiblePlies() const noexcept
+            {
+                return reversible;
+            }
+            //How many times the position occurred before with the same suit to move,
+            //which can only be since the last irreversible move
+            std::size_t repetitions() const noexcept
+            {
+                std::size_t const step = config.suits().size();
+                std::size_t n = 0;
+                if(step == 0) return n;
+                Zobrist::Key_t const *last = reached.data() + reached.size() - 1;
+                for(std::size_t back = step; back <= reversible; back += step)
                 {
-                    return r.second;
+                    n += *(last - back) == *last;
                 }
-            };
-            MovementsRange pieceTrajectory(Piece const &p)
+                return n;
+            }
+
+            //At most one observer, nullptr for none; not carried over to copies
+            void observe(Observer *o) noexcept
             {
-                return trajectories.equal_range(p.self());
+                observer = o;
             }
-            MovementsRange pieceCapturing(Piece const &p)
+            Observer *observed() const noexcept
             {
-                return capturings.equal_range(p.self());
+                return observer;
             }
-            MovementsRange pieceCapturable(Piece const &p)
+
+            //Whether moves only recalculate the trajectories of affected pieces
+            bool incrementalUpdates() const noexcept
+            {
+                return incremental;
+            }
+            void incrementalUpdates(bool enabled) noexcept
             {
-                return capturables.equal_range(p.self());
+                incremental = enabled;
             }
 
         private:
-            void update(Position_t const &pos);
+            //Recalculates trajectories after the moved piece went from one tile to
+            //another, vacated holds where a captured piece was if not at to
+            void update(Pieces_t::iterator moved, Position_t const &from, Position_t const &to, std::initializer_list<Position_t> vacated);
+            void rebuild();
+            void verify(Position_t const &from, Position_t const &to); //only with CHESSPP_VERIFY_UPDATES
+            void regenerate(); //recalculates the stale pieces and keeps the moves of the others
+            void rehash(PieceIndex_t piece);      //updates what the piece adds to the hash
+            void place(Pieces_t::iterator piece); //adds the piece to the occupancy sets at its position
+            void lift(Pieces_t::iterator piece);  //removes the piece from the occupancy sets
+            void carry(PieceIndex_t piece, Position_t const &to); //for Interaction::carry()
+            bool affected(Pieces_t::iterator piece, Position_t const *tiles, std::size_t count) const; //whether its moves reach any of the tiles
         public:
             //Capture a capturable piece
             bool capture(Pieces_t::iterator source, Movements_t::const_iterator target, Movements_t::const_iterator capturable);
             //Move a piece without capturing
             bool move(Pieces_t::iterator source, Movements_t::const_iterator target);
 
+            //Same as move(), or capture() if capturable is given, but without logging.
+            //Every move made on the board can be undone with unmakeMove().
+            bool makeMove(Pieces_t::iterator source, Movements_t::const_iterator target, Movements_t::const_iterator capturable = nullptr);
+            //Undoes the last move or capture, returns false if there is none
+            bool unmakeMove();
+            //The number of moves that can be undone
+            std::size_t plies() const noexcept
+            {
+                return history.size();
+            }
+            //The pieces the last move changed, NoPiece where none, so that
+            //state kept elsewhere for the board can follow it; needs plies() > 0
+            class Change
+            {
+            public:
+                PieceIndex_t moved, captured, carried;
+            };
+            Change lastChange() const noexcept
+            {
+                auto const &u = history.back();
+                return Change{u.moved, u.captured, u.carried};
+            }
+
             //Check if a position is a valid position that exists on the board
             bool valid(Position_t const &pos) const noexcept
             {
-                return pos.isWithin(Position_t::Origin(), {config.boardWidth(), config.boardHeight()});
+                //isWithin is inclusive of the bottom-right corner
+                return pos.isWithin(Position_t::Origin(), {BoardSize_t(config.boardWidth()-1), BoardSize_t(config.boardHeight()-1)});
             }
         };
 
@@ -355,6 +612,10 @@ namespace chesspp
     {
         using Suit = board::Suit;
         using Piece = board::Piece;
+
+        //Move generation of each built-in class, see piece/Generators.hpp
+        template<Piece::Kind K>
+        class Generator;
     }
 }
 
@@ -0,0 +1,113 @@
+#include "Castling.hpp"
+
+#include <set>
+#include <cstdlib>
+
+namespace chesspp
+{
+    namespace board
+    {
+        constexpr std::size_t Castling::MaxSuits;
+        constexpr Castling::PieceIndex_t Castling::NoPiece;
+
+        void Castling::pair()
+        {
+            if(paired) return;
+            paired = true;
+
+            //same suit order as the players
+            auto const &suits = board.config.suits();
+            pairs.resize(2*MaxSuits);
+            for(auto const *p : slow)
+            {
+                if(p->index >= owned.size()) owned.resize(std::size_t(p->index) + 1, 0);
+            }
+            for(auto const *p : fast)
+            {
+                if(p->index >= owned.size()) owned.resize(std::size_t(p->index) + 1, 0);
+            }
+
+            for(auto const *k : slow)
+            {
+                std::size_t suit = std::size_t(std::distance(suits.begin(), suits.find(k->suit)));
+                if(k->moves != 0 || suit >= MaxSuits) continue;
+                for(unsigned side = 0; side < 2; ++side)
+                {
+                    Pair &c = pairs[2*suit + side];
+                    if(c.king != NoPiece) continue; //the first King of the suit castles
+                    signed nearest = 0;
+                    for(auto const *r : fast)
+                    {
+                        if(r->suit != k->suit || r->moves != 0) continue;
+                        signed dx = signed(r->pos.x) - signed(k->pos.x), dy = signed(r->pos.y) - signed(k->pos.y);
+                        signed d = (dy == 0)? dx : (dx == 0)? dy : 0;
+                        //needs room for the King to move two tiles without landing on the Rook
+                        if(std::abs(d) < 3 || (d < 0) != (side == 0)) continue;
+                        if(nearest != 0 && std::abs(d) >= std::abs(nearest)) continue;
+                        nearest = d;
+                        signed sx = (dx > 0) - (dx < 0), sy = (dy > 0) - (dy < 0);
+                        c.king = k->index;
+                        c.rook = r->index;
+                        c.king_from = k->pos;
+                        c.rook_from = r->pos;
+                        c.king_to = Position_t(k->pos).move(2*sx, 2*sy);
+                        c.rook_to = Position_t(k->pos).move(sx, sy);
+                    }
+                    if(c.king == NoPiece) continue;
+                    Rights_t bit = Rights_t(1) << (2*suit + side);
+                    owned[c.king] |= bit;
+                    owned[c.rook] |= bit;
+                    kings |= bit;
+                    rooks |= bit;
+                }
+            }
+            slow.clear();
+            fast.clear();
+        }
+
+        bool Castling::clear(Pair const &c) const noexcept
+        {
+            auto rook = board.piece(c.rook);
+            if(rook == board.end() || (*rook)->pos != c.rook_from) return false;
+            signed sx = (c.rook_from.x > c.king_from.x) - (c.rook_from.x < c.king_from.x);
+            signed sy = (c.rook_from.y > c.king_from.y) - (c.rook_from.y < c.king_from.y);
+            for(Position_t t = Position_t(c.king_from).move(sx, sy); t != c.rook_from; t.move(sx, sy))
+            {
+                if(board.occupied(t)) return false;
+            }
+            return true;
+        }
+
+        Castling::Pair const *Castling::find(Piece const &king, Position_t const &from, Position_t const &to) noexcept
+        {
+            for(Rights_t r = held(king) & kings & rooks; r; r &= r - 1)
+            {
+                unsigned bit = 0;
+                while(!(r >> bit & 1)) ++bit;
+                Pair const &c = pairs[bit];
+                auto rook = board.piece(c.rook);
+                if(from == c.king_from && to == c.king_to && rook != board.end() && (*rook)->pos == c.rook_from)
+                {
+                    return &c;
+                }
+            }
+            return nullptr;
+        }
+
+        bool Castling::castles(Piece const &king, Position_t const &from, Position_t const &to, Position_t &crossed) noexcept
+        {
+            auto c = find(king, from, to);
+            if(c) crossed = c->rook_to;
+            return c != nullptr;
+        }
+
+        void Castling::kingMoved(Piece const &king, Position_t const &from, Position_t const &to)
+        {
+            if(auto c = find(king, from, to))
+            {
+                carry(c->rook, c->rook_to);
+            }
+            kings &= ~held(king);
+        }
+    }
+}
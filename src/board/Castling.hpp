@@ -3,15 +3,59 @@
 
 #include "Board.hpp"
 
-#include <set>
+#include <vector>
+#include <cstdint>
 
 namespace chesspp
 {
     namespace board
     {
+        /**
+         * Lets an unmoved King move two tiles towards an unmoved Rook
+         * of its suit on the same row or column, with the Rook carried
+         * to the tile the King crosses. Kings register as slow pieces
+         * and Rooks as fast ones; once the board has been set up, each
+         * King is paired with the nearest Rook on either side of it.
+         * The rights are kept as bits, 2*suit + side with suits in
+         * sorted order and side 0 towards the lower coordinate, so
+         * testing them during a search never looks anything up. The
+         * bits a piece holds are its saved state, which is how they
+         * are hashed and restored when a move is undone.
+         */
         class Castling : public Board::Interaction
         {
-            std::set<Piece *> slow, fast;
+        public:
+            using Rights_t = std::uint32_t;
+            using State_t = Board::Piece::State_t;
+            using Position_t = Board::Position_t;
+            static constexpr std::size_t MaxSuits = 16; //two bits each
+
+        private:
+            using PieceIndex_t = Board::PieceIndex_t;
+            static constexpr PieceIndex_t NoPiece = PieceIndex_t(-1);
+            class Pair
+            {
+            public:
+                PieceIndex_t king = NoPiece, rook = NoPiece;
+                Position_t king_from, king_to, rook_from, rook_to;
+            };
+
+            std::vector<Piece const *> slow, fast; //registered Kings and Rooks, until paired
+            bool paired = false;
+            std::vector<Pair> pairs;     //by right
+            std::vector<Rights_t> owned; //by piece index, the rights each King or Rook takes part in
+            Rights_t kings = 0;          //rights whose King hasn't moved
+            Rights_t rooks = 0;          //rights whose Rook hasn't moved
+
+            void pair();
+            Rights_t held(Piece const &p) noexcept
+            {
+                pair();
+                return p.index < owned.size()? owned[p.index] : 0;
+            }
+            bool clear(Pair const &c) const noexcept; //Rook in place and nothing between
+            Pair const *find(Piece const &king, Position_t const &from, Position_t const &to) noexcept;
+
         public:
             Castling(Board &b)
             : Interaction{b}
@@ -21,23 +65,66 @@ namespace chesspp
 
             void addSlow(Piece *p)
             {
-                slow.insert(p);
+                slow.push_back(p);
             }
-            void removeSlow(Piece *p)
+            void addFast(Piece *p)
             {
-                slow.erase(p);
+                fast.push_back(p);
             }
 
-            void addFast(Piece *p)
+            //The rights still held by both their King and their Rook
+            Rights_t rights() noexcept
+            {
+                pair();
+                return kings & rooks;
+            }
+
+            //Calls f with the tile the King moves to for each castle it can make now
+            template<typename F>
+            void castles(Piece const &king, F f)
+            {
+                for(Rights_t r = held(king) & kings & rooks; r; r &= r - 1)
+                {
+                    unsigned bit = 0;
+                    while(!(r >> bit & 1)) ++bit;
+                    if(clear(pairs[bit])) f(pairs[bit].king_to);
+                }
+            }
+            //Whether the King moving from one tile to another castles,
+            //if so crossed is set to the tile it passes over
+            bool castles(Piece const &king, Position_t const &from, Position_t const &to, Position_t &crossed) noexcept;
+            //Whether the King hasn't moved since it could castle, its trajectory then
+            //depends on the tiles up to the Rooks and on whether they have moved
+            bool pending(Piece const &king) noexcept
+            {
+                return (held(king) & kings) != 0;
+            }
+
+            //For King
+            State_t kingState(Piece const &king) noexcept
             {
-                fast.insert(p);
+                return held(king) & kings;
             }
-            void removeFast(Piece *p)
+            void restoreKing(Piece const &king, State_t state) noexcept
             {
-                fast.erase(p);
+                kings = (kings & ~held(king)) | state;
             }
+            //Carries the Rook if the King castled, then takes away its rights
+            void kingMoved(Piece const &king, Position_t const &from, Position_t const &to);
 
-            //
+            //For Rook
+            State_t rookState(Piece const &rook) noexcept
+            {
+                return held(rook) & rooks;
+            }
+            void restoreRook(Piece const &rook, State_t state) noexcept
+            {
+                rooks = (rooks & ~held(rook)) | state;
+            }
+            void rookMoved(Piece const &rook) noexcept
+            {
+                rooks &= ~held(rook);
+            }
         };
     }
 }
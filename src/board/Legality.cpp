@@ -0,0 +1,260 @@
+#include "Legality.hpp"
+#include "Castling.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace chesspp
+{
+    namespace board
+    {
+        namespace
+        {
+            using Dir = util::Direction;
+            using Position_t = Board::Position_t;
+
+            //The direction from a to b if they share a row, column or diagonal
+            static bool line(Position_t const &a, Position_t const &b, Dir &d) noexcept
+            {
+                signed dx = signed(b.x) - signed(a.x);
+                signed dy = signed(b.y) - signed(a.y);
+                if(dx == 0 && dy == 0) return false;
+                if(dx == 0)       d = dy < 0? Dir::North : Dir::South;
+                else if(dy == 0)  d = dx > 0? Dir::East  : Dir::West;
+                else if(dx == dy || dx == -dy)
+                {
+                    d = dx > 0? (dy < 0? Dir::NorthEast : Dir::SouthEast)
+                              : (dy < 0? Dir::NorthWest : Dir::SouthWest);
+                }
+                else return false;
+                return true;
+            }
+            static bool slides(std::uint8_t rays, Dir d) noexcept
+            {
+                return (rays >> (unsigned(d) - 1) & 1) != 0;
+            }
+            //Whether t is on the line from a to b, after a and no further than b
+            static bool within(Position_t const &a, Position_t const &b, Position_t const &t) noexcept
+            {
+                Dir ab, at;
+                if(!line(a, b, ab) || !line(a, t, at) || ab != at) return false;
+                auto distance = [](Position_t const &x, Position_t const &y)
+                {
+                    return std::max(std::abs(signed(x.x) - signed(y.x)), std::abs(signed(x.y) - signed(y.y)));
+                };
+                return distance(a, t) <= distance(a, b);
+            }
+        }
+
+        constexpr Legality::Offset_t Legality::None;
+        constexpr Legality::PieceIndex_t Legality::NoPiece;
+
+        bool Legality::royal(Piece const &p) const noexcept
+        {
+            return p.kind == Piece::Kind::King || (p.kind == Piece::Kind::Custom && p.pclass == "King");
+        }
+
+        void Legality::update(Board &b, Suit const &t)
+        {
+            board = &b;
+            turn = t;
+            unrestricted = exact = false;
+            king = NoPiece;
+            kings.clear();
+            checkers.clear();
+            sliders.clear();
+            pinners.clear();
+            attacks.assign(std::size_t(board->config.boardWidth())*board->config.boardHeight(), 0);
+            attackers.resize(attacks.size());
+
+            for(auto it = board->begin(); it != board->end(); ++it)
+            {
+                Piece const &p = **it;
+                if(p.index >= pinners.size()) pinners.resize(std::size_t(p.index) + 1, NoPiece);
+                if(p.suit == turn)
+                {
+                    if(royal(p)) kings.push_back(p.index);
+                    continue;
+                }
+                if(p.kind == Piece::Kind::Custom)
+                {
+                    exact = true; //captures in ways not known here
+                }
+                else if(p.rays() != 0)
+                {
+                    sliders.push_back(Slider{p.index, p.pos, p.rays()});
+                }
+            }
+            if(kings.empty())
+            {
+                unrestricted = true;
+                return;
+            }
+            if(kings.size() > 1) exact = true;
+            king = kings.front();
+            king_pos = (*board->piece(king))->pos;
+
+            for(auto const &c : board->pieceCapturings())
+            {
+                Piece const &p = **board->piece(c.piece);
+                if(p.suit == turn) continue;
+                for(auto k : kings)
+                {
+                    if(c.tile == (*board->piece(k))->pos && (checkers.empty() || checkers.back() != c.piece))
+                    {
+                        checkers.push_back(c.piece);
+                    }
+                }
+                if(p.rays() == 0)
+                {
+                    ++attacks[tile(c.tile)];
+                    attackers[tile(c.tile)] = c.piece;
+                }
+            }
+            if(exact) return;
+
+            //a lone piece of the suit between a slider and the King is pinned to that line
+            auto const &geometry = board->config.geometry();
+            for(auto const &s : sliders)
+            {
+                Dir d;
+                if(!line(s.pos, king_pos, d) || !slides(s.rays, d)) continue;
+                PieceIndex_t blocker = NoPiece;
+                unsigned blockers = 0;
+                for(auto const &t : geometry.ray(s.pos, d))
+                {
+                    if(t == king_pos) break;
+                    if(board->occupied(t))
+                    {
+                        blocker = (*board->pieceAt(t))->index;
+                        if(++blockers > 1) break;
+                    }
+                }
+                if(blockers == 1 && (*board->piece(blocker))->suit == turn)
+                {
+                    pinners[blocker] = s.piece;
+                }
+            }
+        }
+
+        Legality::Slider const *Legality::slider(PieceIndex_t piece) const noexcept
+        {
+            for(auto const &s : sliders)
+            {
+                if(s.piece == piece) return &s;
+            }
+            return nullptr;
+        }
+
+        bool Legality::reaches(Slider const &s, Position_t const &target, Position_t const &vacated, Position_t const &filled, Position_t const *vacated_too) const noexcept
+        {
+            Dir d;
+            if(!line(s.pos, target, d) || !slides(s.rays, d)) return false;
+            for(auto const &t : board->config.geometry().ray(s.pos, d))
+            {
+                if(t == target) return true;
+                if(t == filled) return false;
+                if(board->occupied(t) && t != vacated && !(vacated_too && t == *vacated_too)) return false;
+            }
+            return false;
+        }
+
+        bool Legality::safe(Position_t const &to, PieceIndex_t victim, Position_t const *vacated_too) const noexcept
+        {
+            auto a = attacks[tile(to)];
+            if(a > 1 || (a == 1 && attackers[tile(to)] != victim)) return false;
+            for(auto const &s : sliders)
+            {
+                if(s.piece != victim && reaches(s, to, king_pos, to, vacated_too)) return false;
+            }
+            return true;
+        }
+
+        bool Legality::attacked(Position_t const &pos) const noexcept
+        {
+            for(auto const &e : board->pieceCapturings())
+            {
+                if(e.tile == pos && (*board->piece(e.piece))->suit != turn) return true;
+            }
+            return false;
+        }
+
+        bool Legality::byMaking(Offset_t target, Offset_t capturable)
+        {
+            auto const &entry = (capturable == None? board->pieceTrajectories() : board->pieceCapturings()).begin()[target];
+            auto source = board->piece(entry.piece);
+            bool made = (capturable == None)
+                      ? board->makeMove(source, board->pieceTrajectories().begin() + target)
+                      : board->makeMove(source, board->pieceCapturings().begin() + target, board->pieceCapturables().begin() + capturable);
+            if(!made) return false;
+
+            bool attacked = false;
+            for(auto k : kings)
+            {
+                auto it = board->piece(k);
+                for(auto const &c : board->pieceCapturable(**it))
+                {
+                    for(auto const &e : board->pieceCapturings())
+                    {
+                        if(e.tile == c.tile && (*board->piece(e.piece))->suit != turn
+                        && (!board->occupied(c.tile) || board->pieceAt(c.tile) == it))
+                        {
+                            attacked = true;
+                            break;
+                        }
+                    }
+                    if(attacked) break;
+                }
+                if(attacked) break;
+            }
+            board->unmakeMove();
+            return !attacked;
+        }
+
+        bool Legality::allows(Offset_t target, Offset_t capturable)
+        {
+            if(unrestricted) return true;
+            auto const &entry = (capturable == None? board->pieceTrajectories() : board->pieceCapturings()).begin()[target];
+            PieceIndex_t mover = entry.piece;
+            Position_t to = entry.tile;
+            PieceIndex_t victim = NoPiece;
+            if(capturable != None)
+            {
+                victim = board->pieceCapturables().begin()[capturable].piece;
+                if((*board->piece(victim))->pos != to) return byMaking(target, capturable); //may open a line
+            }
+            Piece const &moving = **board->piece(mover);
+            if(royal(moving) && (std::abs(signed(to.x) - signed(moving.pos.x)) > 1 || std::abs(signed(to.y) - signed(moving.pos.y)) > 1))
+            {
+                Position_t crossed;
+                if(board->getInteraction<Castling>().castles(moving, moving.pos, to, crossed))
+                {
+                    //not out of or through check, making it finds whether it ends in check
+                    if(attacked(moving.pos) || attacked(crossed)) return false;
+                    return byMaking(target, capturable);
+                }
+            }
+            if(exact) return byMaking(target, capturable);
+
+            if(mover == king)
+            {
+                return safe(to, victim, nullptr);
+            }
+            if(checkers.size() > 1) return false; //only the King can escape
+            if(pinners[mover] != NoPiece)
+            {
+                auto s = slider(pinners[mover]);
+                if(!within(king_pos, s->pos, to)) return false; //would leave the line
+            }
+            if(checkers.size() == 1 && victim != checkers.front())
+            {
+                //not capturing the checker, so it has to block it
+                auto s = slider(checkers.front());
+                if(!s) return false;
+                Position_t const &from = s->pos;
+                if(!within(king_pos, from, to) || to == from) return false;
+            }
+            return true;
+        }
+    }
+}
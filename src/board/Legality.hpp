@@ -0,0 +1,88 @@
+#ifndef ChessPlusPlus_Board_LegalityClass_HeaderPlusPlus
+#define ChessPlusPlus_Board_LegalityClass_HeaderPlusPlus
+
+#include "Board.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace board
+    {
+        /**
+         * Decides which of the moves of a suit leave its King safe,
+         * without making them. Checkers, pins and the tiles attacked
+         * by pieces whose captures don't depend on other pieces are
+         * found once, from the enemy capturings and the rays of
+         * Bishops, Rooks, Queens and plugin pieces that slide the same
+         * way. Positions it can't reason about this way, with enemy
+         * pieces that capture in other ways, several Kings,
+         * or a capture of a piece that isn't on the tile moved to,
+         * such as en passant, are checked by making the move, as are
+         * castles once the King is known not to be castling out of or
+         * through an attacked tile.
+         * A suit without a King may make any move. The buffers are
+         * kept between positions so it can be reused without allocating.
+         */
+        class Legality
+        {
+        public:
+            using Offset_t = std::size_t;
+            static constexpr Offset_t None = Offset_t(-1);
+
+        private:
+            using Position_t = Board::Position_t;
+            using PieceIndex_t = Board::PieceIndex_t;
+            static constexpr PieceIndex_t NoPiece = PieceIndex_t(-1);
+            class Slider
+            {
+            public:
+                PieceIndex_t piece;
+                Position_t pos;
+                std::uint8_t rays; //as Piece::rays()
+            };
+
+            Board *board = nullptr;
+            Suit turn;
+            std::vector<PieceIndex_t> kings;
+            bool unrestricted = false; //no King
+            bool exact = false;        //every move is made to check it
+            PieceIndex_t king = NoPiece; //the only King when not exact
+            Position_t king_pos;
+            std::vector<PieceIndex_t> checkers;
+            std::vector<Slider> sliders;               //enemy pieces that capture along rays
+            std::vector<PieceIndex_t> pinners;         //by piece index, NoPiece if not pinned
+            std::vector<unsigned> attacks;             //by tile, enemy pieces that capture there regardless of occupancy
+            std::vector<PieceIndex_t> attackers;       //by tile, the last of them
+
+            std::size_t tile(Position_t const &pos) const noexcept
+            {
+                return std::size_t(pos.y)*board->config.boardWidth() + pos.x;
+            }
+            Slider const *slider(PieceIndex_t piece) const noexcept;
+            //Whether the slider reaches target once vacated and vacated_too are empty and filled is not
+            bool royal(Piece const &p) const noexcept;
+            bool reaches(Slider const &s, Position_t const &target, Position_t const &vacated, Position_t const &filled, Position_t const *vacated_too) const noexcept;
+            bool safe(Position_t const &to, PieceIndex_t victim, Position_t const *vacated_too) const noexcept;
+            bool attacked(Position_t const &pos) const noexcept; //by any enemy capturing
+            bool byMaking(Offset_t target, Offset_t capturable);
+
+        public:
+            //Examines the position of the board as it is now for the suit,
+            //needed again after every move
+            void update(Board &b, Suit const &turn);
+
+            bool inCheck() const noexcept
+            {
+                return !checkers.empty();
+            }
+            //Whether the suit may make the move, target being an offset into the trajectories,
+            //or into the capturings if capturable is an offset into the capturables
+            bool allows(Offset_t target, Offset_t capturable = None);
+        };
+    }
+}
+
+#endif
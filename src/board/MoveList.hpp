@@ -0,0 +1,162 @@
+#ifndef ChessPlusPlus_Board_FlatMoveListClass_HeaderPlusPlus
+#define ChessPlusPlus_Board_FlatMoveListClass_HeaderPlusPlus
+
+#include "config/BoardConfig.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <functional>
+
+namespace chesspp
+{
+    namespace board
+    {
+        /**
+         * Contiguous list of tiles per piece, ordered by piece
+         * index so that each piece owns one range of the list.
+         * The list is regenerated in passes which either keep
+         * a piece's previous range or let it add new tiles, into
+         * a second buffer which is then swapped in. Both buffers
+         * keep their capacity, so once they have grown large
+         * enough regenerating does not allocate.
+         */
+        class MoveList
+        {
+        public:
+            using PieceIndex_t = std::uint16_t;
+            using Position_t = config::BoardConfig::Position_t;
+
+            class Movement
+            {
+            public:
+                PieceIndex_t piece; //index of the piece, see Board::piece()
+                Position_t tile;
+            };
+            using const_iterator = Movement const *;
+
+            /**
+             * Read-only view of part of a MoveList. Views are
+             * invalidated by the next regeneration pass.
+             */
+            class Span
+            {
+                const_iterator b, e;
+
+            public:
+                Span(const_iterator b_, const_iterator e_) noexcept
+                : b{b_}
+                , e{e_}
+                {
+                }
+
+                const_iterator begin() const noexcept
+                {
+                    return b;
+                }
+                const_iterator end() const noexcept
+                {
+                    return e;
+                }
+                std::size_t size() const noexcept
+                {
+                    return std::size_t(e - b);
+                }
+                bool empty() const noexcept
+                {
+                    return b == e;
+                }
+                bool contains(const_iterator it) const noexcept
+                {
+                    return std::less_equal<const_iterator>()(b, it) && std::less<const_iterator>()(it, e);
+                }
+            };
+
+        private:
+            class Range
+            {
+            public:
+                std::uint32_t first, last;
+            };
+            std::vector<Movement> moves, next;
+            std::vector<Range> ranges, next_ranges;
+            PieceIndex_t open_piece = 0;
+            bool is_open = false;
+
+            Span span(std::vector<Movement> const &v, std::size_t first, std::size_t last) const noexcept
+            {
+                return Span(v.data() + first, v.data() + last);
+            }
+
+        public:
+            Span all() const noexcept
+            {
+                return span(moves, 0, moves.size());
+            }
+            Span of(PieceIndex_t p) const noexcept
+            {
+                if(p >= ranges.size())
+                {
+                    return span(moves, 0, 0);
+                }
+                return span(moves, ranges[p].first, ranges[p].last);
+            }
+
+            //Starts a regeneration pass for the given number of pieces,
+            //which must then be visited in index order with keep() or open()
+            void start(std::size_t pieces)
+            {
+                next.clear();
+                next_ranges.resize(pieces);
+            }
+            //Keeps the tiles the piece had before this pass
+            void keep(PieceIndex_t p)
+            {
+                assert(!is_open);
+                auto first = next.size();
+                auto old = of(p);
+                next.insert(next.end(), old.begin(), old.end());
+                next_ranges[p] = Range{std::uint32_t(first), std::uint32_t(next.size())};
+            }
+            //Lets the piece add tiles until close()
+            void open(PieceIndex_t p) noexcept
+            {
+                assert(!is_open);
+                open_piece = p;
+                is_open = true;
+                next_ranges[p].first = std::uint32_t(next.size());
+            }
+            void add(PieceIndex_t p, Position_t const &tile)
+            {
+                assert(is_open && p == open_piece);
+                next.push_back(Movement{p, tile});
+            }
+            //Removes a tile added since open()
+            void remove(PieceIndex_t p, Position_t const &tile)
+            {
+                assert(is_open && p == open_piece);
+                auto first = next.begin() + next_ranges[p].first;
+                next.erase(std::remove_if(first, next.end(), [&](Movement const &m)
+                {
+                    return m.tile == tile;
+                }), next.end());
+            }
+            void close() noexcept
+            {
+                assert(is_open);
+                next_ranges[open_piece].last = std::uint32_t(next.size());
+                is_open = false;
+            }
+            //Ends the pass, invalidating all previous spans
+            void finish() noexcept
+            {
+                assert(!is_open);
+                moves.swap(next);
+                ranges.swap(next_ranges);
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef ChessPlusPlus_Board_PieceArenaClass_HeaderPlusPlus
+#define ChessPlusPlus_Board_PieceArenaClass_HeaderPlusPlus
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace chesspp
+{
+    namespace board
+    {
+        /**
+         * Owns polymorphic pieces constructed in place in large
+         * blocks, so that pieces created together sit next to each
+         * other in memory. Each piece is given the next index when
+         * it is constructed; indices are never reused, and erased
+         * pieces are only hidden until the arena is destroyed so
+         * that they can be restored later.
+         * \tparam T the common base class of the stored pieces,
+         * which must have a virtual destructor.
+         */
+        template<typename T>
+        class PieceArena
+        {
+        public:
+            using size_type = std::size_t;
+            using value_type = T *;
+            static constexpr size_type npos = size_type(-1);
+
+            //Visits live pieces in index order, dereferences to T *
+            class iterator
+            {
+                PieceArena const *a = nullptr;
+                size_type i = npos;
+
+                //moves to the first live index at or after i
+                iterator(PieceArena const *a_, size_type i_) noexcept
+                : a{a_}
+                , i{i_}
+                {
+                    while(i < a->objects.size() && !a->live[i]) ++i;
+                    if(i >= a->objects.size()) i = npos;
+                }
+                friend class ::chesspp::board::PieceArena<T>;
+
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T *;
+                using difference_type = std::ptrdiff_t;
+                using pointer = T * const *;
+                using reference = T * const &;
+
+                iterator() = default;
+
+                reference operator*() const noexcept
+                {
+                    return a->objects[i];
+                }
+                pointer operator->() const noexcept
+                {
+                    return &a->objects[i];
+                }
+                iterator &operator++() noexcept
+                {
+                    return *this = iterator(a, i + 1);
+                }
+                iterator operator++(int) noexcept
+                {
+                    iterator old = *this;
+                    ++*this;
+                    return old;
+                }
+
+                //The index of the piece, npos for end()
+                size_type index() const noexcept
+                {
+                    return i;
+                }
+
+                friend bool operator==(iterator const &x, iterator const &y) noexcept
+                {
+                    return x.i == y.i;
+                }
+                friend bool operator!=(iterator const &x, iterator const &y) noexcept
+                {
+                    return x.i != y.i;
+                }
+            };
+            using const_iterator = iterator;
+
+        private:
+            static constexpr size_type BlockSize = 4096;
+            class Block
+            {
+            public:
+                typename std::aligned_storage<BlockSize, alignof(std::max_align_t)>::type data;
+            };
+            std::vector<std::unique_ptr<Block>> blocks;
+            size_type used = BlockSize; //bytes used in the last block
+            std::vector<T *> objects;   //by index
+            std::vector<bool> live;     //by index
+            size_type count = 0;
+
+            void *allocate(size_type size, size_type align)
+            {
+                used = (used + align - 1)/align*align;
+                if(blocks.empty() || used + size > BlockSize)
+                {
+                    blocks.emplace_back(new Block);
+                    used = 0;
+                }
+                void *p = reinterpret_cast<unsigned char *>(&blocks.back()->data) + used;
+                used += size;
+                return p;
+            }
+
+        public:
+            PieceArena() = default;
+            PieceArena(PieceArena const &) = delete;
+            PieceArena &operator=(PieceArena const &) = delete;
+            ~PieceArena()
+            {
+                for(size_type i = objects.size(); i-- > 0; )
+                {
+                    objects[i]->~T();
+                }
+            }
+
+            /**
+             * Constructs a piece at the end of the arena.
+             * \tparam U the type of piece, deriving from T.
+             * \param args the arguments for the constructor of U.
+             * \return an iterator to the new piece.
+             */
+            template<typename U, typename... Args>
+            iterator emplace(Args &&... args)
+            {
+                static_assert(std::is_base_of<T, U>::value, "U must derive from T");
+                static_assert(sizeof(U) <= BlockSize && alignof(U) <= alignof(std::max_align_t), "U does not fit in an arena block");
+                //so nothing can throw after construction, growing geometrically as push_back would
+                if(objects.size() == objects.capacity()) objects.reserve(2*objects.capacity() + 1);
+                if(live.size() == live.capacity()) live.reserve(2*live.capacity() + 1);
+                U *u = ::new(allocate(sizeof(U), alignof(U))) U(std::forward<Args>(args)...);
+                objects.push_back(u);
+                live.push_back(true);
+                ++count;
+                return iterator(this, objects.size() - 1);
+            }
+
+            //Hides the piece from iteration and find(), it is still destroyed with the arena
+            void erase(iterator it) noexcept
+            {
+                live[it.i] = false;
+                --count;
+            }
+            //Makes an erased piece visible again
+            void restore(size_type index) noexcept
+            {
+                if(index < objects.size() && !live[index])
+                {
+                    live[index] = true;
+                    ++count;
+                }
+            }
+
+            iterator begin() const noexcept
+            {
+                return iterator(this, 0);
+            }
+            iterator end() const noexcept
+            {
+                return iterator();
+            }
+            //Returns the live piece with the given index, or end()
+            iterator find(size_type index) const noexcept
+            {
+                if(!alive(index))
+                {
+                    return end();
+                }
+                return iterator(this, index);
+            }
+
+            bool alive(size_type index) const noexcept
+            {
+                return index < objects.size() && live[index];
+            }
+            //The number of indices handed out so far, including erased pieces
+            size_type slots() const noexcept
+            {
+                return objects.size();
+            }
+            size_type size() const noexcept
+            {
+                return count;
+            }
+            bool empty() const noexcept
+            {
+                return count == 0;
+            }
+        };
+
+        template<typename T>
+        constexpr typename PieceArena<T>::size_type PieceArena<T>::npos;
+        template<typename T>
+        constexpr typename PieceArena<T>::size_type PieceArena<T>::BlockSize;
+    }
+}
+
+#endif
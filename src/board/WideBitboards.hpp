@@ -0,0 +1,145 @@
+#ifndef ChessPlusPlus_Board_WideBoardBitboardsClass_HeaderPlusPlus
+#define ChessPlusPlus_Board_WideBoardBitboardsClass_HeaderPlusPlus
+
+#include "config/BoardConfig.hpp"
+#include "util/Position.hpp"
+#include "util/WideBitboard.hpp"
+
+#include <map>
+
+namespace chesspp
+{
+    namespace board
+    {
+        /**
+         * Occupancy sets for boards of any size up to 32x32,
+         * along with mask-based attack generation: sliding
+         * rays are computed with occluded fills and fixed
+         * leaper patterns are stamped at the piece position.
+         */
+        class WideBitboards
+        {
+        public:
+            using Bitboard_t = util::WideBitboard;
+            using BoardSize_t = config::BoardConfig::BoardSize_t;
+            using Position_t = config::BoardConfig::Position_t;
+            using PieceClass_t = config::BoardConfig::PieceClass_t;
+            using SuitClass_t = config::BoardConfig::SuitClass_t;
+
+            static constexpr std::size_t MaxWidth = Bitboard_t::MaxWidth;
+            static constexpr std::size_t MaxHeight = Bitboard_t::MaxHeight;
+
+            /**
+             * A set of offsets relative to a piece, such as the
+             * tiles a Knight or Archer can reach, which can be
+             * stamped at any position without bounds checks.
+             */
+            class Pattern
+            {
+                friend class ::chesspp::board::WideBitboards;
+                static constexpr signed Centre = 15;
+                Bitboard_t tiles;
+
+            public:
+                /**
+                 * \tparam Offsets iterable range of positions with signed coordinates.
+                 * \param offsets the offsets, each coordinate within [-15, 16].
+                 */
+                template<typename Offsets>
+                explicit Pattern(Offsets const &offsets) noexcept
+                {
+                    for(auto const &o : offsets)
+                    {
+                        tiles.set(util::Position<signed>(Centre + o.x, Centre + o.y));
+                    }
+                }
+            };
+
+        private:
+            Bitboard_t tiles;
+            Bitboard_t all;
+            std::map<SuitClass_t, Bitboard_t> suits;
+            std::map<PieceClass_t, Bitboard_t> classes;
+
+        public:
+            WideBitboards(BoardSize_t width, BoardSize_t height) noexcept
+            : tiles{Bitboard_t::board(width, height)}
+            {
+            }
+
+            //Every tile on the board
+            Bitboard_t const &board() const noexcept
+            {
+                return tiles;
+            }
+            Bitboard_t const &occupied() const noexcept
+            {
+                return all;
+            }
+            Bitboard_t suit(SuitClass_t const &s) const
+            {
+                auto it = suits.find(s);
+                return it != suits.end()? it->second : Bitboard_t{};
+            }
+            Bitboard_t pieceClass(PieceClass_t const &c) const
+            {
+                auto it = classes.find(c);
+                return it != classes.end()? it->second : Bitboard_t{};
+            }
+
+            void add(Position_t const &p, PieceClass_t const &c, SuitClass_t const &s)
+            {
+                all.set(p);
+                suits[s].set(p);
+                classes[c].set(p);
+            }
+            void remove(Position_t const &p, PieceClass_t const &c, SuitClass_t const &s)
+            {
+                all.reset(p);
+                suits[s].reset(p);
+                classes[c].reset(p);
+            }
+
+            /**
+             * Returns the tiles a slider at from attacks in the
+             * given directions, up to and including the first
+             * occupied tile in each direction.
+             * \tparam Dirs iterable range of util::Direction.
+             * \param from the position of the slider.
+             * \param dirs the directions the slider moves in.
+             * \return the attacked tiles.
+             */
+            template<typename Dirs>
+            Bitboard_t rays(Position_t const &from, Dirs const &dirs) const noexcept
+            {
+                Bitboard_t const origin = Bitboard_t::tile(from);
+                Bitboard_t const empty = Bitboard_t(tiles).remove(all);
+                Bitboard_t attacks;
+                for(auto d : dirs)
+                {
+                    attacks |= origin.ray(d, empty, tiles);
+                }
+                return attacks;
+            }
+            /**
+             * Returns the tiles of a pattern relative to the
+             * given position which are on the board.
+             * \param p the pattern of offsets.
+             * \param at the position the offsets are relative to.
+             * \return the tiles on the board.
+             */
+            Bitboard_t stamp(Pattern const &p, Position_t const &at) const noexcept
+            {
+                return p.tiles.shifted(signed(at.x) - Pattern::Centre, signed(at.y) - Pattern::Centre) & tiles;
+            }
+
+            template<typename F>
+            static void forEach(Bitboard_t const &b, F f)
+            {
+                b.forEach<BoardSize_t>(f);
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef ChessPlusPlus_Board_ZobristHashingKeys_HeaderPlusPlus
+#define ChessPlusPlus_Board_ZobristHashingKeys_HeaderPlusPlus
+
+#include "config/BoardConfig.hpp"
+
+#include <string>
+#include <cstdint>
+
+namespace chesspp
+{
+    namespace board
+    {
+        /**
+         * Zobrist keys for arbitrary piece classes, suits and board
+         * sizes. Rather than filling tables with random numbers, each
+         * key is derived from the names and coordinates it stands for,
+         * so keys are the same for every board layout and every run,
+         * and hashes can be stored and compared across games.
+         */
+        class Zobrist
+        {
+        public:
+            using Key_t = std::uint64_t;
+            using Position_t = config::BoardConfig::Position_t;
+            using PieceClass_t = config::BoardConfig::PieceClass_t;
+            using SuitClass_t = config::BoardConfig::SuitClass_t;
+
+            //splitmix64 finalizer
+            static Key_t mix(Key_t k) noexcept
+            {
+                k += 0x9E3779B97F4A7C15ull;
+                k = (k ^ (k >> 30))*0xBF58476D1CE4E5B9ull;
+                k = (k ^ (k >> 27))*0x94D049BB133111EBull;
+                return k ^ (k >> 31);
+            }
+            //64-bit FNV-1a
+            static Key_t name(std::string const &s) noexcept
+            {
+                Key_t h = 0xCBF29CE484222325ull;
+                for(unsigned char c : s)
+                {
+                    h = (h ^ c)*0x100000001B3ull;
+                }
+                return h;
+            }
+
+            /**
+             * The seed for the keys of a piece class and suit, which
+             * pieces should compute once and pass to piece() and state().
+             */
+            static Key_t seed(PieceClass_t const &c, SuitClass_t const &s) noexcept
+            {
+                return mix(name(c)) ^ mix(name(s) + 1);
+            }
+            //The key of a piece with the given seed standing at p
+            static Key_t piece(Key_t seed, Position_t const &p) noexcept
+            {
+                return mix(seed ^ (Key_t(p.x) | Key_t(p.y) << 8));
+            }
+            //The key of the state of a piece, e.g. whether it can still castle, 0 for none
+            static Key_t state(Key_t seed, Position_t const &p, std::uint32_t s) noexcept
+            {
+                return s? mix(piece(seed, p) ^ (Key_t(s) << 16)) : 0;
+            }
+            //The key of the suit to move
+            static Key_t turn(SuitClass_t const &s) noexcept
+            {
+                return mix(name(s) ^ 0x5851F42D4C957F2Dull);
+            }
+        };
+    }
+}
+
+#endif
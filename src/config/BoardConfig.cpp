@@ -0,0 +1,139 @@
+#include "BoardConfig.hpp"
+#include "util/Serialization.hpp"
+
+#include <sstream>
+
+namespace chesspp
+{
+    namespace config
+    {
+        BoardConfig::BoardConfig(std::string const &path)
+        : Configuration{path, 0}
+        , board_width  {reader()["board"]["width"]      }
+        , board_height {reader()["board"]["height"]     }
+        , cell_width   {reader()["board"]["cell width"] }
+        , cell_height  {reader()["board"]["cell height"]}
+        , board_geometry{board_width, board_height}
+        {
+            if(!cached() || !loadResolved(cachedExtra()))
+            {
+                resolve();
+                store(compileResolved());
+            }
+            auto plugins = reader()["board"]["piece plugins"];
+            for(std::size_t i = 0; i < plugins.length(); ++i)
+            {
+                //relative to the working directory or else the executable, like configurations
+                std::string plugin = plugins[i];
+                if(!boost::filesystem::path(plugin).is_absolute())
+                {
+                    plugin = boost::filesystem::exists(plugin)? boost::filesystem::absolute(plugin).string() : executablePath() + plugin;
+                }
+                piece_plugins.push_back(plugin);
+            }
+            for(auto const &l : layout)
+            {
+                if(!l.second.second.empty())
+                {
+                    suit_classes.insert(l.second.second);
+                }
+                if(facing(l.first) != util::Direction::None)
+                {
+                    suit_facings.insert({l.second.second, facing(l.first)});
+                }
+            }
+        }
+        BoardConfig::BoardConfig(Configuration &res, std::string const &path)
+        : BoardConfig{path}
+        {
+            resolveTextures(res);
+        }
+
+        void BoardConfig::resolve()
+        {
+            layout.clear();
+            facings.assign(std::size_t(board_width)*board_height, util::Direction::None);
+
+            auto pieces = reader()["board"]["pieces"];
+            auto suits  = reader()["board"]["suits"];
+            for(BoardSize_t r = 0; r < board_height; ++r)
+            {
+                for(BoardSize_t c = 0; c < board_width; ++c)
+                {
+                    auto piece = pieces[r][c];
+                    auto suit  = suits [r][c];
+                    if(piece.type() != json_null) //it is OK if suit is null
+                    {
+                        layout[{c, r}] = std::make_pair(PieceClass_t(std::string(piece)), SuitClass_t(std::string(suit)));
+                    }
+                    auto face = metadata("pawn facing", r, c);
+                    if(face.type() == json_string)
+                    {
+                        std::istringstream {std::string(face)} >> facings[std::size_t(r)*board_width + c];
+                    }
+                }
+            }
+        }
+
+        void BoardConfig::resolveTextures(Configuration &res)
+        {
+            //not cached, as it only walks a tree that is already loaded
+            auto const &tex = res.setting("board", "pieces");
+            for(auto const &suit : tex.object())
+            {
+                for(auto const &piece : suit.second.object())
+                {
+                    textures[SuitClass_t(suit.first)][PieceClass_t(piece.first)] = std::string(Textures_t::mapped_type::mapped_type(piece.second));
+                }
+            }
+            for(auto const &suit : textures)
+            {
+                for(auto const &piece : suit.second)
+                {
+                    texture_ids[std::uint64_t(suit.first.id()) << 32 | piece.first.id()] = &piece.second;
+                }
+            }
+        }
+
+        std::string BoardConfig::compileResolved() const
+        {
+            std::string out;
+            util::ByteWriter bytes {out};
+            bytes.value(std::uint32_t(layout.size()));
+            for(auto const &l : layout)
+            {
+                bytes.value(l.first.x);
+                bytes.value(l.first.y);
+                bytes.string(l.second.first);
+                bytes.string(l.second.second);
+            }
+            for(auto f : facings)
+            {
+                bytes.value(std::uint8_t(f));
+            }
+            return out;
+        }
+
+        bool BoardConfig::loadResolved(std::string const &data)
+        {
+            util::ByteReader bytes {data.data(), data.size()};
+            for(auto n = bytes.value<std::uint32_t>(); n > 0 && bytes.ok(); --n)
+            {
+                Position_t p;
+                p.x = bytes.value<BoardSize_t>();
+                p.y = bytes.value<BoardSize_t>();
+                PieceClass_t piece {bytes.string()};
+                layout[p] = std::make_pair(piece, SuitClass_t(bytes.string()));
+                if(p.x >= board_width || p.y >= board_height) return false;
+            }
+            facings.resize(std::size_t(board_width)*board_height);
+            for(auto &f : facings)
+            {
+                auto d = bytes.value<std::uint8_t>();
+                if(d > std::uint8_t(util::Direction::NorthWest)) return false;
+                f = util::Direction(d);
+            }
+            return bytes.ok() && bytes.remaining() == 0;
+        }
+    }
+}
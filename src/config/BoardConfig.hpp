@@ -2,66 +2,66 @@
 #define ChessPlusPlus_Config_BoardConfigurationManagerClass_HeaderPlusPlus
 
 #include "Configuration.hpp"
-#include "ResourcesConfig.hpp"
+#include "BoardGeometry.hpp"
 #include "util/Position.hpp"
+#include "util/Interned.hpp"
 
 #include <string>
 #include <cstdint>
 #include <utility>
+#include <vector>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <mutex>
 
 namespace chesspp
 {
     namespace config
     {
+        /**
+         * The board's size, initial layout and metadata from board.json,
+         * and optionally the textures of its pieces from resources.json.
+         * What is resolved from board.json is cached with it, so that it
+         * is only resolved again when the file changes. Without textures
+         * nothing here needs a display, so the rules can run headless.
+         */
         class BoardConfig : public Configuration
         {
         public:
-            using BoardSize_t = std::uint8_t;
+            using BoardSize_t = BoardGeometry::BoardSize_t;
             using CellSize_t = std::uint16_t;
             using Position_t = util::Position<BoardSize_t>; //Position type is based on Board Size type
-            using PieceClass_t = std::string;
-            using SuitClass_t = std::string;
+            class PieceClassTag;
+            class SuitClassTag;
+            using PieceClass_t = util::Interned<PieceClassTag>;
+            using SuitClass_t = util::Interned<SuitClassTag>;
             using Layout_t = std::map<Position_t, std::pair<PieceClass_t, SuitClass_t>>;
             using Textures_t = std::map<BoardConfig::SuitClass_t, std::map<BoardConfig::PieceClass_t, std::string>>;
+            using Suits_t = std::set<SuitClass_t>;
         private:
             BoardSize_t board_width, board_height;
             CellSize_t cell_width, cell_height;
+            BoardGeometry board_geometry; //after the board size
             Layout_t layout;
+            Suits_t suit_classes; //of the initial layout
             Textures_t textures;
+            std::vector<util::Direction> facings; //by tile, row by row
+            std::map<SuitClass_t, util::Direction> suit_facings; //of the first tile of each suit's initial layout with one
+            std::unordered_map<std::uint64_t, std::string const *> texture_ids; //by suit and class id
+            std::vector<std::string> piece_plugins;
+            mutable std::once_flag piece_plugins_loaded;
 
-        public:
-            BoardConfig(ResourcesConfig &res)
-            : Configuration{"config/chesspp/board.json"}
-            , board_width  {reader()["board"]["width"]      }
-            , board_height {reader()["board"]["height"]     }
-            , cell_width   {reader()["board"]["cell width"] }
-            , cell_height  {reader()["board"]["cell height"]}
-            {
-                auto pieces = reader()["board"]["pieces"];
-                auto suits  = reader()["board"]["suits"];
-                for(BoardSize_t r = 0; r < board_height; ++r)
-                {
-                    for(BoardSize_t c = 0; c < board_width; ++c)
-                    {
-                        auto piece = pieces[r][c];
-                        auto suit  = suits [r][c];
-                        if(piece.type() != json_null) //it is OK if suit is null
-                        {
-                            layout[{c, r}] = std::make_pair<PieceClass_t, SuitClass_t>(piece, suit);
-                        }
-                    }
-                }
+            void resolve();
+            std::string compileResolved() const;
+            bool loadResolved(std::string const &data);
+            void resolveTextures(Configuration &res);
 
-                auto const &tex = res.setting("board", "pieces");
-                for(auto const &suit : tex.object())
-                {
-                    for(auto const &piece : suit.second.object())
-                    {
-                        textures[suit.first][piece.first] = std::string(Textures_t::mapped_type::mapped_type(piece.second));
-                    }
-                }
-            }
+        public:
+            //Without textures, for running the rules headless
+            explicit BoardConfig(std::string const &path = "config/chesspp/board.json");
+            //With the textures of the "board", "pieces" setting of res
+            BoardConfig(Configuration &res, std::string const &path = "config/chesspp/board.json");
             virtual ~BoardConfig() = default;
 
             BoardSize_t       boardWidth   () const noexcept { return board_width;  }
@@ -69,7 +69,39 @@ namespace chesspp
             Layout_t const   &initialLayout() const noexcept { return layout;       }
             CellSize_t        cellWidth    () const noexcept { return cell_width;   }
             CellSize_t        cellHeight   () const noexcept { return cell_height;  }
+            //The suits that have pieces in the initial layout, in the order of their turns
+            Suits_t    const &suits        () const noexcept { return suit_classes; }
+            //Empty when constructed without textures
             Textures_t const &texturePaths () const noexcept { return textures;     }
+            //The texture of a piece class in a suit, throws std::out_of_range if there is none
+            std::string const &texture(SuitClass_t const &s, PieceClass_t const &c) const
+            {
+                return *texture_ids.at(std::uint64_t(s.id()) << 32 | c.id());
+            }
+            //Absolute paths of the shared libraries adding piece classes, see piece/PluginAbi.hpp
+            std::vector<std::string> const &piecePlugins() const noexcept { return piece_plugins; }
+            //For the board, which loads them with the first board of this configuration
+            std::once_flag &piecePluginsLoaded() const noexcept { return piece_plugins_loaded; }
+            //Precomputed rays and leaps for the board size
+            BoardGeometry const &geometry() const noexcept { return board_geometry; }
+            //The direction a pawn at p faces, from the "pawn facing" metadata
+            util::Direction facing(Position_t const &p) const noexcept
+            {
+                if(p.x >= board_width || p.y >= board_height)
+                {
+                    return util::Direction::None;
+                }
+                return facings[std::size_t(p.y)*board_width + p.x];
+            }
+            //The same, or for tiles without a facing, the direction pawns of the suit face
+            //in the initial layout, so pawns can be set up on other tiles
+            util::Direction facing(Position_t const &p, SuitClass_t const &s) const noexcept
+            {
+                auto f = facing(p);
+                if(f != util::Direction::None) return f;
+                auto it = suit_facings.find(s);
+                return it != suit_facings.end()? it->second : util::Direction::None;
+            }
 
             template<typename... Args>
             util::JsonReader::NestedValue metadata(Args const &... path) const
@@ -0,0 +1,55 @@
+#include "BoardGeometry.hpp"
+
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace config
+    {
+        constexpr BoardGeometry::Offset_t BoardGeometry::KingOffsets[];
+        constexpr BoardGeometry::Offset_t BoardGeometry::KnightOffsets[];
+        constexpr BoardGeometry::Offset_t BoardGeometry::ArcherOffsets[];
+
+        BoardGeometry::BoardGeometry(BoardSize_t w, BoardSize_t h)
+        : width{w}
+        , height{h}
+        {
+            using Dir = util::Direction;
+            starts.reserve(std::size_t(w)*h*Tables + 1);
+            auto leaps = [&](Position_t const &pos, Offset_t const *first, Offset_t const *last)
+            {
+                starts.push_back(std::uint32_t(tiles.size()));
+                for(; first != last; ++first)
+                {
+                    Position_t t = Position_t(pos).move(first->x, first->y);
+                    if(valid(t)) tiles.push_back(t);
+                }
+            };
+            for(BoardSize_t y = 0; y < h; ++y)
+            {
+                for(BoardSize_t x = 0; x < w; ++x)
+                {
+                    Position_t pos {x, y};
+                    for(Dir d : {Dir::North, Dir::NorthEast, Dir::East, Dir::SouthEast
+                                ,Dir::South, Dir::SouthWest, Dir::West, Dir::NorthWest})
+                    {
+                        //as far as the nearer edge in each axis the ray moves along
+                        std::size_t n = std::size_t(-1);
+                        if(util::DeltaX(d) != 0) n = std::min<std::size_t>(n, util::DeltaX(d) > 0? w - 1 - x : x);
+                        if(util::DeltaY(d) != 0) n = std::min<std::size_t>(n, util::DeltaY(d) > 0? h - 1 - y : y);
+                        starts.push_back(std::uint32_t(tiles.size()));
+                        tiles.resize(tiles.size() + n);
+                        pos.ray(d, n, tiles.end() - std::ptrdiff_t(n));
+                    }
+                    leaps(pos, std::begin(KingOffsets), std::end(KingOffsets));
+                    leaps(pos, std::begin(KnightOffsets), std::end(KnightOffsets));
+                    leaps(pos, std::begin(ArcherOffsets), std::end(ArcherOffsets));
+                }
+            }
+            starts.push_back(std::uint32_t(tiles.size()));
+            tiles.shrink_to_fit();
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef ChessPlusPlus_Config_BoardGeometryClass_HeaderPlusPlus
+#define ChessPlusPlus_Config_BoardGeometryClass_HeaderPlusPlus
+
+#include "util/Position.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace config
+    {
+        /**
+         * Tables of the tiles reachable from every tile of a board of
+         * fixed dimensions: the ray in each of the eight directions up
+         * to the edge, and the tiles a king, knight or archer reaches.
+         * Every table holds only valid tiles, nearest first, and all
+         * of them share one contiguous array, so move generators can
+         * walk them without bounds checks or Position::move().
+         */
+        class BoardGeometry
+        {
+        public:
+            using BoardSize_t = std::uint8_t;
+            using Position_t = util::Position<BoardSize_t>;
+            using Offset_t = util::Position<signed>;
+
+            static constexpr Offset_t KingOffsets[] = {Offset_t( 0, -1)
+                                                      ,Offset_t( 1, -1)
+                                                      ,Offset_t( 1,  0)
+                                                      ,Offset_t( 1,  1)
+                                                      ,Offset_t( 0,  1)
+                                                      ,Offset_t(-1,  1)
+                                                      ,Offset_t(-1,  0)
+                                                      ,Offset_t(-1, -1)};
+            static constexpr Offset_t KnightOffsets[] = {Offset_t( 1, -2)
+                                                        ,Offset_t( 2, -1)
+                                                        ,Offset_t( 2,  1)
+                                                        ,Offset_t( 1,  2)
+                                                        ,Offset_t(-1,  2)
+                                                        ,Offset_t(-2,  1)
+                                                        ,Offset_t(-2, -1)
+                                                        ,Offset_t(-1, -2)};
+            static constexpr Offset_t ArcherOffsets[] = {Offset_t( 1, -2)
+                                                        ,Offset_t( 2, -1)
+                                                        ,Offset_t( 2,  1)
+                                                        ,Offset_t( 1,  2)
+                                                        ,Offset_t(-1,  2)
+                                                        ,Offset_t(-2,  1)
+                                                        ,Offset_t(-2, -1)
+                                                        ,Offset_t(-1, -2)
+                                                        ,Offset_t( 0,  2)
+                                                        ,Offset_t(-2,  0)
+                                                        ,Offset_t( 2,  0)
+                                                        ,Offset_t( 0, -2)};
+
+            //A table of tiles within the shared array
+            class Span
+            {
+                Position_t const *first, *last;
+
+            public:
+                Span(Position_t const *f, Position_t const *l) noexcept
+                : first(f) //can't use {}
+                , last(l)  //can't use {}
+                {
+                }
+
+                Position_t const *begin() const noexcept { return first;          }
+                Position_t const *end  () const noexcept { return last;           }
+                std::size_t       size () const noexcept { return last - first;   }
+                bool              empty() const noexcept { return first == last;  }
+                Position_t const &operator[](std::size_t i) const noexcept { return first[i]; }
+            };
+
+        private:
+            enum Table : std::size_t
+            {
+                Rays = 0,    //one per direction, North first
+                King = 8,
+                Knight,
+                Archer,
+                Tables
+            };
+            BoardSize_t width, height;
+            std::vector<Position_t> tiles;    //every table, one after another
+            std::vector<std::uint32_t> starts; //by tile then table, plus the end
+
+            std::size_t key(Position_t const &pos, std::size_t table) const noexcept
+            {
+                return (std::size_t(pos.y)*width + pos.x)*Tables + table;
+            }
+            Span table(Position_t const &pos, std::size_t t) const noexcept
+            {
+                auto k = key(pos, t);
+                return Span(tiles.data() + starts[k], tiles.data() + starts[k + 1]);
+            }
+
+        public:
+            BoardGeometry(BoardSize_t width, BoardSize_t height);
+
+            bool valid(Position_t const &pos) const noexcept
+            {
+                return pos.x < width && pos.y < height;
+            }
+
+            //The tiles from pos to the edge in the direction, pos must be valid and d not None
+            Span ray(Position_t const &pos, util::Direction d) const noexcept
+            {
+                return table(pos, std::size_t(d) - std::size_t(util::Direction::North));
+            }
+            //The tile next to pos in the direction, or nothing past the edge
+            Span step(Position_t const &pos, util::Direction d) const noexcept
+            {
+                Span r = ray(pos, d);
+                return Span(r.begin(), r.begin() + (r.empty()? 0 : 1));
+            }
+            Span king(Position_t const &pos) const noexcept
+            {
+                return table(pos, King);
+            }
+            Span knight(Position_t const &pos) const noexcept
+            {
+                return table(pos, Knight);
+            }
+            Span archer(Position_t const &pos) const noexcept
+            {
+                return table(pos, Archer);
+            }
+        };
+    }
+}
+
+#endif
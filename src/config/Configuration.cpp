@@ -1,4 +1,6 @@
 #include "Configuration.hpp"
+#include "util/MappedFile.hpp"
+#include "util/Serialization.hpp"
 
 #include <iostream>
 
@@ -54,5 +56,100 @@ namespace chesspp
 
             return ret;
         }
+
+        namespace
+        {
+            static constexpr char CacheMagic[8] = {'C', 'P', 'P', 'C', 'F', 'G', '0', '1'};
+
+            //64-bit FNV-1a
+            static std::uint64_t hash(util::MappedFile const &file) noexcept
+            {
+                std::uint64_t h = 0xCBF29CE484222325ull;
+                auto text = static_cast<unsigned char const *>(file.data());
+                for(std::size_t i = 0; i < file.size(); ++i)
+                {
+                    h = (h ^ text[i])*0x100000001B3ull;
+                }
+                return h;
+            }
+        }
+
+        util::JsonReader Configuration::open(std::string const &configFile, bool cache, std::uint64_t depends)
+        {
+            std::string path = validateConfigFile(configFile);
+            util::MappedFile text {path};
+            if(!text.valid())
+            {
+                throw Exception("Configuration cannot open \"" + path + "\"");
+            }
+            source_hash = hash(text);
+            if(!cache)
+            {
+                return util::JsonReader{text};
+            }
+
+            cache_path = path + ".cache";
+            cache_key = source_hash ^ (depends*0x9E3779B97F4A7C15ull + 1);
+            util::MappedFile file {cache_path};
+            if(file.valid())
+            {
+                util::ByteReader bytes {file.data(), file.size()};
+                char const *magic = bytes.take(sizeof(CacheMagic));
+                auto key   = bytes.value<std::uint64_t>();
+                auto tree  = bytes.value<std::uint64_t>();
+                auto extra = bytes.value<std::uint64_t>();
+                if(magic && std::memcmp(magic, CacheMagic, sizeof(CacheMagic)) == 0 && key == cache_key
+                && bytes.remaining() == tree + extra)
+                {
+                    try
+                    {
+                        auto reader = util::JsonReader::load(bytes.take(tree), tree);
+                        cached_extra.assign(bytes.take(extra), extra);
+                        from_cache = true;
+                        return reader;
+                    }
+                    catch(Exception &e)
+                    {
+                        std::cerr << "Configuration ignored the cache \"" << cache_path << "\": " << e.what() << std::endl;
+                    }
+                }
+            }
+            std::clog << "Configuration parsing \"" << path << "\", there is no up to date cache" << std::endl;
+            return util::JsonReader{text};
+        }
+
+        void Configuration::store(std::string const &extra)
+        {
+            if(cache_path.empty())
+            {
+                return;
+            }
+            std::string tree = reader.compile();
+            std::string out {CacheMagic, sizeof(CacheMagic)};
+            util::ByteWriter bytes {out};
+            bytes.value(cache_key);
+            bytes.value(std::uint64_t(tree.size()));
+            bytes.value(std::uint64_t(extra.size()));
+            out += tree;
+            out += extra;
+
+            //write beside the cache and rename, so a cache is never seen half written
+            std::string temporary = cache_path + ".tmp";
+            {
+                std::ofstream file {temporary, std::ios::binary | std::ios::trunc};
+                if(!file.write(out.data(), std::streamsize(out.size())))
+                {
+                    std::cerr << "Configuration could not write the cache \"" << cache_path << "\"" << std::endl;
+                    return;
+                }
+            }
+            boost::system::error_code error;
+            boost::filesystem::rename(temporary, cache_path, error);
+            if(error)
+            {
+                std::cerr << "Configuration could not write the cache \"" << cache_path << "\": " << error.message() << std::endl;
+                boost::filesystem::remove(temporary, error);
+            }
+        }
     }
 }
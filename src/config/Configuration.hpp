@@ -14,14 +14,38 @@ namespace chesspp
 {
     namespace config
     {
+        /**
+         * A JSON configuration file. Configurations that are costly to
+         * read can ask for a cache: the parsed values are then compiled
+         * to a binary file beside the JSON, with whatever the subclass
+         * derived from them, and loaded from there on later runs until
+         * the JSON, or the configurations it depends on, change.
+         */
         class Configuration
         {
         protected:
             static std::string executablePath();
 
             std::string res_path;
+            std::uint64_t source_hash = 0; //of the JSON text
+            std::string cache_path;        //empty for no cache
+            std::uint64_t cache_key = 0;
+            std::string cached_extra;      //what the subclass stored with the cache
+            bool from_cache = false;
             util::JsonReader reader;
 
+            //Whether the values were loaded from the cache, and cachedExtra() is what store() was given
+            bool cached() const noexcept
+            {
+                return from_cache;
+            }
+            std::string const &cachedExtra() const noexcept
+            {
+                return cached_extra;
+            }
+            //Writes the cache, logging rather than throwing if it can't
+            void store(std::string const &extra = std::string());
+
         private:
             std::string validateConfigFile(std::string const &configFile)
             {
@@ -43,13 +67,26 @@ namespace chesspp
                 return res_path + configFile;
             }
 
+            util::JsonReader open(std::string const &configFile, bool cache, std::uint64_t depends);
+
         public:
             Configuration(std::string const &configFile) noexcept(false)
-            : reader{std::ifstream(validateConfigFile(configFile))}
+            : reader{open(configFile, false, 0)}
+            {
+            }
+            //Uses a cache, which is also invalidated when depends changes
+            Configuration(std::string const &configFile, std::uint64_t depends) noexcept(false)
+            : reader{open(configFile, true, depends)}
             {
             }
             virtual ~Configuration() = default;
 
+            //For configurations derived from this one to depend on
+            std::uint64_t sourceHash() const noexcept
+            {
+                return source_hash;
+            }
+
             template<typename... Path>
             auto setting(Path const &... path)
             -> decltype(reader.navigate(path...))
@@ -0,0 +1,67 @@
+#ifndef ChessPlusPlus_Config_EvaluationConfigurationManagerClass_HeaderPlusPlus
+#define ChessPlusPlus_Config_EvaluationConfigurationManagerClass_HeaderPlusPlus
+
+#include "Configuration.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <map>
+
+namespace chesspp
+{
+    namespace config
+    {
+        /**
+         * Piece values and piece-square tables for the engine's
+         * evaluation, keyed by piece class. Tables are arrays of rows
+         * as seen by the suit at the bottom of the board, the row it
+         * advances towards first, and may be of any size; the
+         * evaluation stretches them to the board.
+         */
+        class EvaluationConfig : public Configuration
+        {
+        public:
+            using PieceClass_t = std::string;
+            using Score_t = std::int32_t;
+            using Values_t = std::map<PieceClass_t, Score_t>;
+            using Table_t = std::vector<std::vector<Score_t>>;
+            using Tables_t = std::map<PieceClass_t, Table_t>;
+        private:
+            Values_t piece_values;
+            Tables_t piece_tables;
+
+        public:
+            EvaluationConfig(std::string const &path = "config/chesspp/evaluation.json")
+            : Configuration{path}
+            {
+                for(auto const &v : reader()["evaluation"]["values"].object())
+                {
+                    if(v.second.type() == json_integer)
+                    {
+                        piece_values[v.first] = Score_t(v.second);
+                    }
+                }
+                for(auto const &t : reader()["evaluation"]["tables"].object())
+                {
+                    auto &table = piece_tables[t.first];
+                    for(std::size_t r = 0; r < t.second.length(); ++r)
+                    {
+                        auto row = t.second[r];
+                        table.emplace_back();
+                        for(std::size_t c = 0; c < row.length(); ++c)
+                        {
+                            table.back().push_back(Score_t(row[c]));
+                        }
+                    }
+                }
+            }
+            virtual ~EvaluationConfig() = default;
+
+            Values_t const &values() const noexcept { return piece_values; }
+            Tables_t const &tables() const noexcept { return piece_tables; }
+        };
+    }
+}
+
+#endif
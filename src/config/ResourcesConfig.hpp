@@ -14,9 +14,13 @@ namespace chesspp
 
         public:
             ResourcesConfig()
-            : Configuration{"config/chesspp/resources.json"}
+            : Configuration{"config/chesspp/resources.json", 0}
             , res{*this}
             {
+                if(!cached())
+                {
+                    store();
+                }
             }
 
             res::ResourceManager &resources() noexcept
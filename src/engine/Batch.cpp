@@ -0,0 +1,136 @@
+#include "Batch.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        namespace
+        {
+            using Clock_t = std::chrono::steady_clock;
+        }
+
+        Batch::Batch(Board &b, Players_t const &players_, std::size_t threads_)
+        : board(b)          //can't use {}
+        , players(players_) //can't use {}
+        , threads(threads_? threads_ : std::max(1u, std::thread::hardware_concurrency()))
+        {
+        }
+
+        template<typename Work>
+        Batch::Report Batch::split(Moves_t const &roots, Work work)
+        {
+            Report report;
+            report.workers.resize(threads);
+            //copies are made before any thread starts, since they replay the board
+            std::vector<std::unique_ptr<Board>> boards;
+            for(std::size_t i = 0; i < threads; ++i)
+            {
+                boards.emplace_back(new Board(board));
+            }
+
+            std::atomic<std::size_t> claimed {0};
+            std::atomic<bool> failed {false};
+            auto start = Clock_t::now();
+            std::vector<std::thread> pool;
+            for(std::size_t i = 0; i < threads; ++i)
+            {
+                pool.emplace_back([&, i]
+                {
+                    Worker &w = report.workers[i];
+                    Board &b = *boards[i];
+                    auto begin = Clock_t::now();
+                    for(std::size_t r; (r = claimed++) < roots.size(); )
+                    {
+                        if(!MoveGenerator::make(b, roots[r]))
+                        {
+                            failed = true;
+                            continue;
+                        }
+                        if(!work(b, r, w)) failed = true;
+                        b.unmakeMove();
+                        ++w.roots;
+                    }
+                    w.seconds = std::chrono::duration<double>(Clock_t::now() - begin).count();
+                });
+            }
+            for(auto &t : pool)
+            {
+                t.join();
+            }
+            report.seconds = std::chrono::duration<double>(Clock_t::now() - start).count();
+            report.failed = failed;
+            for(auto const &w : report.workers)
+            {
+                report.nodes += w.nodes;
+            }
+            return report;
+        }
+
+        Batch::Report Batch::perft(std::size_t turn, unsigned depth)
+        {
+            if(depth == 0)
+            {
+                Report report;
+                report.nodes = 1;
+                return report;
+            }
+
+            Moves_t roots;
+            MoveGenerator{}(board, players[turn], roots);
+            std::size_t next = (turn + 1)%players.size();
+            return split(roots, [&](Board &b, std::size_t, Worker &w)
+            {
+                Perft count {b, players};
+                w.nodes += count(next, depth - 1);
+                return !count.failed;
+            });
+        }
+
+        Batch::Report Batch::evaluate(std::size_t turn, unsigned depth, Evaluation const &evaluation, TranspositionTable &table, Moves_t &roots, Scores_t &scores)
+        {
+            MoveGenerator{}(board, players[turn], roots);
+            scores.assign(roots.size(), 0);
+            std::size_t next = (turn + 1)%players.size();
+            return split(roots, [&](Board &b, std::size_t r, Worker &w)
+            {
+                Search::Result result;
+                if(depth > 1)
+                {
+                    Search search {b, players, table, evaluation};
+                    Search::Limits limits;
+                    limits.depth = depth - 1;
+                    limits.time = std::chrono::milliseconds::zero();
+                    result = search.run(next, limits);
+                }
+                if(result.found)
+                {
+                    scores[r] = -result.score;
+                    w.nodes += result.nodes;
+                }
+                else
+                {
+                    //the search found no moves, or did not look, so see whether the move mates or stalemates
+                    MoveGenerator generate;
+                    Moves_t replies;
+                    generate(b, players[next], replies);
+                    if(replies.empty())
+                    {
+                        scores[r] = generate.inCheck()? Search::Mate - 1 : 0;
+                    }
+                    else
+                    {
+                        scores[r] = evaluation.evaluate(b, players[turn]);
+                    }
+                    ++w.nodes;
+                }
+                return true;
+            });
+        }
+    }
+}
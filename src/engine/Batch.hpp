@@ -0,0 +1,65 @@
+#ifndef ChessPlusPlus_Engine_BatchClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_BatchClass_HeaderPlusPlus
+
+#include "Perft.hpp"
+#include "Search.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Splits perft and evaluation at the root move list across
+         * threads, each with its own copy of the board. Threads take
+         * the next unclaimed root move until none are left, and the
+         * report keeps what each thread did for sizing machines.
+         */
+        class Batch
+        {
+        public:
+            using Nodes_t = Perft::Nodes_t;
+            class Worker
+            {
+            public:
+                Nodes_t nodes = 0;
+                std::size_t roots = 0; //root moves taken
+                double seconds = 0;    //busy time
+            };
+            class Report
+            {
+            public:
+                Nodes_t nodes = 0;
+                double seconds = 0; //wall time
+                bool failed = false;
+                std::vector<Worker> workers;
+            };
+            using Scores_t = std::vector<Search::Score_t>;
+
+        private:
+            Board &board;
+            Players_t const &players;
+            std::size_t threads;
+
+            template<typename Work>
+            Report split(Moves_t const &roots, Work work);
+
+        public:
+            //Zero threads uses one per core
+            Batch(Board &b, Players_t const &players, std::size_t threads);
+
+            std::size_t threadCount() const noexcept
+            {
+                return threads;
+            }
+            Report perft(std::size_t turn, unsigned depth);
+            //Scores every root move, in generation order, with a search of depth - 1 after it.
+            //The evaluation must be prepared and the table aged by the caller.
+            Report evaluate(std::size_t turn, unsigned depth, Evaluation const &evaluation, TranspositionTable &table, Moves_t &roots, Scores_t &scores);
+        };
+    }
+}
+
+#endif
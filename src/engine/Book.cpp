@@ -0,0 +1,103 @@
+#include "Book.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        namespace
+        {
+            static char const Magic[8] = {'C', 'P', 'P', 'B', 'O', 'O', 'K', '1'};
+            class Header
+            {
+            public:
+                char magic[8];
+                std::uint32_t count;
+                std::uint32_t reserved;
+            };
+            static_assert(sizeof(Header) == 16, "book headers are stored as they are in memory");
+        }
+
+        Book::Book(std::string const &path)
+        : file{path}
+        {
+            if(!file.valid() || file.size() < sizeof(Header)) return;
+            Header const &h = *static_cast<Header const *>(file.data());
+            if(std::memcmp(h.magic, Magic, sizeof(Magic)) != 0 || (file.size() - sizeof(Header))/sizeof(Entry) < h.count)
+            {
+                return;
+            }
+            entries = reinterpret_cast<Entry const *>(static_cast<char const *>(file.data()) + sizeof(Header));
+            count = h.count;
+        }
+
+        std::pair<Book::Entry const *, Book::Entry const *> Book::find(Key_t key) const noexcept
+        {
+            auto first = std::lower_bound(entries, entries + count, key, [](Entry const &e, Key_t k)
+            {
+                return e.key < k;
+            });
+            auto last = first;
+            while(last != entries + count && last->key == key) ++last;
+            return {first, last};
+        }
+
+        bool Book::choose(Key_t key, double pick, std::uint32_t &move) const noexcept
+        {
+            auto found = find(key);
+            std::uint64_t total = 0;
+            for(auto e = found.first; e != found.second; ++e)
+            {
+                total += e->weight;
+            }
+            if(total == 0) return false;
+            auto target = std::uint64_t(pick*total);
+            for(auto e = found.first; e != found.second; ++e)
+            {
+                if(target < e->weight)
+                {
+                    move = e->move;
+                    return true;
+                }
+                target -= e->weight;
+            }
+            move = found.first->move;
+            return true;
+        }
+
+        bool Book::write(std::string const &path, Entries_t entries)
+        {
+            std::sort(entries.begin(), entries.end(), [](Entry const &a, Entry const &b)
+            {
+                return a.key != b.key? a.key < b.key : a.move < b.move;
+            });
+            Entries_t merged;
+            for(auto const &e : entries)
+            {
+                if(!merged.empty() && merged.back().key == e.key && merged.back().move == e.move)
+                {
+                    merged.back().weight = std::uint16_t(std::min<std::uint32_t>(0xFFFFu, std::uint32_t(merged.back().weight) + e.weight));
+                    continue;
+                }
+                merged.push_back(e);
+                merged.back().reserved = 0;
+            }
+            std::stable_sort(merged.begin(), merged.end(), [](Entry const &a, Entry const &b)
+            {
+                return a.key != b.key? a.key < b.key : a.weight > b.weight;
+            });
+
+            std::ofstream out {path, std::ios::binary};
+            Header h;
+            std::memcpy(h.magic, Magic, sizeof(Magic));
+            h.count = std::uint32_t(merged.size());
+            h.reserved = 0;
+            out.write(reinterpret_cast<char const *>(&h), sizeof(h));
+            out.write(reinterpret_cast<char const *>(merged.data()), std::streamsize(merged.size()*sizeof(Entry)));
+            return bool(out);
+        }
+    }
+}
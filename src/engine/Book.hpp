@@ -0,0 +1,71 @@
+#ifndef ChessPlusPlus_Engine_OpeningBookClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_OpeningBookClass_HeaderPlusPlus
+
+#include "board/Zobrist.hpp"
+#include "util/MappedFile.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Opening book read in place from a memory-mapped file, so
+         * opening it costs nothing however large it is. The file is a
+         * 16 byte header, the magic "CPPBOOK1" and the number of
+         * entries, followed by the entries sorted by key and then by
+         * descending weight, all in little-endian byte order. Keys are
+         * Board::hash(turn), which is the same for every run, and moves
+         * are Move::code(). Write books with write() or chesspp_book.
+         */
+        class Book
+        {
+        public:
+            using Key_t = board::Zobrist::Key_t;
+            class Entry
+            {
+            public:
+                Key_t key;
+                std::uint32_t move;
+                std::uint16_t weight;   //how often the move was played, at most 65535
+                std::uint16_t reserved;
+            };
+            using Entries_t = std::vector<Entry>;
+            static_assert(sizeof(Entry) == 16, "book entries are stored as they are in memory");
+
+        private:
+            util::MappedFile file;
+            Entry const *entries = nullptr;
+            std::size_t count = 0;
+
+        public:
+            Book() = default;
+            //An empty book if the file can't be mapped or is not a book
+            Book(std::string const &path);
+
+            bool empty() const noexcept
+            {
+                return count == 0;
+            }
+            std::size_t size() const noexcept
+            {
+                return count;
+            }
+            //The entries of a position, most played first
+            std::pair<Entry const *, Entry const *> find(Key_t key) const noexcept;
+            //Picks a move of the position with a chance by weight, for pick in [0, 1)
+            bool choose(Key_t key, double pick, std::uint32_t &move) const noexcept;
+
+            //Sorts the entries, adds up the weights of duplicates and writes them,
+            //returns false if the file could not be written
+            static bool write(std::string const &path, Entries_t entries);
+        };
+    }
+}
+
+#endif
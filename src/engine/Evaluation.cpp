@@ -0,0 +1,203 @@
+#include "Evaluation.hpp"
+
+#include <algorithm>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        constexpr Evaluation::Score_t Evaluation::DefaultValue;
+
+        Evaluation::Evaluation(config::BoardConfig const &conf)
+        : config(conf) //can't use {}
+        , values
+          {
+              {"Pawn",     100},
+              {"Knight",   320},
+              {"Bishop",   330},
+              {"Archer",   350},
+              {"Rook",     500},
+              {"Queen",    900},
+              {"King",   20000}
+          }
+        {
+            for(auto const &v : config.metadata("piece values").object())
+            {
+                if(v.second.type() == json_integer)
+                {
+                    values[v.first] = Score_t(v.second);
+                }
+            }
+            orient(config);
+        }
+        Evaluation::Evaluation(config::BoardConfig const &conf, config::EvaluationConfig const &evaluation)
+        : Evaluation(conf)
+        {
+            for(auto const &v : evaluation.values())
+            {
+                if(config.metadata("piece values", v.first).type() != json_integer)
+                {
+                    values[v.first] = v.second;
+                }
+            }
+
+            //stretch each table to the board
+            std::size_t const w = config.boardWidth(), h = config.boardHeight();
+            for(auto const &t : evaluation.tables())
+            {
+                if(t.second.empty()) continue;
+                Table_t &table = tables[t.first];
+                table.assign(w*h, 0);
+                for(std::size_t y = 0; y < h; ++y)
+                {
+                    auto const &row = t.second[(2*y + 1)*t.second.size()/(2*h)]; //nearest by tile centres
+                    if(row.empty()) continue;
+                    for(std::size_t x = 0; x < w; ++x)
+                    {
+                        table[y*w + x] = row[(2*x + 1)*row.size()/(2*w)];
+                    }
+                }
+            }
+        }
+
+        void Evaluation::orient(config::BoardConfig const &config)
+        {
+            std::map<Suit, std::pair<std::size_t, std::size_t>> rows; //sum of rows, pieces
+            for(auto const &slot : config.initialLayout())
+            {
+                auto &r = rows[slot.second.second];
+                r.first += slot.first.y;
+                ++r.second;
+            }
+            for(auto const &r : rows)
+            {
+                flipped[r.first] = 2*r.second.first < r.second.second*(config.boardHeight() - 1);
+            }
+            suits.assign(config.suits().begin(), config.suits().end());
+        }
+
+        Evaluation::Score_t Evaluation::value(config::BoardConfig::PieceClass_t const &c) const
+        {
+            auto it = values.find(c);
+            return it != values.end()? it->second : DefaultValue;
+        }
+
+        void Evaluation::prepare(board::Board const &b)
+        {
+            std::size_t const w = config.boardWidth(), h = config.boardHeight();
+            std::map<std::pair<config::BoardConfig::PieceClass_t, bool>, std::uint32_t> placed;
+            squares.clear();
+            by_index.clear();
+            offsets.clear();
+            owners.clear();
+            for(auto it = b.begin(); it != b.end(); ++it)
+            {
+                auto const &p = **it;
+                if(by_index.size() <= p.index)
+                {
+                    by_index.resize(p.index + 1, 0);
+                    offsets.resize(p.index + 1, 0);
+                    owners.resize(p.index + 1, 0);
+                }
+                by_index[p.index] = value(p.pclass);
+                owners[p.index] = std::uint8_t(std::find(suits.begin(), suits.end(), p.suit) - suits.begin());
+
+                auto t = tables.find(p.pclass);
+                if(t == tables.end())
+                {
+                    offsets[p.index] = std::uint32_t(-1); //the zero table, once its place is known
+                    continue;
+                }
+                auto key = std::make_pair(p.pclass, flipped[p.suit]);
+                auto at = placed.find(key);
+                if(at == placed.end())
+                {
+                    at = placed.emplace(key, std::uint32_t(squares.size())).first;
+                    for(std::size_t y = 0; y < h; ++y)
+                    {
+                        std::size_t row = key.second? h - 1 - y : y;
+                        squares.insert(squares.end(), t->second.begin() + row*w, t->second.begin() + (row + 1)*w);
+                    }
+                }
+                offsets[p.index] = at->second;
+            }
+            std::uint32_t zero = std::uint32_t(squares.size());
+            squares.resize(squares.size() + w*h, 0);
+            std::replace(offsets.begin(), offsets.end(), std::uint32_t(-1), zero);
+        }
+
+        Evaluation::Score_t Evaluation::evaluate(board::Board const &b, board::Board::Suit const &turn) const noexcept
+        {
+            Score_t score = 0;
+            for(auto it = b.begin(); it != b.end(); ++it)
+            {
+                Score_t v = worth((*it)->index, (*it)->pos);
+                score += ((*it)->suit == turn)? v : -v;
+            }
+            return score;
+        }
+
+        Evaluation::Accumulator::Accumulator(Evaluation const &evaluation_, std::vector<Suit> const &players)
+        : evaluation(evaluation_) //can't use {}
+        , totals(evaluation_.suits.size() + 1, 0) //don't use {}
+        {
+            for(auto const &s : players)
+            {
+                numbers.push_back(std::uint8_t(std::find(evaluation.suits.begin(), evaluation.suits.end(), s) - evaluation.suits.begin()));
+            }
+        }
+
+        void Evaluation::Accumulator::reset(board::Board const &b)
+        {
+            worths.assign(evaluation.by_index.size(), 0);
+            std::fill(totals.begin(), totals.end(), 0);
+            saved.clear();
+            marks.clear();
+            for(auto it = b.begin(); it != b.end(); ++it)
+            {
+                worths[(*it)->index] = evaluation.worth((*it)->index, (*it)->pos);
+            }
+            //a flat loop over the arrays, suits without pieces stay 0
+            for(std::size_t i = 0; i < worths.size(); ++i)
+            {
+                totals[evaluation.owners[i]] += worths[i];
+            }
+            all = 0;
+            for(auto t : totals)
+            {
+                all += t;
+            }
+        }
+
+        void Evaluation::Accumulator::set(PieceIndex_t piece, Score_t worth) noexcept
+        {
+            Score_t change = worth - worths[piece];
+            worths[piece] = worth;
+            totals[evaluation.owners[piece]] += change;
+            all += change;
+        }
+
+        void Evaluation::Accumulator::make(board::Board const &b)
+        {
+            marks.push_back(saved.size());
+            auto c = b.lastChange();
+            for(auto piece : {c.moved, c.captured, c.carried})
+            {
+                if(piece == board::Board::NoPiece) continue;
+                saved.push_back(Saved{piece, worths[piece]});
+                auto it = b.piece(piece);
+                set(piece, it != b.end()? evaluation.worth(piece, (*it)->pos) : 0);
+            }
+        }
+
+        void Evaluation::Accumulator::unmake() noexcept
+        {
+            for(auto i = saved.size(); i-- > marks.back(); )
+            {
+                set(saved[i].piece, saved[i].worth);
+            }
+            saved.resize(marks.back());
+            marks.pop_back();
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef ChessPlusPlus_Engine_EvaluationClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_EvaluationClass_HeaderPlusPlus
+
+#include "board/Board.hpp"
+#include "config/EvaluationConfig.hpp"
+
+#include <map>
+#include <vector>
+#include <cstdint>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Material plus piece-square evaluation. Piece values and tables
+         * come from an EvaluationConfig, with the "piece values" object
+         * in the board metadata taking precedence and defaults for the
+         * standard pieces otherwise. Tables are stretched to the size of
+         * the board and flipped for suits that start in the top half.
+         * What the evaluation needs of each piece is kept by piece index
+         * in separate arrays, so that summing the pieces is a flat loop,
+         * and an Accumulator keeps the sum up to date move by move.
+         */
+        class Evaluation
+        {
+        public:
+            using Score_t = std::int32_t;
+            using Values_t = std::map<config::BoardConfig::PieceClass_t, Score_t>;
+            using Table_t = std::vector<Score_t>; //row-major, one per tile
+
+        private:
+            using PieceIndex_t = board::Board::PieceIndex_t;
+            using Suit = board::Board::Suit;
+
+            config::BoardConfig const &config;
+            Values_t values;
+            std::map<config::BoardConfig::PieceClass_t, Table_t> tables; //as seen by a suit starting at the bottom
+            std::map<Suit, bool> flipped;                                //suits starting in the top half
+            std::vector<Suit> suits;                                     //in sorted order, same as players()
+
+            //cached by piece index for one board
+            std::vector<Score_t> by_index;      //material
+            std::vector<std::uint32_t> offsets; //where the table of the piece starts in squares
+            std::vector<std::uint8_t> owners;   //the suit of the piece, by its place in suits
+            std::vector<Score_t> squares;       //every table in use, oriented for its suit, then a zero table
+
+            std::size_t tile(board::Board::Position_t const &pos) const noexcept
+            {
+                return std::size_t(pos.y)*config.boardWidth() + pos.x;
+            }
+            void orient(config::BoardConfig const &config);
+
+        public:
+            static constexpr Score_t DefaultValue = 300; //for classes without a value
+
+            //Material only
+            Evaluation(config::BoardConfig const &config);
+            Evaluation(config::BoardConfig const &config, config::EvaluationConfig const &evaluation);
+
+            Score_t value(config::BoardConfig::PieceClass_t const &c) const;
+
+            //Caches the values and tables of the pieces of the board, required before evaluate()
+            void prepare(board::Board const &b);
+            Score_t value(PieceIndex_t piece) const noexcept
+            {
+                return by_index[piece];
+            }
+            //What the piece adds to its suit standing at pos
+            Score_t worth(PieceIndex_t piece, board::Board::Position_t const &pos) const noexcept
+            {
+                return by_index[piece] + squares[offsets[piece] + tile(pos)];
+            }
+            //The score of the suit minus the score of every other suit
+            Score_t evaluate(board::Board const &b, board::Board::Suit const &turn) const noexcept;
+
+            /**
+             * Keeps the score of each suit of one board up to date
+             * as moves are made and unmade, instead of summing every
+             * piece in every position evaluated.
+             */
+            class Accumulator
+            {
+                class Saved
+                {
+                public:
+                    PieceIndex_t piece;
+                    Score_t worth; //0 if it was captured
+                };
+
+                Evaluation const &evaluation;
+                std::vector<std::uint8_t> numbers; //by player, the suit's place in the evaluation's suits
+                std::vector<Score_t> worths;       //by piece index, what each piece adds now
+                std::vector<Score_t> totals;       //by suit
+                Score_t all = 0;
+                std::vector<Saved> saved;          //what each make() changed
+                std::vector<std::size_t> marks;    //size of saved before each make()
+
+                void set(PieceIndex_t piece, Score_t worth) noexcept;
+
+            public:
+                Accumulator(Evaluation const &evaluation, std::vector<Suit> const &players);
+
+                //Sums the position of the board, the evaluation must be prepared for it
+                void reset(board::Board const &b);
+                //After each move made on the board
+                void make(board::Board const &b);
+                //After each move unmade on the board
+                void unmake() noexcept;
+
+                //The same as Evaluation::evaluate() for players[turn]
+                Score_t evaluate(std::size_t turn) const noexcept
+                {
+                    return 2*totals[numbers[turn]] - all;
+                }
+            };
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,107 @@
+#include "Fen.hpp"
+#include "Notation.hpp"
+#include "Exception.hpp"
+
+#include <sstream>
+#include <cctype>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        Fen::Fen(config::BoardConfig const &config, std::string const &text)
+        {
+            auto fail = [&](std::string const &why)
+            {
+                return Exception("\"" + text + "\" is not a FEN position of this board: " + why);
+            };
+            std::istringstream in {text};
+            std::string placement, side, castling = "-", en_passant = "-";
+            if(!(in >> placement >> side))
+            {
+                throw fail("it needs at least the pieces and the suit to move");
+            }
+            std::size_t half = 0, full = 1;
+            if(in >> castling >> en_passant >> half >> full)
+            {
+                halfmoves = half;
+                fullmoves = full;
+            }
+
+            std::size_t first = 0;
+            Players_t players = engine::players(config, first);
+            if(players.size() != 2)
+            {
+                throw fail("only boards of two suits can be described");
+            }
+            Board::Suit const &upper = players[first], &lower = players[1 - first];
+            if(side == "w") turn = first;
+            else if(side == "b") turn = 1 - first;
+            else throw fail("the suit to move is not w or b");
+
+            using Size_t = Board::Position_t::value_type;
+            std::size_t const width = config.boardWidth(), height = config.boardHeight();
+            std::size_t x = 0, y = 0;
+            for(std::size_t i = 0; i < placement.size(); ++i)
+            {
+                unsigned char c = static_cast<unsigned char>(placement[i]);
+                if(c == '/')
+                {
+                    if(x != width) throw fail("rank " + std::to_string(height - y) + " is not " + std::to_string(width) + " tiles");
+                    if(++y == height) throw fail("there are more than " + std::to_string(height) + " ranks");
+                    x = 0;
+                    continue;
+                }
+                if(std::isdigit(c))
+                {
+                    std::size_t empty = 0;
+                    for(; i < placement.size() && std::isdigit(static_cast<unsigned char>(placement[i])); ++i)
+                    {
+                        empty = empty*10 + std::size_t(placement[i] - '0');
+                    }
+                    --i;
+                    x += empty;
+                    if(x > width) throw fail("rank " + std::to_string(height - y) + " is wider than the board");
+                    continue;
+                }
+                char letter = char(std::toupper(c));
+                char const *pclass = letter == 'P'? "Pawn" : Notation::pieceClass(letter);
+                if(!pclass) throw fail(std::string("there is no piece ") + char(c));
+                if(x >= width) throw fail("rank " + std::to_string(height - y) + " is wider than the board");
+                layout[Board::Position_t(Size_t(x), Size_t(y))] = std::make_pair(config::BoardConfig::PieceClass_t(pclass), std::isupper(c)? upper : lower);
+                ++x;
+            }
+            if(x != width || y + 1 != height)
+            {
+                throw fail("it does not have " + std::to_string(height) + " ranks of " + std::to_string(width) + " tiles");
+            }
+
+            //pieces still on their initial tiles haven't moved, unless they lost their castling rights
+            auto const &initial = config.initialLayout();
+            for(auto const &slot : layout)
+            {
+                auto it = initial.find(slot.first);
+                bool unmoved = it != initial.end() && it->second == slot.second;
+                bool upper_suit = slot.second.second == upper;
+                if(unmoved && slot.second.first == "King")
+                {
+                    unmoved = castling.find_first_of(upper_suit? "KQ" : "kq") != std::string::npos;
+                }
+                else if(unmoved && slot.second.first == "Rook")
+                {
+                    unmoved = false;
+                    for(auto const &king : layout)
+                    {
+                        if(king.second.first != "King" || king.second.second != slot.second.second) continue;
+                        char right = slot.first.x > king.first.x? 'K' : 'Q';
+                        unmoved = castling.find(upper_suit? right : char(std::tolower(right))) != std::string::npos;
+                    }
+                }
+                if(!unmoved)
+                {
+                    moved.insert(slot.first);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef ChessPlusPlus_Engine_ForsythEdwardsNotationClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_ForsythEdwardsNotationClass_HeaderPlusPlus
+
+#include "MoveGenerator.hpp"
+
+#include <set>
+#include <string>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * A position read from Forsyth-Edwards Notation, e.g.
+         * "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1",
+         * as the layout and moved tiles of the Board constructor, so a
+         * board can be set up without the pieces of board.json:
+         *
+         *     Fen fen {config, text};
+         *     Board board {config, fen.layout, fen.moved};
+         *
+         * Ranks go from the top row down and must be as many as the
+         * board is high, and as wide. Letters are those of Notation
+         * and P for the Pawn; capitals are the suit that moves first
+         * and small letters the other one, so only boards of two suits
+         * can be read. A piece counts as not having moved if the
+         * initial layout has the same piece on its tile and, for Kings
+         * and Rooks, if the castling rights keep it so: K and k for
+         * the Rook right of its King, Q and q for the one on the left.
+         * The board can't be told of an en passant tile, which is
+         * ignored, and the move counters are optional.
+         */
+        class Fen
+        {
+        public:
+            config::BoardConfig::Layout_t layout;
+            std::set<Board::Position_t> moved;
+            std::size_t turn = 0; //index in players(), the order of suits()
+            std::size_t halfmoves = 0, fullmoves = 1;
+
+            //Throws if the text is not a position of the configuration
+            Fen(config::BoardConfig const &config, std::string const &text);
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,228 @@
+#include "GameRecord.hpp"
+#include "Exception.hpp"
+
+#include <cstring>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        constexpr std::size_t GameRecorder::BufferSize;
+
+        namespace
+        {
+            static char const Magic[8] = {'C', 'P', 'P', 'G', 'A', 'M', 'E', '1'};
+            class Header
+            {
+            public:
+                char magic[8];
+                std::uint16_t width, height;
+                std::uint8_t move_bytes;
+                std::uint8_t reserved[3];
+            };
+            static_assert(sizeof(Header) == 16, "game record headers are stored as they are in memory");
+
+            static Header header(config::BoardConfig const &config, std::size_t move_bytes) noexcept
+            {
+                Header h;
+                std::memset(&h, 0, sizeof(h));
+                std::memcpy(h.magic, Magic, sizeof(Magic));
+                h.width = config.boardWidth();
+                h.height = config.boardHeight();
+                h.move_bytes = std::uint8_t(move_bytes);
+                return h;
+            }
+            static std::size_t moveBytes(config::BoardConfig const &config) noexcept
+            {
+                return PackedMove::fitsNarrow(config)? sizeof(PackedMove::Narrow_t) : sizeof(PackedMove::Wide_t);
+            }
+            static Board::Position_t position(Board const &b, std::size_t tile) noexcept
+            {
+                using T = Board::Position_t::value_type;
+                return {T(tile%b.config.boardWidth()), T(tile/b.config.boardWidth())};
+            }
+        }
+
+        GameRecorder::GameRecorder(config::BoardConfig const &config_, std::string const &path)
+        : config(config_) //can't use {}
+        , positions{config_}
+        , move_bytes{moveBytes(config_)}
+        {
+            Header h = header(config, move_bytes), existing;
+            std::ifstream in {path, std::ios::binary};
+            bool fresh = !in.read(reinterpret_cast<char *>(&existing), sizeof(existing));
+            if(fresh? in.gcount() != 0 : std::memcmp(&existing, &h, sizeof(h)) != 0)
+            {
+                throw Exception("\"" + path + "\" is not a record of games on " + std::to_string(h.width) + "x" + std::to_string(h.height) + " boards");
+            }
+            in.close();
+            out.open(path, std::ios::binary | std::ios::app);
+            if(!out)
+            {
+                throw Exception("\"" + path + "\" could not be opened to record games");
+            }
+            buffer.reserve(BufferSize);
+            if(fresh)
+            {
+                buffer.append(reinterpret_cast<char const *>(&h), sizeof(h));
+            }
+        }
+        GameRecorder::~GameRecorder()
+        {
+            end();
+            flush();
+        }
+
+        void GameRecorder::begin(Board &b, std::size_t turn)
+        {
+            end();
+            if(b.config.boardWidth() != config.boardWidth() || b.config.boardHeight() != config.boardHeight())
+            {
+                throw Exception("games can only be recorded on boards of the recorder's size");
+            }
+            positions.pack(b, turn, buffer);
+            board = &b;
+            b.observe(this);
+        }
+        void GameRecorder::end()
+        {
+            if(!board) return;
+            write(PackedMove{});
+            if(board->observed() == this)
+            {
+                board->observe(nullptr);
+            }
+            board = nullptr;
+        }
+
+        bool GameRecorder::flush()
+        {
+            out.write(buffer.data(), std::streamsize(buffer.size()));
+            buffer.clear();
+            out.flush();
+            return bool(out);
+        }
+
+        void GameRecorder::played(Board const &b, Board::Position_t const &from, Board::Position_t const &to, Board::Position_t const *captured)
+        {
+            if(&b != board) return;
+            write(PackedMove{b, from, to, captured});
+        }
+
+        void GameRecorder::write(PackedMove const &m)
+        {
+            std::uint32_t v = move_bytes == sizeof(PackedMove::Narrow_t)? m.narrow() : m.wide();
+            for(std::size_t i = 0; i < move_bytes; ++i)
+            {
+                buffer.push_back(char(v >> 8*i & 0xFF));
+            }
+            if(buffer.size() >= BufferSize)
+            {
+                flush();
+            }
+        }
+
+        GameReplay::GameReplay(config::BoardConfig const &config_, std::string const &path)
+        : config(config_) //can't use {}
+        , positions{config_}
+        , file{path}
+        {
+            if(!file.valid() || file.size() < sizeof(Header)) return;
+            Header const &h = *static_cast<Header const *>(file.data());
+            if(std::memcmp(h.magic, Magic, sizeof(Magic)) != 0 || h.width != config.boardWidth() || h.height != config.boardHeight())
+            {
+                return;
+            }
+            if(h.move_bytes == sizeof(PackedMove::Wide_t) || (h.move_bytes == sizeof(PackedMove::Narrow_t) && PackedMove::fitsNarrow(config)))
+            {
+                move_bytes = h.move_bytes;
+                at = sizeof(Header);
+            }
+        }
+
+        PackedMove GameReplay::read(std::size_t offset) const noexcept
+        {
+            auto const *bytes = static_cast<std::uint8_t const *>(file.data()) + offset;
+            std::uint32_t v = 0;
+            for(std::size_t i = 0; i < move_bytes; ++i)
+            {
+                v |= std::uint32_t(bytes[i]) << 8*i;
+            }
+            return move_bytes == sizeof(PackedMove::Narrow_t)? PackedMove::fromNarrow(PackedMove::Narrow_t(v)) : PackedMove::fromWide(v);
+        }
+
+        bool GameReplay::make(Board &b, PackedMove const &m)
+        {
+            auto from = position(b, m.from()), to = position(b, m.to());
+            auto source = b.pieceAt(from);
+            if(source == b.end()) return false;
+            if(!(m.flags() & PackedMove::Capture))
+            {
+                auto trajectory = b.pieceTrajectory(**source);
+                for(auto it = trajectory.begin(); it != trajectory.end(); ++it)
+                {
+                    if(it->tile == to) return b.makeMove(source, it);
+                }
+                return false;
+            }
+            //the captured piece is on the destination unless the capture is remote
+            bool remote = (m.flags() & PackedMove::Remote) != 0;
+            auto target = b.pieceAt(to);
+            if(!remote && target == b.end()) return false;
+            auto capturing = b.pieceCapturing(**source);
+            auto capturables = remote? b.pieceCapturables() : b.pieceCapturable(**target);
+            for(auto it = capturing.begin(); it != capturing.end(); ++it)
+            {
+                if(it->tile != to) continue;
+                for(auto jt = capturables.begin(); jt != capturables.end(); ++jt)
+                {
+                    if(jt->tile != to) continue;
+                    auto captured = b.piece(jt->piece);
+                    if((*captured)->suit == (*source)->suit || ((*captured)->pos != to) != remote) continue;
+                    return b.makeMove(source, it, jt);
+                }
+            }
+            return false;
+        }
+
+        bool GameReplay::next(Visit_t const &visit)
+        {
+            if(!valid() || malformed || at == file.size()) return false;
+            auto const *data = static_cast<char const *>(file.data());
+            PackedPosition::Layout_t layout;
+            PackedPosition::Moved_t moved;
+            std::size_t turn = 0;
+            std::size_t offset = positions.unpack(data + at, file.size() - at, layout, moved, turn);
+            if(offset == 0)
+            {
+                malformed = true;
+                return false;
+            }
+            offset += at;
+            std::size_t const suits = config.suits().size();
+            Board b {config, layout, moved};
+            for(;;)
+            {
+                if(file.size() - offset < move_bytes)
+                {
+                    malformed = true;
+                    return false;
+                }
+                PackedMove m = read(offset);
+                offset += move_bytes;
+                if(visit) visit(b, turn, m);
+                if(!m) break;
+                if(!make(b, m))
+                {
+                    malformed = true;
+                    return false;
+                }
+                turn = (turn + 1) % suits;
+                ++replayed_moves;
+            }
+            at = offset;
+            ++replayed_games;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef ChessPlusPlus_Engine_GameRecordClasses_HeaderPlusPlus
+#define ChessPlusPlus_Engine_GameRecordClasses_HeaderPlusPlus
+
+#include "PackedMove.hpp"
+#include "PackedPosition.hpp"
+#include "util/MappedFile.hpp"
+
+#include <functional>
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Records the games played on boards into a file, as packed
+         * moves. The file is a 16 byte header, the magic "CPPGAME1",
+         * the board width and height and the bytes per move, then the
+         * games one after another. A game is the PackedPosition it
+         * started from, its moves in the narrow form if the board fits
+         * it and the wide form otherwise, and a zero move, all in
+         * little-endian byte order. Writes are buffered, so the file
+         * is only complete once the recorder is flushed or destroyed.
+         */
+        class GameRecorder
+        : public Board::Observer
+        {
+        public:
+            static constexpr std::size_t BufferSize = 64*1024; //bytes kept before they are written
+
+        private:
+            config::BoardConfig const &config;
+            PackedPosition positions;
+            std::ofstream out;
+            std::string buffer;
+            std::size_t move_bytes;
+            Board *board = nullptr;
+
+            void write(PackedMove const &m);
+
+        public:
+            //Appends to the file if it already holds games of the same board size,
+            //throws if it holds something else or can't be opened
+            GameRecorder(config::BoardConfig const &config, std::string const &path);
+            GameRecorder(GameRecorder const &) = delete;
+            GameRecorder &operator=(GameRecorder const &) = delete;
+            ~GameRecorder();
+
+            //Ends the game being recorded, if any, and records the moves made on
+            //the board from now on, with the suit at turn of suits() to move.
+            //The board must outlive the recording or end() must be called first.
+            void begin(Board &b, std::size_t turn);
+            //Ends the game and stops observing its board
+            void end();
+            bool recording() const noexcept
+            {
+                return board != nullptr;
+            }
+            //Writes what is buffered, returns false if the file could not be written
+            bool flush();
+
+            virtual void played(Board const &b, Board::Position_t const &from, Board::Position_t const &to, Board::Position_t const *captured) override;
+        };
+
+        /**
+         * Replays the games of a GameRecorder file through makeMove()
+         * on a board of the same configuration. Moves are found among
+         * the board's trajectories and capturings by their tiles
+         * instead of generating legal moves, as recorded moves were
+         * legal when they were made, so replaying is about as fast as
+         * the board can make moves.
+         */
+        class GameReplay
+        {
+        public:
+            //Called before each move with the position, the index in suits() of the
+            //suit to move and the move, then once more with no move after the last
+            using Visit_t = std::function<void (Board const &b, std::size_t turn, PackedMove const &m)>;
+
+        private:
+            config::BoardConfig const &config;
+            PackedPosition positions;
+            util::MappedFile file;
+            std::size_t move_bytes = 0;
+            std::size_t at = 0; //offset of the next game in the file
+            std::size_t replayed_games = 0, replayed_moves = 0;
+            bool malformed = false;
+
+            PackedMove read(std::size_t offset) const noexcept;
+            static bool make(Board &b, PackedMove const &m);
+
+        public:
+            //Check valid() to see whether the file could be mapped and fits the board
+            GameReplay(config::BoardConfig const &config, std::string const &path);
+
+            bool valid() const noexcept
+            {
+                return move_bytes != 0;
+            }
+            //Replays the next game, returns false once there are no more or the
+            //rest of the file is malformed, which failed() then tells
+            bool next(Visit_t const &visit = {});
+            bool failed() const noexcept
+            {
+                return malformed;
+            }
+            std::size_t games() const noexcept
+            {
+                return replayed_games;
+            }
+            std::size_t moves() const noexcept
+            {
+                return replayed_moves;
+            }
+        };
+    }
+}
+
+#endif
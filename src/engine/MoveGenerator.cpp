@@ -0,0 +1,134 @@
+#include "MoveGenerator.hpp"
+
+#include "util/Profiler.hpp"
+#include "util/Allocations.hpp"
+
+#include <set>
+#include <algorithm>
+#include <string>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        constexpr Move::Offset_t Move::None;
+
+        void MoveGenerator::operator()(Board &b, Board::Suit const &turn, Moves_t &moves, bool captures_only)
+        {
+            CHESSPP_PROFILE_SCOPE("MoveGenerator");
+            CHESSPP_PROFILE_ALLOCATIONS("MoveGenerator");
+            moves.clear();
+            auto trajectories = b.pieceTrajectories();
+            auto capturings = b.pieceCapturings();
+            auto capturables = b.pieceCapturables();
+
+            enemies.clear();
+            for(auto it = capturables.begin(); it != capturables.end(); ++it)
+            {
+                if((*b.piece(it->piece))->suit != turn)
+                {
+                    enemies.push_back(Move::Offset_t(it - capturables.begin()));
+                }
+            }
+            auto victim = [&](Board::Movement const &m) -> Move::Offset_t
+            {
+                for(auto e : enemies)
+                {
+                    auto const &c = capturables.begin()[e];
+                    if(c.tile == m.tile && (!b.occupied(m.tile) || b.pieceAt(m.tile) == b.piece(c.piece)))
+                    {
+                        return e;
+                    }
+                }
+                return Move::None;
+            };
+
+            for(auto it = capturings.begin(); it != capturings.end(); ++it)
+            {
+                auto source = b.piece(it->piece);
+                if((*source)->suit != turn) continue;
+                auto e = victim(*it);
+                if(e != Move::None)
+                {
+                    moves.push_back(Move{Move::Offset_t(it - capturings.begin()), e, (*source)->pos, it->tile});
+                }
+            }
+            for(auto it = trajectories.begin(); it != trajectories.end() && !captures_only; ++it)
+            {
+                auto source = b.piece(it->piece);
+                if((*source)->suit != turn || b.occupied(it->tile)) continue;
+                bool captures = false;
+                for(auto const &c : b.pieceCapturing(**source))
+                {
+                    if(c.tile == it->tile && victim(c) != Move::None)
+                    {
+                        captures = true;
+                        break;
+                    }
+                }
+                if(!captures)
+                {
+                    moves.push_back(Move{Move::Offset_t(it - trajectories.begin()), Move::None, (*source)->pos, it->tile});
+                }
+            }
+
+            //only after generating, checking by making a move invalidates the spans above
+            legal.update(b, turn);
+            moves.erase(std::remove_if(moves.begin(), moves.end(), [&](Move const &m)
+            {
+                return !legal.allows(m.target, m.isCapture()? board::Legality::Offset_t(m.capturable) : board::Legality::None);
+            }), moves.end());
+        }
+
+        bool MoveGenerator::make(Board &b, Move const &m)
+        {
+            if(!m.isCapture())
+            {
+                auto target = b.pieceTrajectories().begin() + m.target;
+                return b.makeMove(b.piece(target->piece), target);
+            }
+            auto target = b.pieceCapturings().begin() + m.target;
+            return b.makeMove(b.piece(target->piece), target, b.pieceCapturables().begin() + m.capturable);
+        }
+        bool MoveGenerator::play(Board &b, Move const &m)
+        {
+            if(!m.isCapture())
+            {
+                auto target = b.pieceTrajectories().begin() + m.target;
+                return b.move(b.piece(target->piece), target);
+            }
+            auto target = b.pieceCapturings().begin() + m.target;
+            return b.capture(b.piece(target->piece), target, b.pieceCapturables().begin() + m.capturable);
+        }
+
+        Players_t players(config::BoardConfig const &config, std::size_t &first)
+        {
+            //same order as ChessPlusPlusState
+            auto const &suits = config.suits();
+            Players_t p (suits.begin(), suits.end()); //don't use {}
+            first = 0;
+            auto turn = config.metadata("first turn");
+            if(turn.type() == json_string)
+            {
+                for(std::size_t i = 0; i < p.size(); ++i)
+                {
+                    if(p[i] == std::string(turn)) first = i;
+                }
+            }
+            return p;
+        }
+
+        Draw draw(Board const &b) noexcept
+        {
+            if(b.repetitions() >= 2)
+            {
+                return Draw::Repetition;
+            }
+            if(b.reversiblePlies() >= 50*b.config.suits().size())
+            {
+                return Draw::FiftyMoves;
+            }
+            return Draw::None;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef ChessPlusPlus_Engine_MoveGeneratorClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_MoveGeneratorClass_HeaderPlusPlus
+
+#include "board/Board.hpp"
+#include "board/Legality.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        using Board = board::Board;
+        using Players_t = std::vector<Board::Suit>; //in turn order
+
+        /**
+         * A move that can be made from the position it was generated
+         * in. It refers to the board's move lists by offset rather than
+         * by iterator, since unmakeMove() restores the lists exactly
+         * but not at the same addresses.
+         */
+        class Move
+        {
+        public:
+            using Offset_t = std::uint32_t;
+            static constexpr Offset_t None = Offset_t(-1);
+
+            Offset_t target;     //into the trajectories, or the capturings for captures
+            Offset_t capturable; //into the capturables, or None
+            Board::Position_t from, to;
+
+            bool isCapture() const noexcept
+            {
+                return capturable != None;
+            }
+            //Identifies the move by its tiles, so it can be found again in a transposition
+            std::uint32_t code() const noexcept
+            {
+                return std::uint32_t(from.x) | std::uint32_t(from.y) << 8 | std::uint32_t(to.x) << 16 | std::uint32_t(to.y) << 24;
+            }
+        };
+        using Moves_t = std::vector<Move>;
+
+        /**
+         * Generates legal moves with the same rules as ChessPlusPlusState:
+         * a tile where an enemy can be captured is a capture, otherwise
+         * an empty tile in the trajectory is a plain move. Moves that
+         * would leave the suit's King attacked are left out.
+         */
+        class MoveGenerator
+        {
+            std::vector<Move::Offset_t> enemies; //reused between calls
+            board::Legality legal;
+
+        public:
+            //Replaces moves with every legal move the suit can make, or only the captures.
+            //The board is left as it was but its move lists may be made and unmade.
+            void operator()(Board &b, Board::Suit const &turn, Moves_t &moves, bool captures_only = false);
+            //Whether the suit was in check in the position of the last call
+            bool inCheck() const noexcept
+            {
+                return legal.inCheck();
+            }
+
+            //Makes a generated move with Board::makeMove(), without logging
+            static bool make(Board &b, Move const &m);
+            //Makes a generated move with Board::move() or Board::capture()
+            static bool play(Board &b, Move const &m);
+        };
+
+        //The suits of the board in turn order and the index of the one that moves first
+        Players_t players(config::BoardConfig const &config, std::size_t &first);
+
+        //Why a position is drawn, whatever the moves left
+        enum class Draw
+        {
+            None,
+            Repetition, //the third time the position occurs with the same suit to move
+            FiftyMoves  //fifty moves by every suit without a capture or Pawn move
+        };
+        Draw draw(Board const &b) noexcept;
+    }
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include "Notation.hpp"
+
+#include <cctype>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        namespace
+        {
+            //Splits "g1f3" into its tiles, tiles are a file letter followed by a rank
+            static bool tiles(std::string const &s, Board const &b, int &from_x, int &from_y, int &to_x, int &to_y)
+            {
+                std::size_t i = 0;
+                int *out[] = {&from_x, &from_y, &to_x, &to_y};
+                for(std::size_t t = 0; t < 4; t += 2)
+                {
+                    if(i >= s.size() || !std::islower(static_cast<unsigned char>(s[i]))) return false;
+                    *out[t] = s[i++] - 'a';
+                    std::size_t digits = i;
+                    while(digits < s.size() && std::isdigit(static_cast<unsigned char>(s[digits]))) ++digits;
+                    if(digits == i || digits - i > 3) return false;
+                    *out[t + 1] = int(b.config.boardHeight()) - std::stoi(s.substr(i, digits - i));
+                    i = digits;
+                }
+                return i == s.size();
+            }
+        }
+
+        char const *Notation::pieceClass(char letter) noexcept
+        {
+            switch(letter)
+            {
+            case 'K': return "King";
+            case 'Q': return "Queen";
+            case 'R': return "Rook";
+            case 'B': return "Bishop";
+            case 'N': return "Knight";
+            case 'A': return "Archer";
+            default:  return nullptr;
+            }
+        }
+
+        std::string Notation::tile(Board const &b, Board::Position_t const &p)
+        {
+            return char('a' + p.x) + std::to_string(int(b.config.boardHeight()) - int(p.y));
+        }
+        std::string Notation::coordinates(Board const &b, Move const &m)
+        {
+            return tile(b, m.from) + tile(b, m.to);
+        }
+
+        bool Notation::parse(Board &b, Board::Suit const &turn, std::string const &text, Move &move)
+        {
+            std::string s = text;
+            while(!s.empty() && (s.back() == '+' || s.back() == '#' || s.back() == '!' || s.back() == '?'))
+            {
+                s.pop_back();
+            }
+            generate(b, turn, moves);
+
+            int from_x, from_y, to_x, to_y;
+            if(tiles(s, b, from_x, from_y, to_x, to_y))
+            {
+                for(auto const &m : moves)
+                {
+                    if(int(m.from.x) == from_x && int(m.from.y) == from_y && int(m.to.x) == to_x && int(m.to.y) == to_y)
+                    {
+                        move = m;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            if(s == "O-O" || s == "0-0" || s == "O-O-O" || s == "0-0-0")
+            {
+                int side = s.size() == 3? 2 : -2;
+                bool found = false;
+                for(auto const &m : moves)
+                {
+                    if((*b.pieceAt(m.from))->pclass == "King" && m.to.y == m.from.y && int(m.to.x) - int(m.from.x) == side)
+                    {
+                        if(found) return false;
+                        move = m;
+                        found = true;
+                    }
+                }
+                return found;
+            }
+
+            std::string pclass = "Pawn";
+            std::size_t i = 0;
+            if(!s.empty() && pieceClass(s[0]))
+            {
+                pclass = pieceClass(s[0]);
+                i = 1;
+            }
+            //the destination is the last file letter and the rank after it
+            std::size_t rank_at = s.size();
+            while(rank_at > i && std::isdigit(static_cast<unsigned char>(s[rank_at - 1]))) --rank_at;
+            if(rank_at == s.size() || rank_at == i || !std::islower(static_cast<unsigned char>(s[rank_at - 1])))
+            {
+                return false; //no destination, or a promotion
+            }
+            to_x = s[rank_at - 1] - 'a';
+            to_y = int(b.config.boardHeight()) - std::stoi(s.substr(rank_at));
+
+            //what is left between the piece and the destination disambiguates
+            from_x = -1;
+            from_y = -1;
+            std::string between = s.substr(i, rank_at - 1 - i);
+            std::size_t j = 0;
+            if(j < between.size() && std::islower(static_cast<unsigned char>(between[j])) && between[j] != 'x')
+            {
+                from_x = between[j++] - 'a';
+            }
+            if(j < between.size() && std::isdigit(static_cast<unsigned char>(between[j])))
+            {
+                std::size_t digits = j;
+                while(digits < between.size() && std::isdigit(static_cast<unsigned char>(between[digits]))) ++digits;
+                from_y = int(b.config.boardHeight()) - std::stoi(between.substr(j, digits - j));
+                j = digits;
+            }
+            if(j < between.size() && between[j] == 'x') ++j;
+            if(j != between.size()) return false;
+
+            bool found = false;
+            for(auto const &m : moves)
+            {
+                if(int(m.to.x) != to_x || int(m.to.y) != to_y) continue;
+                if((from_x >= 0 && int(m.from.x) != from_x) || (from_y >= 0 && int(m.from.y) != from_y)) continue;
+                if((*b.pieceAt(m.from))->pclass != pclass) continue;
+                if(found) return false;
+                move = m;
+                found = true;
+            }
+            return found;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef ChessPlusPlus_Engine_AlgebraicNotationClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_AlgebraicNotationClass_HeaderPlusPlus
+
+#include "MoveGenerator.hpp"
+
+#include <string>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Reads moves in standard algebraic notation, e.g. "Nbd7",
+         * "exd5", "O-O-O" or "Qh4#", by matching them against the
+         * legal moves of the position. Files start at 'a' on the left
+         * and rank 1 is the bottom row, so it works for boards that
+         * aren't 8x8 too. Piece letters are K, Q, R, B, N and A for
+         * the Archer, and no letter is a Pawn. Castling is the King's
+         * two-tile move to the right for O-O and to the left for O-O-O.
+         * Promotions can't be read since pieces don't promote.
+         * Moves can also be given by their tiles, e.g. "g1f3".
+         */
+        class Notation
+        {
+            MoveGenerator generate;
+            Moves_t moves;
+
+        public:
+            //Finds the legal move the text means, returns false if it is not exactly one
+            bool parse(Board &b, Board::Suit const &turn, std::string const &text, Move &move);
+
+            //The class a piece letter stands for, nullptr for none
+            static char const *pieceClass(char letter) noexcept;
+            //A tile by its file and rank, e.g. "f3"
+            static std::string tile(Board const &b, Board::Position_t const &p);
+            //The tiles of a move, e.g. "g1f3"
+            static std::string coordinates(Board const &b, Move const &m);
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include "PackedMove.hpp"
+
+namespace chesspp
+{
+    namespace engine
+    {
+        constexpr std::size_t PackedMove::MaxNarrowTiles;
+        constexpr std::size_t PackedMove::MaxWideTiles;
+
+        namespace
+        {
+            static std::size_t tile(Board const &b, Board::Position_t const &p) noexcept
+            {
+                return std::size_t(p.y)*b.config.boardWidth() + p.x;
+            }
+        }
+
+        PackedMove::PackedMove(Board const &b, Move const &m, unsigned promotion) noexcept
+        : PackedMove(b, m.from, m.to, m.isCapture()? &(*b.piece((b.pieceCapturables().begin() + m.capturable)->piece))->pos : nullptr, promotion)
+        {
+        }
+        PackedMove::PackedMove(Board const &b, Board::Position_t const &from, Board::Position_t const &to, Board::Position_t const *captured, unsigned promotion) noexcept
+        {
+            unsigned f = 0;
+            if(captured)
+            {
+                f |= Capture;
+                if(*captured != to)
+                {
+                    f |= Remote;
+                }
+            }
+            bits = Wide_t(tile(b, from)) | Wide_t(tile(b, to)) << 12 | Wide_t(f) << 24 | Wide_t(promotion & 0xF) << 28;
+        }
+
+        Moves_t::const_iterator PackedMove::find(Board const &b, Moves_t const &moves) const noexcept
+        {
+            bool capture = (flags() & Capture) != 0;
+            for(auto it = moves.begin(); it != moves.end(); ++it)
+            {
+                if(tile(b, it->from) == from() && tile(b, it->to) == to() && it->isCapture() == capture)
+                {
+                    return it;
+                }
+            }
+            return moves.end();
+        }
+    }
+}
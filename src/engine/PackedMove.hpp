@@ -0,0 +1,112 @@
+#ifndef ChessPlusPlus_Engine_PackedMoveClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_PackedMoveClass_HeaderPlusPlus
+
+#include "MoveGenerator.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * A move reduced to its tiles and what kind of move it is,
+         * for storing moves apart from the position they were
+         * generated in. Tiles are numbered row by row from the top
+         * left. The narrow form is 16 bits, from and to in 6 bits each
+         * and 4 bits of flags, for boards of up to 64 tiles. The wide
+         * form is 32 bits, from and to in 12 bits each, the flags, and
+         * 4 bits for the class a piece promotes to, 0 for none, for
+         * boards of up to 4096 tiles. Pieces don't promote yet, so the
+         * promotion is only carried along.
+         */
+        class PackedMove
+        {
+        public:
+            using Narrow_t = std::uint16_t;
+            using Wide_t = std::uint32_t;
+            static constexpr std::size_t MaxNarrowTiles = 64;
+            static constexpr std::size_t MaxWideTiles = 4096;
+            enum Flag : unsigned
+            {
+                Capture = 1, //the move captures
+                Remote  = 2  //the captured piece is not on the destination, e.g. en passant
+            };
+
+        private:
+            Wide_t bits = 0; //always in the wide form
+
+            explicit PackedMove(Wide_t wide) noexcept
+            : bits{wide}
+            {
+            }
+
+        public:
+            //No move, which no generated move packs to
+            PackedMove() noexcept = default;
+            PackedMove(Board const &b, Move const &m, unsigned promotion = 0) noexcept;
+            //A move the board was told of, see Board::Observer
+            PackedMove(Board const &b, Board::Position_t const &from, Board::Position_t const &to, Board::Position_t const *captured, unsigned promotion = 0) noexcept;
+
+            static PackedMove fromNarrow(Narrow_t narrow) noexcept
+            {
+                return PackedMove{Wide_t(narrow & 0x3F) | Wide_t(narrow >> 6 & 0x3F) << 12 | Wide_t(narrow >> 12) << 24};
+            }
+            static PackedMove fromWide(Wide_t wide) noexcept
+            {
+                return PackedMove{wide};
+            }
+            //Whether moves of the board fit the narrow form
+            static bool fitsNarrow(config::BoardConfig const &config) noexcept
+            {
+                return std::size_t(config.boardWidth())*config.boardHeight() <= MaxNarrowTiles;
+            }
+
+            //Only for boards that fitsNarrow(), and drops the promotion
+            Narrow_t narrow() const noexcept
+            {
+                return Narrow_t(from() | to() << 6 | flags() << 12);
+            }
+            Wide_t wide() const noexcept
+            {
+                return bits;
+            }
+
+            std::size_t from() const noexcept
+            {
+                return bits & 0xFFF;
+            }
+            std::size_t to() const noexcept
+            {
+                return bits >> 12 & 0xFFF;
+            }
+            unsigned flags() const noexcept
+            {
+                return bits >> 24 & 0xF;
+            }
+            unsigned promotion() const noexcept
+            {
+                return bits >> 28;
+            }
+            explicit operator bool() const noexcept
+            {
+                return bits != 0;
+            }
+
+            //The generated move this stands for, or moves.end()
+            Moves_t::const_iterator find(Board const &b, Moves_t const &moves) const noexcept;
+
+            friend bool operator==(PackedMove const &a, PackedMove const &b) noexcept
+            {
+                return a.bits == b.bits;
+            }
+            friend bool operator!=(PackedMove const &a, PackedMove const &b) noexcept
+            {
+                return a.bits != b.bits;
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include "PackedPosition.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        constexpr std::size_t PackedPosition::MaxClasses;
+        constexpr std::size_t PackedPosition::MaxSuits;
+
+        namespace
+        {
+            static std::uint8_t const None = 0xFF;
+
+            template<typename Interned>
+            static void number(std::vector<Interned> const &named, std::vector<std::uint8_t> &index)
+            {
+                for(std::size_t i = 0; i < named.size(); ++i)
+                {
+                    if(named[i].id() >= index.size()) index.resize(named[i].id() + 1, None);
+                    index[named[i].id()] = std::uint8_t(i);
+                }
+            }
+            template<typename Interned>
+            static std::uint8_t indexOf(std::vector<std::uint8_t> const &index, Interned const &i) noexcept
+            {
+                return i.id() < index.size()? index[i.id()] : None;
+            }
+        }
+
+        PackedPosition::PackedPosition(config::BoardConfig const &config_)
+        : config(config_) //can't use {}
+        , suits{config.suits().begin(), config.suits().end()}
+        , tiles{std::size_t(config.boardWidth())*config.boardHeight()}
+        {
+            for(auto const &slot : config.initialLayout())
+            {
+                classes.push_back(slot.second.first);
+            }
+            std::sort(classes.begin(), classes.end());
+            classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+            if(classes.size() > MaxClasses || suits.size() > MaxSuits)
+            {
+                throw Exception("positions of boards with more than 16 piece classes or 8 suits can't be packed");
+            }
+            number(classes, class_index);
+            number(suits, suit_index);
+        }
+
+        void PackedPosition::pack(Board const &b, std::size_t turn, std::string &out) const
+        {
+            std::size_t at = out.size();
+            out.resize(at + size(b.pieceCount()), '\0');
+            out[at] = char(turn);
+            char *occupied = &out[at + 1];
+            char *piece = occupied + (tiles + 7)/8;
+            for(std::size_t t = 0; t < tiles; ++t)
+            {
+                Board::Position_t p {Board::Position_t::value_type(t%config.boardWidth()), Board::Position_t::value_type(t/config.boardWidth())};
+                auto it = b.pieceAt(p);
+                if(it == b.end()) continue;
+                std::uint8_t c = indexOf(class_index, (*it)->pclass), s = indexOf(suit_index, (*it)->suit);
+                if(c == None || s == None)
+                {
+                    out.resize(at);
+                    throw Exception("the class or suit of the " + (*it)->pclass + " at " + std::to_string(t) + " is not in the initial layout");
+                }
+                occupied[t/8] = char(occupied[t/8] | 1 << t%8);
+                *piece++ = char(c | s << 4 | ((*it)->moves > 0? 0x80 : 0));
+            }
+        }
+
+        std::size_t PackedPosition::unpack(void const *data, std::size_t size_, Layout_t &layout, Moved_t &moved, std::size_t &turn) const
+        {
+            auto const *bytes = static_cast<std::uint8_t const *>(data);
+            std::size_t const header = 1 + (tiles + 7)/8;
+            if(size_ < header || bytes[0] >= suits.size()) return 0;
+            layout.clear();
+            moved.clear();
+            turn = bytes[0];
+            std::uint8_t const *occupied = bytes + 1;
+            std::size_t read = header;
+            for(std::size_t t = 0; t < tiles; ++t)
+            {
+                if(!(occupied[t/8] >> t%8 & 1)) continue;
+                if(read == size_) return 0;
+                std::uint8_t v = bytes[read++];
+                std::size_t c = v & 0xF, s = v >> 4 & 0x7;
+                if(c >= classes.size() || s >= suits.size()) return 0;
+                Board::Position_t p {Board::Position_t::value_type(t%config.boardWidth()), Board::Position_t::value_type(t/config.boardWidth())};
+                layout[p] = std::make_pair(classes[c], suits[s]);
+                if(v & 0x80) moved.insert(p);
+            }
+            return read;
+        }
+    }
+}
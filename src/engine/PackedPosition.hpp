@@ -0,0 +1,64 @@
+#ifndef ChessPlusPlus_Engine_PackedPositionClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_PackedPositionClass_HeaderPlusPlus
+
+#include "MoveGenerator.hpp"
+
+#include <vector>
+#include <set>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Packs positions of a board configuration into a few bytes,
+         * for keeping large numbers of them in memory or on disk. A
+         * packed position is the index of the suit to move, a bit per
+         * tile row by row telling which are occupied, then a byte per
+         * occupied tile in the same order: the piece's class in the
+         * low 4 bits, its suit in the next 3, and whether it has moved
+         * in the top bit. Classes are numbered in name order among
+         * those of the initial layout, and suits as in suits(). That
+         * is 41 bytes for a full 8x8 board.
+         *
+         * Unpacking gives the layout and moved tiles of the Board
+         * constructor, so a Pawn that has just moved two tiles comes
+         * back as having moved more, and can't be taken en passant.
+         */
+        class PackedPosition
+        {
+        public:
+            static constexpr std::size_t MaxClasses = 16;
+            static constexpr std::size_t MaxSuits = 8;
+            using Layout_t = config::BoardConfig::Layout_t;
+            using Moved_t = std::set<Board::Position_t>;
+
+        private:
+            config::BoardConfig const &config;
+            std::vector<config::BoardConfig::PieceClass_t> classes;
+            std::vector<Board::Suit> suits;
+            std::vector<std::uint8_t> class_index, suit_index; //by interned id, 0xFF if not numbered
+            std::size_t tiles;
+
+        public:
+            //Throws if the configuration has more classes or suits than fit
+            explicit PackedPosition(config::BoardConfig const &config);
+
+            //The bytes pack() appends for a position with a number of pieces
+            std::size_t size(std::size_t pieces) const noexcept
+            {
+                return 1 + (tiles + 7)/8 + pieces;
+            }
+            //Appends the position, throws if a piece's class is not numbered
+            void pack(Board const &b, std::size_t turn, std::string &out) const;
+            //Reads a position that pack() wrote at the start of data,
+            //returns the bytes read or 0 if it is not one of this configuration
+            std::size_t unpack(void const *data, std::size_t size, Layout_t &layout, Moved_t &moved, std::size_t &turn) const;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,66 @@
+#include "ParallelSearch.hpp"
+
+#include <thread>
+#include <memory>
+#include <vector>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        ParallelSearch::ParallelSearch(Board &b, Players_t const &players_, TranspositionTable &table_, Evaluation const &evaluation_, std::size_t threads_, Tablebase *tablebase_)
+        : board(b)                                                                //can't use {}
+        , players(players_)                                                       //can't use {}
+        , table(table_)                                                           //can't use {}
+        , evaluation(evaluation_)                                                 //can't use {}
+        , tablebase{tablebase_}
+        , threads(threads_? threads_ : std::max(1u, std::thread::hardware_concurrency()))
+        , main{board, players, table, evaluation, tablebase}
+        {
+        }
+
+        Search::Result ParallelSearch::run(std::size_t turn, Search::Limits const &limits)
+        {
+            table.nextSearch();
+            if(threads == 1)
+            {
+                return main.run(turn, limits);
+            }
+
+            //copies are made before any thread starts, since they replay the main board
+            std::vector<std::unique_ptr<Board>> boards;
+            std::vector<std::unique_ptr<Search>> helpers;
+            for(std::size_t i = 1; i < threads; ++i)
+            {
+                boards.emplace_back(new Board(board));
+                helpers.emplace_back(new Search(*boards.back(), players, table, evaluation, tablebase));
+            }
+
+            std::vector<Search::Result> results (helpers.size()); //don't use {}
+            std::vector<std::thread> workers;
+            for(std::size_t i = 0; i < helpers.size(); ++i)
+            {
+                Search::Limits l = limits;
+                l.time = std::chrono::milliseconds::zero(); //stopped with the main search
+                l.nodes = 0;
+                l.first = limits.first + (i%2 == 0? 1 : 0);
+                workers.emplace_back([&, i, l]
+                {
+                    results[i] = helpers[i]->run(turn, l);
+                });
+            }
+
+            Search::Result result = main.run(turn, limits);
+            for(auto &h : helpers)
+            {
+                h->stop();
+            }
+            for(std::size_t i = 0; i < workers.size(); ++i)
+            {
+                workers[i].join();
+                result.nodes += results[i].nodes;
+            }
+            return result;
+        }
+    }
+}
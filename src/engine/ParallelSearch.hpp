@@ -0,0 +1,50 @@
+#ifndef ChessPlusPlus_Engine_ParallelSearchClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_ParallelSearchClass_HeaderPlusPlus
+
+#include "Search.hpp"
+
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Lazy SMP: helper threads run the same search on their own
+         * copies of the board and share only the transposition table,
+         * so the main search finds the positions they already scored.
+         * Half of the helpers start one iteration deeper to spread
+         * them across depths. The move always comes from the main
+         * search; with one thread and no time limit the search
+         * visits the same nodes on every run, for benchmarks.
+         */
+        class ParallelSearch
+        {
+            Board &board;
+            Players_t const &players;
+            TranspositionTable &table;
+            Evaluation const &evaluation;
+            Tablebase *tablebase;
+            std::size_t threads;
+            Search main;
+
+        public:
+            //Zero threads uses one per core, the tablebase is optional
+            ParallelSearch(Board &b, Players_t const &players, TranspositionTable &table, Evaluation const &evaluation, std::size_t threads, Tablebase *tablebase = nullptr);
+
+            std::size_t threadCount() const noexcept
+            {
+                return threads;
+            }
+            //The nodes of the result are summed over every thread
+            Search::Result run(std::size_t turn, Search::Limits const &limits);
+            //Can be called from another thread to end run() early
+            void stop() noexcept
+            {
+                main.stop();
+            }
+        };
+    }
+}
+
+#endif
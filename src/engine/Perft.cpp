@@ -0,0 +1,39 @@
+#include "Perft.hpp"
+
+namespace chesspp
+{
+    namespace engine
+    {
+        Perft::Perft(Board &b, Players_t const &players_)
+        : board(b)          //can't use {}
+        , players(players_) //can't use {}
+        {
+        }
+
+        Perft::Nodes_t Perft::operator()(std::size_t turn, unsigned depth)
+        {
+            if(depth == 0) return 1;
+            if(moves.size() <= depth)
+            {
+                moves.resize(depth + 1);
+            }
+            auto &here = moves[depth];
+            generate(board, players[turn], here);
+            if(depth == 1) return here.size(); //every generated move can be made
+
+            Nodes_t nodes = 0;
+            std::size_t next = (turn + 1)%players.size();
+            for(auto const &m : here)
+            {
+                if(!MoveGenerator::make(board, m))
+                {
+                    failed = true;
+                    continue;
+                }
+                nodes += (*this)(next, depth - 1);
+                board.unmakeMove();
+            }
+            return nodes;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef ChessPlusPlus_Engine_PerftClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_PerftClass_HeaderPlusPlus
+
+#include "MoveGenerator.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Counts the leaf positions reachable in a number of plies,
+         * to check move generation and make/unmake and to measure
+         * their speed. The last ply is counted without being made.
+         */
+        class Perft
+        {
+        public:
+            using Nodes_t = std::uint64_t;
+
+        private:
+            Board &board;
+            Players_t const &players;
+            std::vector<Moves_t> moves; //by depth, reused
+            MoveGenerator generate;
+
+        public:
+            bool failed = false; //a generated move could not be made
+
+            Perft(Board &b, Players_t const &players);
+
+            Nodes_t operator()(std::size_t turn, unsigned depth);
+        };
+    }
+}
+
+#endif
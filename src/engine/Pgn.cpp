@@ -0,0 +1,129 @@
+#include "Pgn.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        namespace
+        {
+            //The value of a tag line such as [FEN "..."] if it has the name, s is past the '['
+            static bool tag(char const *s, char const *end, char const *name, std::string &value)
+            {
+                std::size_t n = std::strlen(name);
+                if(std::size_t(end - s) <= n || std::memcmp(s, name, n) != 0 || !std::isspace(static_cast<unsigned char>(s[n])))
+                {
+                    return false;
+                }
+                auto open = std::find(s + n, end, '"');
+                auto close = open == end? end : std::find(open + 1, end, '"');
+                if(close == end) return false;
+                value.assign(open + 1, close);
+                return true;
+            }
+        }
+
+        void Pgn::read(char const *first, char const *last, Visit_t const &visit)
+        {
+            Game game;
+            std::string token;
+            int variations = 0;
+            auto end = [&]
+            {
+                if(!game.san.empty()) visit(game);
+                game.fen.clear();
+                game.san.clear();
+            };
+            auto word = [&]
+            {
+                if(token.empty() || variations > 0)
+                {
+                    token.clear();
+                    return;
+                }
+                if(token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*")
+                {
+                    end();
+                }
+                else if(token[0] != '$')
+                {
+                    //strip a move number, which may be glued to the move as in "1.e4"
+                    auto dot = token.find_last_of('.');
+                    if(dot != std::string::npos) token.erase(0, dot + 1);
+                    if(!token.empty() && !std::isdigit(static_cast<unsigned char>(token[0])))
+                    {
+                        game.san.push_back(token);
+                    }
+                    else if(token == "O-O" || token == "0-0" || token == "O-O-O" || token == "0-0-0")
+                    {
+                        game.san.push_back(token);
+                    }
+                }
+                token.clear();
+            };
+            //the last character of the text if until is not in it
+            auto skip = [&](char const *at, char until) -> char const *
+            {
+                auto found = std::find(at, last, until);
+                return found == last? last - 1 : found;
+            };
+            for(char const *at = first; at != last; ++at)
+            {
+                char c = *at;
+                if(c == '[' && variations == 0 && token.empty())
+                {
+                    auto line = skip(at, '\n');
+                    std::string fen;
+                    if(!game.san.empty()) end(); //a game without a result
+                    if(tag(at + 1, line, "FEN", fen)) game.fen = fen;
+                    at = line;
+                    continue;
+                }
+                if(c == '{')
+                {
+                    at = skip(at, '}');
+                    continue;
+                }
+                if(c == ';')
+                {
+                    at = skip(at, '\n');
+                    continue;
+                }
+                if(c == '(' || c == ')')
+                {
+                    variations += c == '('? 1 : -1;
+                    token.clear();
+                    continue;
+                }
+                if(!std::isspace(static_cast<unsigned char>(c)))
+                {
+                    token += c;
+                    continue;
+                }
+                word();
+            }
+            word();
+            end();
+        }
+
+        char const *Pgn::nextGame(char const *at, char const *first, char const *last) noexcept
+        {
+            static char const Event[] = "[Event ";
+            std::size_t const n = sizeof(Event) - 1;
+            while(at < last)
+            {
+                if((at == first || at[-1] == '\n') && std::size_t(last - at) >= n && std::memcmp(at, Event, n) == 0)
+                {
+                    return at;
+                }
+                auto line = static_cast<char const *>(std::memchr(at, '\n', std::size_t(last - at)));
+                if(!line) break;
+                at = line + 1;
+            }
+            return last;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef ChessPlusPlus_Engine_PortableGameNotationClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_PortableGameNotationClass_HeaderPlusPlus
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Reads the games of PGN text, such as a file mapped into
+         * memory. Tags other than FEN, comments, variations, move
+         * numbers, NAGs and results are skipped, so what is left of a
+         * game is its moves as Notation reads them and the position
+         * it was set up from, if any, as Fen reads it.
+         */
+        class Pgn
+        {
+        public:
+            class Game
+            {
+            public:
+                std::string fen;              //empty for the initial layout
+                std::vector<std::string> san;
+            };
+            using Visit_t = std::function<void (Game const &)>;
+
+            //Calls visit with each game that has moves, in order
+            static void read(char const *first, char const *last, Visit_t const &visit);
+            //Where the tags of the first game that starts at or after at begin, or last,
+            //so that text can be split into games; games must start with an Event tag
+            static char const *nextGame(char const *at, char const *first, char const *last) noexcept;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include "Player.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        namespace
+        {
+            static std::size_t setting(config::BoardConfig const &config, char const *name, std::size_t fallback)
+            {
+                auto v = config.metadata("engine", name);
+                if(v.type() == json_integer && std::int64_t(v) >= 0)
+                {
+                    return std::size_t(std::int64_t(v));
+                }
+                return fallback;
+            }
+            static std::string file(config::BoardConfig const &config, char const *name, char const *fallback)
+            {
+                auto v = config.metadata("engine", name);
+                return v.type() == json_string? std::string(v) : fallback;
+            }
+            static std::vector<std::string> files(config::BoardConfig const &config, char const *name)
+            {
+                std::vector<std::string> paths;
+                auto v = config.metadata("engine", name);
+                for(std::size_t i = 0; i < v.length(); ++i)
+                {
+                    if(v[i].type() == json_string) paths.push_back(std::string(v[i]));
+                }
+                return paths;
+            }
+            static Players_t suits(config::BoardConfig const &config)
+            {
+                std::size_t first = 0;
+                return players(config, first);
+            }
+        }
+
+        Player::Player(config::BoardConfig const &config, Board &b)
+        : board(b) //can't use {}
+        , players{suits(config)}
+        , evaluation_config{file(config, "evaluation", "config/chesspp/evaluation.json")}
+        , evaluation{config, evaluation_config}
+        , table{setting(config, "table megabytes", 16)}
+        , tablebase{files(config, "tablebases")}
+        , threads{setting(config, "threads", 1)}
+        , book{file(config, "book", "config/chesspp/book.bin")}
+        , random{std::random_device{}()}
+        {
+            for(auto const &p : config.metadata("players").object())
+            {
+                if(p.second.type() == json_string && std::string(p.second) == "engine")
+                {
+                    engines.insert(p.first);
+                }
+            }
+            limits.time = std::chrono::milliseconds(setting(config, "milliseconds", 1000));
+            limits.depth = unsigned(setting(config, "depth", Search::MaxPly));
+            evaluation.prepare(board);
+        }
+
+        void Player::prepare()
+        {
+            search.reset();
+            position.reset(new Board(board));
+            search.reset(new ParallelSearch(*position, players, table, evaluation, threads, tablebase.size() > 0? &tablebase : nullptr));
+        }
+
+        Search::Result Player::think(Board::Suit const &suit)
+        {
+            std::size_t turn = 0;
+            while(turn < players.size() && players[turn] != suit) ++turn;
+            if(turn == players.size() || !search) return Search::Result{};
+            Search::Result result;
+            if(fromBook(suit, result)) return result;
+            return search->run(turn, limits);
+        }
+
+        bool Player::fromBook(Board::Suit const &suit, Search::Result &result)
+        {
+            std::uint32_t code;
+            if(book.empty() || !book.choose(position->hash(suit), std::uniform_real_distribution<double>{}(random), code))
+            {
+                return false;
+            }
+            //the generator belongs to play(), which never runs during think()
+            Moves_t legal;
+            generate(*position, suit, legal);
+            for(auto const &m : legal)
+            {
+                if(m.code() == code)
+                {
+                    result.found = true;
+                    result.move = m;
+                    return true;
+                }
+            }
+            return false; //a collision, or a book for another board
+        }
+
+        bool Player::play(Board::Suit const &suit, Search::Result const &result)
+        {
+            if(!result.found)
+            {
+                std::clog << "Engine: " << suit << " has no moves" << std::endl;
+                return false;
+            }
+            if(result.nodes == 0)
+            {
+                std::clog << "Engine: " << suit << " played from the book" << std::endl;
+            }
+            else
+            {
+                std::clog << "Engine: " << suit << " searched " << result.nodes << " nodes on " << search->threadCount() << " threads to depth "
+                          << result.depth << ", score " << result.score << std::endl;
+            }
+            //the move lists of the copy match the board's, but look the move up to be safe
+            generate(board, suit, moves);
+            for(auto const &m : moves)
+            {
+                if(m.code() == result.move.code() && m.isCapture() == result.move.isCapture())
+                {
+                    return MoveGenerator::play(board, m);
+                }
+            }
+            std::cerr << "Engine: the move found for " << suit << " is not possible on the board" << std::endl;
+            return false;
+        }
+
+        bool Player::play(Board::Suit const &suit)
+        {
+            prepare();
+            return play(suit, think(suit));
+        }
+    }
+}
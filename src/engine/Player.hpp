@@ -0,0 +1,76 @@
+#ifndef ChessPlusPlus_Engine_PlayerClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_PlayerClass_HeaderPlusPlus
+
+#include "ParallelSearch.hpp"
+#include "Book.hpp"
+#include "RetrogradeTablebase.hpp"
+
+#include <set>
+#include <memory>
+#include <random>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Plays the suits that the "players" object in the board
+         * metadata assigns to "engine", e.g. {"Black": "engine"};
+         * every other suit is played by a human. The optional
+         * "engine" object sets "milliseconds" and "depth" per move,
+         * the "table megabytes" of the transposition table and the
+         * number of search "threads", 0 for one per core, and the
+         * "evaluation" config file, config/chesspp/evaluation.json
+         * by default, and the opening "book", config/chesspp/book.bin
+         * by default. Positions in the book are played from it with
+         * a chance by weight instead of being searched. The
+         * "tablebases" array lists tablebase files to probe during
+         * the search, made with chesspp_tablebase.
+         * The search runs on a copy of the board, so it can be run
+         * on another thread while the board is drawn.
+         */
+        class Player
+        {
+            Board &board;
+            Players_t players;
+            std::set<Board::Suit> engines;
+            config::EvaluationConfig evaluation_config;
+            Evaluation evaluation;
+            TranspositionTable table;
+            RetrogradeTablebase tablebase;
+            std::size_t threads;
+            Search::Limits limits;
+            std::unique_ptr<Board> position; //copy of the board being searched
+            std::unique_ptr<ParallelSearch> search;
+            MoveGenerator generate;
+            Moves_t moves;
+            Book book;
+            std::mt19937 random;
+
+            bool fromBook(Board::Suit const &suit, Search::Result &result);
+
+        public:
+            Player(config::BoardConfig const &config, Board &b);
+
+            bool controls(Board::Suit const &suit) const
+            {
+                return engines.find(suit) != engines.end();
+            }
+            //Copies the board for think(), call from the thread that changes the board
+            void prepare();
+            //Searches the copy made by prepare(), may be called from another thread
+            Search::Result think(Board::Suit const &suit);
+            //Can be called from another thread to end think() early
+            void stop() noexcept
+            {
+                if(search) search->stop();
+            }
+            //Plays the move of a result of think() on the board, returns false if there was none
+            bool play(Board::Suit const &suit, Search::Result const &result);
+            //Searches for and plays a move for the suit on this thread
+            bool play(Board::Suit const &suit);
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,428 @@
+#include "RetrogradeTablebase.hpp"
+
+#include "board/Castling.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <cstring>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        constexpr std::size_t RetrogradeTablebase::BlockSize;
+
+        namespace
+        {
+            static char const Magic[8] = {'C', 'P', 'P', 'T', 'B', 'L', '0', '1'};
+            class Header
+            {
+            public:
+                char magic[8];
+                std::uint32_t width, height;
+                std::uint32_t positions, blocks;
+                std::uint32_t material; //length of the material text that follows, padded to 8
+                std::uint32_t reserved;
+            };
+            static_assert(sizeof(Header) == 32, "tablebase headers are stored as they are in memory");
+
+            //A byte per position: 0 is a draw, 1 to 127 win in 2v-1 plies, 128 and up lose in 2(v-128) plies
+            static std::uint8_t win(unsigned plies) noexcept
+            {
+                return std::uint8_t((plies + 1)/2);
+            }
+            static std::uint8_t loss(unsigned plies) noexcept
+            {
+                return std::uint8_t(128 + plies/2);
+            }
+            static Tablebase::Result decode(std::uint8_t v) noexcept
+            {
+                Tablebase::Result r;
+                if(v >= 128)
+                {
+                    r.outcome = Tablebase::Outcome::Loss;
+                    r.distance = 2*(v - 128u);
+                }
+                else if(v > 0)
+                {
+                    r.outcome = Tablebase::Outcome::Win;
+                    r.distance = 2*v - 1u;
+                }
+                return r;
+            }
+            static constexpr unsigned MaxDistance = 254;
+
+            //A piece as the tables see it, pieces of a material are sorted this way
+            class Placed
+            {
+            public:
+                std::string token; //"Suit:Class"
+                std::size_t tile;
+
+                friend bool operator<(Placed const &a, Placed const &b) noexcept
+                {
+                    return std::tie(a.token, a.tile) < std::tie(b.token, b.tile);
+                }
+            };
+            static std::vector<Placed> placed(Board const &b)
+            {
+                std::vector<Placed> p;
+                for(auto const &piece : b)
+                {
+                    p.push_back(Placed{piece->suit + ":" + piece->pclass, std::size_t(piece->pos.y)*b.config.boardWidth() + piece->pos.x});
+                }
+                std::sort(p.begin(), p.end());
+                return p;
+            }
+            static std::string material(std::vector<Placed> const &p)
+            {
+                std::string m;
+                for(auto const &x : p)
+                {
+                    m += (m.empty()? "" : " ") + x.token;
+                }
+                return m;
+            }
+            static std::string material(RetrogradeTablebase::Material_t const &tokens)
+            {
+                std::string m;
+                for(auto const &t : tokens)
+                {
+                    m += (m.empty()? "" : " ") + t;
+                }
+                return m;
+            }
+            //The turn comes first, then the tile of each piece in order
+            static std::size_t index(std::vector<Placed> const &p, std::size_t turn, std::size_t tiles) noexcept
+            {
+                std::size_t i = 0;
+                for(auto it = p.rbegin(); it != p.rend(); ++it)
+                {
+                    i = i*tiles + it->tile;
+                }
+                return 2*i + turn;
+            }
+            static std::size_t suitIndex(config::BoardConfig const &config, Board::Suit const &suit)
+            {
+                auto const &suits = config.suits();
+                return std::size_t(std::distance(suits.begin(), suits.find(suit)));
+            }
+
+            /**
+             * Solves materials by building the graph of moves between
+             * every placement and walking it backwards one ply per round,
+             * so each result is at its shortest win or longest loss.
+             */
+            class Solver
+            {
+            public:
+                using Block_t = RetrogradeTablebase::Block_t;
+
+            private:
+                config::BoardConfig const &config;
+                Players_t players; //both suits in sorted order
+                std::size_t tiles;
+                MoveGenerator generate;
+                Moves_t moves;
+                std::map<std::string, Block_t> solved;
+
+                using Child_t = std::uint32_t;
+                static constexpr Child_t Constant = Child_t(1) << 31; //the low byte is the value
+
+            public:
+                Solver(config::BoardConfig const &c)
+                : config(c) //can't use {}
+                , tiles{std::size_t(c.boardWidth())*c.boardHeight()}
+                {
+                    std::size_t first = 0;
+                    players = engine::players(config, first);
+                }
+
+                Block_t const &solve(RetrogradeTablebase::Material_t const &m);
+            };
+
+            Solver::Block_t const &Solver::solve(RetrogradeTablebase::Material_t const &m)
+            {
+                auto found = solved.find(material(m));
+                if(found != solved.end()) return found->second;
+
+                //captures lead to smaller materials, royal pieces are never captured in legal positions
+                for(std::size_t j = 0; j < m.size(); ++j)
+                {
+                    if(m[j].substr(m[j].find(':') + 1) == "King") continue;
+                    auto smaller = m;
+                    smaller.erase(smaller.begin() + j);
+                    solve(smaller);
+                }
+
+                std::size_t placements = 1;
+                for(std::size_t j = 0; j < m.size(); ++j)
+                {
+                    if(placements > (Constant/2 - 1)/tiles)
+                    {
+                        throw Exception("too many positions for a tablebase of " + material(m));
+                    }
+                    placements *= tiles;
+                }
+                std::size_t const positions = 2*placements;
+
+                std::vector<Child_t> first (positions + 1, 0); //don't use {}
+                std::vector<Child_t> children;
+                Block_t value (positions, 0); //don't use {}
+                std::vector<bool> done (positions, false); //don't use {}
+                unsigned horizon = 0; //the longest distance of the smaller materials
+                std::vector<std::size_t> tile (m.size()); //don't use {}
+                for(std::size_t placement = 0; placement < placements; ++placement)
+                {
+                    std::size_t t = placement;
+                    for(auto &x : tile)
+                    {
+                        x = t%tiles;
+                        t /= tiles;
+                    }
+                    //only the sorted order of alike pieces is ever probed
+                    bool usable = true;
+                    for(std::size_t j = 0; j < m.size() && usable; ++j)
+                    {
+                        for(std::size_t k = j + 1; k < m.size() && usable; ++k)
+                        {
+                            usable = tile[j] != tile[k] && (m[j] != m[k] || tile[j] < tile[k]);
+                        }
+                    }
+                    if(!usable)
+                    {
+                        for(std::size_t turn = 0; turn < 2; ++turn)
+                        {
+                            first[2*placement + turn] = Child_t(children.size());
+                            done[2*placement + turn] = true;
+                        }
+                        continue;
+                    }
+
+                    config::BoardConfig::Layout_t layout;
+                    std::set<Board::Position_t> moved;
+                    for(std::size_t j = 0; j < m.size(); ++j)
+                    {
+                        using Size_t = Board::Position_t::value_type;
+                        Board::Position_t pos {Size_t(tile[j]%config.boardWidth()), Size_t(tile[j]/config.boardWidth())};
+                        auto colon = m[j].find(':');
+                        layout[pos] = std::make_pair(m[j].substr(colon + 1), m[j].substr(0, colon));
+                        moved.insert(pos);
+                    }
+                    Board board {config, layout, moved};
+                    for(std::size_t turn = 0; turn < 2; ++turn)
+                    {
+                        std::size_t const here = 2*placement + turn;
+                        first[here] = Child_t(children.size());
+                        generate(board, players[turn], moves);
+                        if(moves.empty())
+                        {
+                            done[here] = true;
+                            value[here] = generate.inCheck()? loss(0) : 0;
+                            continue;
+                        }
+                        for(auto const &move : moves)
+                        {
+                            if(move.isCapture())
+                            {
+                                auto victim = board.piece((board.pieceCapturables().begin() + move.capturable)->piece);
+                                if((*victim)->pclass == "King")
+                                {
+                                    children.push_back(Constant | loss(0)); //the position was not legal
+                                    continue;
+                                }
+                            }
+                            if(!MoveGenerator::make(board, move)) continue;
+                            auto after = placed(board);
+                            if(after.size() == m.size())
+                            {
+                                children.push_back(Child_t(index(after, 1 - turn, tiles)));
+                            }
+                            else
+                            {
+                                std::uint8_t v = solved.at(material(after))[index(after, 1 - turn, tiles)];
+                                horizon = std::max(horizon, decode(v).distance);
+                                children.push_back(Constant | v);
+                            }
+                            board.unmakeMove();
+                        }
+                    }
+                }
+                first[positions] = Child_t(children.size());
+
+                bool changed = true, changed_before = true;
+                for(unsigned r = 1; r <= MaxDistance && (changed || changed_before || r <= horizon + 1); ++r)
+                {
+                    changed_before = changed;
+                    changed = false;
+                    for(std::size_t p = 0; p < positions; ++p)
+                    {
+                        if(done[p]) continue;
+                        bool wins = false, loses = true;
+                        for(auto c = first[p]; c < first[p + 1] && !wins; ++c)
+                        {
+                            Child_t child = children[c];
+                            if(!(child & Constant) && !done[child])
+                            {
+                                loses = false;
+                                continue;
+                            }
+                            auto const result = decode(child & Constant? std::uint8_t(child) : value[child]);
+                            //results of this round are r plies away and don't count yet
+                            wins = result.outcome == Tablebase::Outcome::Loss && result.distance + 1 == r;
+                            loses = loses && result.outcome == Tablebase::Outcome::Win && result.distance < r;
+                        }
+                        if(wins || (loses && r%2 == 0 && first[p] < first[p + 1]))
+                        {
+                            value[p] = wins? win(r) : loss(r);
+                            done[p] = true;
+                            changed = true;
+                        }
+                    }
+                }
+                return solved[material(m)] = std::move(value); //what is left unsolved is a draw
+            }
+        }
+
+        RetrogradeTablebase::RetrogradeTablebase(std::vector<std::string> const &paths, std::size_t blocks)
+        : capacity{std::max<std::size_t>(blocks, 1)}
+        {
+            for(auto const &path : paths)
+            {
+                File f;
+                f.map = util::MappedFile{path};
+                if(!f.map.valid() || f.map.size() < sizeof(Header)) continue;
+                auto const *bytes = static_cast<unsigned char const *>(f.map.data());
+                Header const &h = *reinterpret_cast<Header const *>(bytes);
+                std::size_t const text = (h.material + 7)/8*8;
+                std::size_t const table = sizeof(Header) + text;
+                if(std::memcmp(h.magic, Magic, sizeof(Magic)) != 0
+                || h.blocks != (h.positions + BlockSize - 1)/BlockSize
+                || f.map.size() < table + (h.blocks + 1)*sizeof(std::uint64_t))
+                {
+                    continue;
+                }
+                f.id = std::uint32_t(files.size());
+                f.width = h.width;
+                f.height = h.height;
+                f.positions = h.positions;
+                f.offsets = reinterpret_cast<std::uint64_t const *>(bytes + table);
+                f.data = bytes + table + (h.blocks + 1)*sizeof(std::uint64_t);
+                if(f.offsets[h.blocks] > f.map.size() - std::size_t(f.data - bytes)) continue;
+
+                std::string m {reinterpret_cast<char const *>(bytes + sizeof(Header)), h.material};
+                std::size_t count = std::size_t(std::count(m.begin(), m.end(), ' ')) + 1;
+                most = std::max(most, count);
+                files.emplace(m, std::move(f));
+            }
+        }
+
+        std::uint8_t RetrogradeTablebase::value(File const &f, std::size_t index)
+        {
+            std::size_t const block = index/BlockSize;
+            std::uint64_t const key = std::uint64_t(f.id) << 32 | block;
+            std::lock_guard<std::mutex> guard {lock};
+            auto it = cached.find(key);
+            if(it != cached.end())
+            {
+                recent.splice(recent.begin(), recent, it->second);
+                return it->second->values[index%BlockSize];
+            }
+
+            //runs of a count and a value
+            Block_t values;
+            for(auto p = f.data + f.offsets[block]; p + 1 < f.data + f.offsets[block + 1]; p += 2)
+            {
+                values.insert(values.end(), p[0], p[1]);
+            }
+            values.resize(BlockSize, 0);
+            if(recent.size() >= capacity)
+            {
+                cached.erase(recent.back().key);
+                recent.pop_back();
+            }
+            recent.push_front(Cached{key, std::move(values)});
+            cached[key] = recent.begin();
+            return recent.front().values[index%BlockSize];
+        }
+
+        bool RetrogradeTablebase::probe(Board &b, Board::Suit const &turn, Result &result)
+        {
+            if(b.pieceCount() > most || b.config.suits().size() != 2) return false;
+            for(auto const &piece : b)
+            {
+                if(piece->pclass == "Pawn" && piece->moves < 2) return false;
+            }
+            if(b.getInteraction<board::Castling>().rights() != 0) return false;
+
+            auto p = placed(b);
+            auto f = files.find(material(p));
+            if(f == files.end() || f->second.width != b.config.boardWidth() || f->second.height != b.config.boardHeight()) return false;
+            std::size_t i = index(p, suitIndex(b.config, turn), std::size_t(b.config.boardWidth())*b.config.boardHeight());
+            if(i >= f->second.positions) return false;
+            result = decode(value(f->second, i));
+            return true;
+        }
+
+        void RetrogradeTablebase::generate(config::BoardConfig const &config, Material_t const &material_, std::string const &path)
+        {
+            if(config.suits().size() != 2)
+            {
+                throw Exception("tablebases need a board of two suits");
+            }
+            Material_t m = material_;
+            std::sort(m.begin(), m.end());
+            for(auto const &token : m)
+            {
+                auto colon = token.find(':');
+                if(colon == std::string::npos || config.suits().find(token.substr(0, colon)) == config.suits().end())
+                {
+                    throw Exception("\"" + token + "\" is not a Suit:Class of the board");
+                }
+            }
+
+            Solver solver {config};
+            auto const &value = solver.solve(m);
+
+            std::string text = material(m);
+            Header h;
+            std::memcpy(h.magic, Magic, sizeof(Magic));
+            h.width = config.boardWidth();
+            h.height = config.boardHeight();
+            h.positions = std::uint32_t(value.size());
+            h.blocks = std::uint32_t((value.size() + BlockSize - 1)/BlockSize);
+            h.material = std::uint32_t(text.size());
+            h.reserved = 0;
+            text.resize((text.size() + 7)/8*8, '\0');
+
+            std::vector<std::uint64_t> offsets {0};
+            std::vector<unsigned char> data;
+            for(std::size_t block = 0; block < h.blocks; ++block)
+            {
+                auto end = std::min(value.size(), (block + 1)*BlockSize);
+                for(std::size_t i = block*BlockSize; i < end; )
+                {
+                    std::size_t run = 1;
+                    while(i + run < end && run < 255 && value[i + run] == value[i]) ++run;
+                    data.push_back(static_cast<unsigned char>(run));
+                    data.push_back(value[i]);
+                    i += run;
+                }
+                offsets.push_back(data.size());
+            }
+
+            std::ofstream out {path, std::ios::binary};
+            out.write(reinterpret_cast<char const *>(&h), sizeof(h));
+            out.write(text.data(), std::streamsize(text.size()));
+            out.write(reinterpret_cast<char const *>(offsets.data()), std::streamsize(offsets.size()*sizeof(std::uint64_t)));
+            out.write(reinterpret_cast<char const *>(data.data()), std::streamsize(data.size()));
+            if(!out)
+            {
+                throw Exception("could not write " + path);
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef ChessPlusPlus_Engine_RetrogradeTablebaseClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_RetrogradeTablebaseClass_HeaderPlusPlus
+
+#include "Tablebase.hpp"
+#include "util/MappedFile.hpp"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Tablebases made by retrograde analysis of the board's own
+         * rules, so they work for any pieces and board size, e.g.
+         * Archer endings. One file holds one material, written as
+         * "Suit:Class" tokens such as "White:King White:Archer
+         * Black:King", for boards of two suits. Every placement of the
+         * pieces has one byte per suit to move, kept in blocks that
+         * are run-length encoded in the memory-mapped file; blocks
+         * are decoded on first use and the most recently used ones
+         * are kept. Pieces that can still castle, move a Pawn two
+         * tiles or be taken en passant are not covered, which is why
+         * the generator sets up every piece as having moved.
+         */
+        class RetrogradeTablebase : public Tablebase
+        {
+        public:
+            using Material_t = std::vector<std::string>; //"Suit:Class" tokens
+            using Block_t = std::vector<std::uint8_t>;
+            static constexpr std::size_t BlockSize = 4096; //positions per block
+
+        private:
+            class File
+            {
+            public:
+                util::MappedFile map;
+                std::uint32_t id;
+                std::uint32_t width, height;
+                std::uint64_t const *offsets; //of each block and the end
+                unsigned char const *data;
+                std::uint32_t positions;
+            };
+            std::unordered_map<std::string, File> files; //by material
+            std::size_t most = 0;                         //pieces of the largest material
+
+            class Cached
+            {
+            public:
+                std::uint64_t key; //file id and block
+                Block_t values;
+            };
+            std::mutex lock;
+            std::size_t capacity;
+            std::list<Cached> recent; //most recently used first
+            std::unordered_map<std::uint64_t, std::list<Cached>::iterator> cached;
+
+            std::uint8_t value(File const &f, std::size_t index);
+
+        public:
+            //Files that can't be read are skipped, the cache holds up to blocks decoded blocks
+            RetrogradeTablebase(std::vector<std::string> const &paths, std::size_t blocks = 256);
+
+            //The number of materials that were loaded
+            std::size_t size() const noexcept
+            {
+                return files.size();
+            }
+            virtual std::size_t pieces() const noexcept override
+            {
+                return most;
+            }
+            virtual bool probe(Board &b, Board::Suit const &turn, Result &result) override;
+
+            //Solves every placement of the material, and on the way whatever it
+            //reduces to by captures, then writes it; throws Exception if it can't
+            static void generate(config::BoardConfig const &config, Material_t const &material, std::string const &path);
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,267 @@
+#include "Search.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        namespace
+        {
+            using Score_t = Search::Score_t;
+
+            static constexpr Score_t Mated = Search::Mate - Score_t(Search::MaxPly); //every mate score is beyond this
+
+            //Keeps evaluations clear of mate scores
+            static Score_t clamp(Score_t s) noexcept
+            {
+                return std::max(-Mated, std::min(Mated, s));
+            }
+            //Mate scores are stored relative to the position rather than the root
+            static Score_t toTable(Score_t s, std::size_t ply) noexcept
+            {
+                return s > Mated? s + Score_t(ply) : s < -Mated? s - Score_t(ply) : s;
+            }
+            static Score_t fromTable(Score_t s, std::size_t ply) noexcept
+            {
+                return s > Mated? s - Score_t(ply) : s < -Mated? s + Score_t(ply) : s;
+            }
+        }
+
+        constexpr unsigned Search::MaxPly;
+        constexpr Search::Score_t Search::Infinity;
+        constexpr Search::Score_t Search::Mate;
+
+        Search::Search(Board &b, Players_t const &players_, TranspositionTable &table_, Evaluation const &evaluation_, Tablebase *tablebase_)
+        : board(b)                  //can't use {}
+        , players(players_)         //can't use {}
+        , table(table_)             //can't use {}
+        , evaluation(evaluation_)   //can't use {}
+        , tablebase{tablebase_}
+        , accumulator{evaluation_, players_}
+        , moves(MaxPly + 1)         //don't use {}
+        , order(MaxPly + 1)         //don't use {}
+        {
+            for(auto const &s : players)
+            {
+                turn_keys.push_back(board::Zobrist::turn(s));
+            }
+            std::memset(killers, 0, sizeof(killers));
+        }
+
+        bool Search::timeUp() noexcept
+        {
+            if(aborted) return true;
+            if(stopping || (limits.nodes && nodes >= limits.nodes))
+            {
+                aborted = true;
+            }
+            else if((nodes & 1023) == 0 && limits.time.count() && Clock_t::now() >= deadline)
+            {
+                aborted = true;
+            }
+            return aborted;
+        }
+
+        void Search::sort(std::size_t ply, std::uint32_t hashed)
+        {
+            auto &here = moves[ply];
+            auto &scores = order[ply];
+            scores.resize(here.size());
+            auto capturings = board.pieceCapturings();
+            auto capturables = board.pieceCapturables();
+            for(std::size_t i = 0; i < here.size(); ++i)
+            {
+                Move const &m = here[i];
+                std::int64_t s = 0;
+                if(hashed && m.code() == hashed)
+                {
+                    s = std::int64_t(1) << 62;
+                }
+                else if(m.isCapture()) //most valuable victim, then least valuable attacker
+                {
+                    std::int64_t victim = evaluation.value(capturables.begin()[m.capturable].piece);
+                    std::int64_t attacker = evaluation.value(capturings.begin()[m.target].piece);
+                    s = (std::int64_t(1) << 40) + victim*(std::int64_t(1) << 20) - attacker;
+                }
+                else if(ply < MaxPly && m.code() == killers[ply][0])
+                {
+                    s = 2;
+                }
+                else if(ply < MaxPly && m.code() == killers[ply][1])
+                {
+                    s = 1;
+                }
+                scores[i] = s;
+            }
+            //few moves, insertion sort keeps the generation order for ties
+            for(std::size_t i = 1; i < here.size(); ++i)
+            {
+                for(std::size_t j = i; j > 0 && scores[j - 1] < scores[j]; --j)
+                {
+                    std::swap(scores[j - 1], scores[j]);
+                    std::swap(here[j - 1], here[j]);
+                }
+            }
+        }
+
+        Search::Score_t Search::alphaBeta(std::size_t turn, int depth, Score_t alpha, Score_t beta, std::size_t ply)
+        {
+            if(depth <= 0 || ply >= MaxPly)
+            {
+                return quiescence(turn, alpha, beta, ply);
+            }
+            ++nodes;
+            if(timeUp()) return 0;
+
+            //a position the line already went through would be repeated again, so it's a draw
+            if(ply > 0 && (board.repetitions() > 0 || draw(board) == Draw::FiftyMoves))
+            {
+                return 0;
+            }
+
+            auto const key = board.hash() ^ turn_keys[turn];
+            std::uint32_t hashed = 0;
+            {
+                TranspositionTable::Entry e;
+                if(table.probe(key, e))
+                {
+                    hashed = e.move;
+                    Score_t score = fromTable(e.score, ply);
+                    if(ply > 0 && e.depth >= depth)
+                    {
+                        if(e.bound == TranspositionTable::Bound::Exact) return score;
+                        if(e.bound == TranspositionTable::Bound::Lower && score >= beta) return score;
+                        if(e.bound == TranspositionTable::Bound::Upper && score <= alpha) return score;
+                    }
+                }
+            }
+
+            Tablebase::Result known;
+            if(ply > 0 && tablebase && board.pieceCount() <= tablebase->pieces() && tablebase->probe(board, players[turn], known))
+            {
+                Score_t const mated = Score_t(ply + known.distance);
+                if(known.outcome == Tablebase::Outcome::Win) return Mate - mated;
+                if(known.outcome == Tablebase::Outcome::Loss) return -Mate + mated;
+                return 0;
+            }
+
+            auto &here = moves[ply];
+            generate(board, players[turn], here);
+            if(here.empty())
+            {
+                return generate.inCheck()? -Mate + Score_t(ply) : 0;
+            }
+            sort(ply, hashed);
+
+            Score_t const original = alpha;
+            Score_t best_score = -Infinity;
+            std::uint32_t best_code = 0;
+            for(std::size_t i = 0; i < here.size(); ++i)
+            {
+                Move const m = here[i];
+                if(!MoveGenerator::make(board, m)) continue;
+                accumulator.make(board);
+                Score_t score = -alphaBeta(next(turn), depth - 1, -beta, -alpha, ply + 1);
+                board.unmakeMove();
+                accumulator.unmake();
+                if(aborted) return 0;
+
+                if(score > best_score)
+                {
+                    best_score = score;
+                    best_code = m.code();
+                    if(ply == 0) best = m;
+                }
+                if(score > alpha) alpha = score;
+                if(alpha >= beta)
+                {
+                    if(!m.isCapture() && killers[ply][0] != m.code())
+                    {
+                        killers[ply][1] = killers[ply][0];
+                        killers[ply][0] = m.code();
+                    }
+                    break;
+                }
+            }
+            if(best_score == -Infinity) //no move could be made
+            {
+                return clamp(accumulator.evaluate(turn));
+            }
+
+            TranspositionTable::Entry e;
+            e.move = best_code;
+            e.score = TranspositionTable::Score_t(toTable(best_score, ply));
+            e.depth = std::uint8_t(depth);
+            e.bound = (best_score <= original)? TranspositionTable::Bound::Upper
+                    : (best_score >= beta)?     TranspositionTable::Bound::Lower
+                    :                           TranspositionTable::Bound::Exact;
+            table.store(key, e);
+            return best_score;
+        }
+
+        Search::Score_t Search::quiescence(std::size_t turn, Score_t alpha, Score_t beta, std::size_t ply)
+        {
+            ++nodes;
+            if(timeUp()) return 0;
+
+            Score_t stand = clamp(accumulator.evaluate(turn));
+            if(stand >= beta || ply >= MaxPly) return stand;
+            if(stand > alpha) alpha = stand;
+
+            auto &here = moves[ply];
+            generate(board, players[turn], here, true);
+            sort(ply, 0);
+
+            for(std::size_t i = 0; i < here.size(); ++i)
+            {
+                if(!MoveGenerator::make(board, here[i])) continue;
+                accumulator.make(board);
+                Score_t score = -quiescence(next(turn), -beta, -alpha, ply + 1);
+                board.unmakeMove();
+                accumulator.unmake();
+                if(aborted) return 0;
+                if(score > alpha)
+                {
+                    alpha = score;
+                    if(alpha >= beta) break;
+                }
+            }
+            return alpha;
+        }
+
+        Search::Result Search::run(std::size_t turn, Limits const &l)
+        {
+            limits = l;
+            aborted = false;
+            nodes = 0;
+            deadline = Clock_t::now() + limits.time;
+            std::memset(killers, 0, sizeof(killers));
+            accumulator.reset(board);
+
+            Result result;
+            generate(board, players[turn], moves[0]);
+            if(moves[0].empty())
+            {
+                stopping = false;
+                return result;
+            }
+            //something to play even if the first iteration is cut short
+            result.found = true;
+            result.move = moves[0].front();
+
+            for(unsigned depth = std::max(limits.first, 1u); depth <= limits.depth && depth <= MaxPly; ++depth)
+            {
+                Score_t score = alphaBeta(turn, int(depth), -Infinity, Infinity, 0);
+                if(aborted) break;
+                result.move = best;
+                result.score = score;
+                result.depth = depth;
+            }
+            result.nodes = nodes;
+            stopping = false; //not at the start, so a stop() before run() still ends it
+            return result;
+        }
+    }
+}
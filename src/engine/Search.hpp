@@ -0,0 +1,104 @@
+#ifndef ChessPlusPlus_Engine_AlphaBetaSearchClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_AlphaBetaSearchClass_HeaderPlusPlus
+
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Evaluation.hpp"
+#include "Tablebase.hpp"
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Iterative deepening alpha-beta (negamax) search with a
+         * quiescence search over captures. With more than two suits
+         * each opponent is assumed to play against the suit to move.
+         * Moves are tried in order of the transposition table move,
+         * captures by most valuable victim and least valuable attacker,
+         * then killer moves. A suit with no legal moves is mated if
+         * in check and stalemated otherwise. Positions the tablebase
+         * covers are scored from it instead of being searched, and
+         * a position that occurred before, or is reached after fifty
+         * moves without a capture or Pawn move, is scored as a draw.
+         */
+        class Search
+        {
+        public:
+            using Score_t = Evaluation::Score_t;
+            using Nodes_t = std::uint64_t;
+            using Clock_t = std::chrono::steady_clock;
+
+            static constexpr unsigned MaxPly = 64;
+            static constexpr Score_t Infinity = 30000;
+            static constexpr Score_t Mate = Infinity - 1; //less the ply of the mated position
+
+            class Limits
+            {
+            public:
+                unsigned depth = MaxPly;
+                unsigned first = 1;                    //depth of the first iteration
+                std::chrono::milliseconds time {1000}; //zero for no limit
+                Nodes_t nodes = 0;                     //zero for no limit
+            };
+            class Result
+            {
+            public:
+                bool found = false; //false if the suit had no moves
+                Move move;
+                Score_t score = 0;
+                unsigned depth = 0; //of the last completed iteration
+                Nodes_t nodes = 0;
+            };
+
+        private:
+            Board &board;
+            Players_t const &players;
+            TranspositionTable &table;
+            Evaluation const &evaluation;
+            Tablebase *tablebase;
+            Evaluation::Accumulator accumulator;
+            MoveGenerator generate;
+            std::vector<TranspositionTable::Key_t> turn_keys; //by player
+            std::vector<Moves_t> moves;                      //by ply, reused
+            std::vector<std::vector<std::int64_t>> order;    //by ply, reused
+            std::uint32_t killers[MaxPly][2];
+
+            std::atomic<bool> stopping {false};
+            bool aborted = false;
+            Limits limits;
+            Clock_t::time_point deadline;
+            Nodes_t nodes = 0;
+            Move best;
+
+            bool timeUp() noexcept;
+            void sort(std::size_t ply, std::uint32_t hashed);
+            Score_t alphaBeta(std::size_t turn, int depth, Score_t alpha, Score_t beta, std::size_t ply);
+            Score_t quiescence(std::size_t turn, Score_t alpha, Score_t beta, std::size_t ply);
+            std::size_t next(std::size_t turn) const noexcept
+            {
+                return (turn + 1)%players.size();
+            }
+
+        public:
+            //The evaluation must have been prepared for the board, the tablebase is optional
+            Search(Board &b, Players_t const &players, TranspositionTable &table, Evaluation const &evaluation, Tablebase *tablebase = nullptr);
+
+            //Call TranspositionTable::nextSearch() first, once for all threads sharing the table
+            Result run(std::size_t turn, Limits const &limits);
+            //Can be called from another thread to end run() early, a stop() just before run() ends it at once
+            void stop() noexcept
+            {
+                stopping = true;
+            }
+        };
+    }
+}
+
+#endif
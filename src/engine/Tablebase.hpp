@@ -0,0 +1,47 @@
+#ifndef ChessPlusPlus_Engine_TablebaseInterface_HeaderPlusPlus
+#define ChessPlusPlus_Engine_TablebaseInterface_HeaderPlusPlus
+
+#include "MoveGenerator.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Exact results of endgame positions, looked up rather than
+         * searched. Each kind of tablebase file gets its own derived
+         * class; the search probes whichever one the Player set up at
+         * every node with few enough pieces, so probing must not wait
+         * on the disk and may happen on several threads at once.
+         */
+        class Tablebase
+        {
+        public:
+            enum class Outcome : std::int8_t
+            {
+                Loss = -1,
+                Draw = 0,
+                Win = 1
+            };
+            //For the suit to move
+            class Result
+            {
+            public:
+                Outcome outcome = Outcome::Draw;
+                unsigned distance = 0; //plies to mate with best play, 0 for a draw
+            };
+
+            virtual ~Tablebase() = default;
+
+            //The most pieces of any position covered, so most nodes can skip probe()
+            virtual std::size_t pieces() const noexcept = 0;
+            //Returns false if the position is not covered
+            virtual bool probe(Board &b, Board::Suit const &turn, Result &result) = 0;
+        };
+    }
+}
+
+#endif
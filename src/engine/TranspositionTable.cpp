@@ -0,0 +1,99 @@
+#include "TranspositionTable.hpp"
+
+#include <new>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        constexpr std::size_t TranspositionTable::LineSize;
+        constexpr std::size_t TranspositionTable::Slots;
+
+        //data layout: move 32 bits, score 16, depth 8, bound 2, age 6
+        std::uint64_t TranspositionTable::pack(Entry const &e, std::uint8_t age) noexcept
+        {
+            return std::uint64_t(e.move)
+                 | std::uint64_t(std::uint16_t(e.score)) << 32
+                 | std::uint64_t(e.depth) << 48
+                 | std::uint64_t(static_cast<std::uint8_t>(e.bound) & 0x3) << 56
+                 | std::uint64_t(age & 0x3F) << 58;
+        }
+        TranspositionTable::Entry TranspositionTable::unpack(std::uint64_t data) noexcept
+        {
+            Entry e;
+            e.move = std::uint32_t(data);
+            e.score = Score_t(std::uint16_t(data >> 32));
+            e.depth = std::uint8_t(data >> 48);
+            e.bound = static_cast<Bound>((data >> 56) & 0x3);
+            return e;
+        }
+
+        TranspositionTable::TranspositionTable(std::size_t megabytes)
+        {
+            std::size_t count = 1;
+            while(count*2*sizeof(Bucket) <= megabytes*1024*1024) count *= 2;
+            storage.reset(new unsigned char[count*sizeof(Bucket) + LineSize]);
+            auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+            address = (address + LineSize - 1)/LineSize*LineSize;
+            buckets = reinterpret_cast<Bucket *>(address);
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                ::new(buckets + i) Bucket;
+            }
+            mask = count - 1;
+            clear();
+        }
+
+        bool TranspositionTable::probe(Key_t key, Entry &e) const noexcept
+        {
+            Bucket const &b = buckets[key & mask];
+            for(std::size_t i = 0; i < Slots; ++i)
+            {
+                std::uint64_t data = b.data[i].load(std::memory_order_relaxed);
+                if((b.check[i].load(std::memory_order_relaxed) ^ data) == key && data != 0)
+                {
+                    e = unpack(data);
+                    return true;
+                }
+            }
+            return false;
+        }
+        void TranspositionTable::store(Key_t key, Entry const &e) noexcept
+        {
+            Bucket &b = buckets[key & mask];
+            //replace the same position, else the entry from the oldest search, else the shallowest
+            std::size_t victim = 0;
+            int worst = 0x7FFFFFFF;
+            for(std::size_t i = 0; i < Slots; ++i)
+            {
+                std::uint64_t data = b.data[i].load(std::memory_order_relaxed);
+                if((b.check[i].load(std::memory_order_relaxed) ^ data) == key)
+                {
+                    victim = i;
+                    break;
+                }
+                int stale = (age - int(data >> 58)) & 0x3F;
+                int value = int((data >> 48) & 0xFF) - 4*stale;
+                if(value < worst)
+                {
+                    worst = value;
+                    victim = i;
+                }
+            }
+            std::uint64_t data = pack(e, age);
+            b.data[victim].store(data, std::memory_order_relaxed);
+            b.check[victim].store(key ^ data, std::memory_order_relaxed);
+        }
+        void TranspositionTable::clear() noexcept
+        {
+            for(std::size_t i = 0; i <= mask; ++i)
+            {
+                for(std::size_t j = 0; j < Slots; ++j)
+                {
+                    buckets[i].check[j].store(0, std::memory_order_relaxed);
+                    buckets[i].data[j].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef ChessPlusPlus_Engine_TranspositionTableClass_HeaderPlusPlus
+#define ChessPlusPlus_Engine_TranspositionTableClass_HeaderPlusPlus
+
+#include "board/Zobrist.hpp"
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace engine
+    {
+        /**
+         * Fixed-size transposition table keyed by Zobrist hash.
+         * Entries are grouped in buckets of one cache line, and each
+         * entry is stored as its data and its data XOR its key, so
+         * that threads can share the table without locks: an entry
+         * torn by a concurrent write simply fails to match its key.
+         */
+        class TranspositionTable
+        {
+        public:
+            using Key_t = board::Zobrist::Key_t;
+            using Score_t = std::int16_t;
+            enum class Bound : std::uint8_t
+            {
+                None,
+                Exact,
+                Lower, //the score is at least this, the search failed high
+                Upper  //the score is at most this, the search failed low
+            };
+            class Entry
+            {
+            public:
+                std::uint32_t move = 0; //Move::code() of the best move, 0 for none
+                Score_t score = 0;
+                std::uint8_t depth = 0;
+                Bound bound = Bound::None;
+            };
+
+        private:
+            static constexpr std::size_t LineSize = 64;
+            static constexpr std::size_t Slots = LineSize/(2*sizeof(std::uint64_t));
+            class Bucket
+            {
+            public:
+                std::atomic<std::uint64_t> check[Slots]; //key ^ data
+                std::atomic<std::uint64_t> data[Slots];
+            };
+            static_assert(sizeof(Bucket) == LineSize, "a bucket must fill one cache line");
+
+            std::unique_ptr<unsigned char[]> storage;
+            Bucket *buckets = nullptr;
+            std::size_t mask = 0; //bucket count - 1
+            std::uint8_t age = 0; //kept in the low 6 bits of each entry
+
+            static std::uint64_t pack(Entry const &e, std::uint8_t age) noexcept;
+            static Entry unpack(std::uint64_t data) noexcept;
+
+        public:
+            //The number of buckets is rounded down to a power of two
+            explicit TranspositionTable(std::size_t megabytes);
+            TranspositionTable(TranspositionTable const &) = delete;
+            TranspositionTable &operator=(TranspositionTable const &) = delete;
+
+            bool probe(Key_t key, Entry &e) const noexcept;
+            void store(Key_t key, Entry const &e) noexcept;
+
+            //Ages existing entries so they are replaced first, call before each search
+            void nextSearch() noexcept
+            {
+                age = std::uint8_t((age + 1) & 0x3F);
+            }
+            void clear() noexcept;
+        };
+    }
+}
+
+#endif
@@ -1,95 +1,196 @@
 #include "Graphics.hpp"
 
-#include "res/SfmlFileResource.hpp"
 #include "config/Configuration.hpp"
+#include "util/Profiler.hpp"
+#include "util/Allocations.hpp"
 
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 namespace chesspp
 {
     namespace gfx
     {
-        using Texture_res = res::SfmlFileResource<sf::Texture>;
-        GraphicsHandler::GraphicsHandler(sf::RenderWindow &disp, config::ResourcesConfig &resc, config::BoardConfig &bc)
+        namespace
+        {
+            static std::string path(config::ResourcesConfig &resc, char const *name)
+            {
+                return std::string(resc.setting("board", name));
+            }
+            static TextureAtlas pack(config::ResourcesConfig &resc, config::BoardConfig &bc, res::ImageLoader *preloaded)
+            {
+                auto paths = GraphicsHandler::manifest(resc);
+                for(auto const &suit : bc.texturePaths())
+                {
+                    for(auto const &piece : suit.second)
+                    {
+                        paths.push_back(piece.second);
+                    }
+                }
+                res::ImageLoader::Images_t images;
+                if(preloaded)
+                {
+                    images = preloaded->take();
+                }
+                std::vector<std::string> late;
+                for(auto const &file : paths)
+                {
+                    if(images.find(file) == images.end()) late.push_back(file);
+                }
+                if(!late.empty())
+                {
+                    for(auto &image : res::ImageLoader{late}.take())
+                    {
+                        images.insert(std::move(image));
+                    }
+                }
+                return TextureAtlas{paths, images};
+            }
+        }
+
+        std::vector<std::string> GraphicsHandler::manifest(config::ResourcesConfig &resc)
+        {
+            std::vector<std::string> paths;
+            for(auto name : {"board", "valid move", "enemy move", "valid capture", "enemy capture"})
+            {
+                paths.push_back(path(resc, name));
+            }
+            paths.push_back(std::string(resc.setting("")));
+            for(auto const &suit : resc.setting("board", "pieces").object())
+            {
+                if(suit.second.type() != json_object) continue;
+                for(auto const &piece : suit.second.object())
+                {
+                    paths.push_back(std::string(piece.second));
+                }
+            }
+            return paths;
+        }
+
+        GraphicsHandler::GraphicsHandler(sf::RenderTarget &disp, config::ResourcesConfig &resc, config::BoardConfig &bc, res::ImageLoader *preloaded)
         : display(disp)         //can't use {}
         , res_config(resc)      //can't use {}
         , board_config(bc)      //can't use {}
-        , res(resc.resources()) //can't use {}
-        , board        {res.from_config<Texture_res>("board", "board"        )}
-        , valid_move   {res.from_config<Texture_res>("board", "valid move"   )}
-        , enemy_move   {res.from_config<Texture_res>("board", "enemy move"   )}
-        , valid_capture{res.from_config<Texture_res>("board", "valid capture")}
-        , enemy_capture{res.from_config<Texture_res>("board", "enemy capture")}
+        , atlas{pack(resc, bc, preloaded)}
+        , board        {atlas.region(path(resc, "board"        ))}
+        , valid_move   {atlas.region(path(resc, "valid move"   ))}
+        , enemy_move   {atlas.region(path(resc, "enemy move"   ))}
+        , valid_capture{atlas.region(path(resc, "valid capture"))}
+        , enemy_capture{atlas.region(path(resc, "enemy capture"))}
+        , missing      {atlas.region(std::string(resc.setting("")))}
         {
         }
 
-        void GraphicsHandler::drawBackground()
+        sf::IntRect const &GraphicsHandler::region(board::Piece const &p)
         {
-            display.draw(board);
+            auto const &texture = p.texture();
+            auto it = textures.find(&texture);
+            if(it == textures.end())
+            {
+                if(!atlas.contains(texture))
+                {
+                    std::cerr << "Texture \"" << texture << "\" of " << p << " is not in resources.json" << std::endl;
+                }
+                it = textures.emplace(&texture, atlas.contains(texture)? atlas.region(texture) : missing).first;
+            }
+            return it->second;
         }
-        void GraphicsHandler::drawSpriteAtCell(sf::Sprite &s, std::size_t x, std::size_t y)
+        void GraphicsHandler::add(sf::VertexArray &layer, sf::IntRect const &r, sf::Vector2f const &at)
         {
-            s.setPosition(x*board_config.cellWidth(), y*board_config.cellHeight());
-            display.draw(s);
+            float const w = float(r.width), h = float(r.height);
+            float const u = float(r.left), v = float(r.top);
+            layer.append(sf::Vertex(at,                        sf::Vector2f(u,     v    )));
+            layer.append(sf::Vertex(at + sf::Vector2f(w, 0.f), sf::Vector2f(u + w, v    )));
+            layer.append(sf::Vertex(at + sf::Vector2f(w, h),   sf::Vector2f(u + w, v + h)));
+            layer.append(sf::Vertex(at + sf::Vector2f(0.f, h), sf::Vector2f(u,     v + h)));
+        }
+        void GraphicsHandler::addAtCell(sf::VertexArray &layer, sf::IntRect const &r, std::size_t x, std::size_t y)
+        {
+            add(layer, r, sf::Vector2f(float(x*board_config.cellWidth()), float(y*board_config.cellHeight())));
+        }
+
+        void GraphicsHandler::drawBackground()
+        {
+            add(pieces, board, sf::Vector2f(0.f, 0.f));
         }
         void GraphicsHandler::drawPiece(board::Piece const &p)
         {
-            sf::Sprite piece {res.from_path<Texture_res>(p.texture())};
-            drawSpriteAtCell(piece, p.pos.x, p.pos.y);
+            addAtCell(pieces, region(p), p.pos.x, p.pos.y);
         }
         void GraphicsHandler::drawPieceAt(board::Piece const &p, sf::Vector2i const &pos)
         {
-            sf::Sprite piece {res.from_path<Texture_res>(p.texture())};
-            piece.setPosition(pos.x - (board_config.cellWidth()/2), pos.y - (board_config.cellHeight()/2));
-            display.draw(piece);
+            add(overlay, region(p), sf::Vector2f(float(pos.x - (board_config.cellWidth()/2)), float(pos.y - (board_config.cellHeight()/2))));
         }
-        void GraphicsHandler::drawTrajectory(board::Piece const &p, bool enemy)
+        GraphicsHandler::Highlights const &GraphicsHandler::highlightsOf(board::Piece const &p)
         {
+            auto const &b = p.board;
+            auto tile = [&](board::Board::Position_t const &pos)
+            {
+                return std::size_t(pos.y)*b.config.boardWidth() + pos.x;
+            };
+            if(highlighted != &b || revision != b.revision())
             {
-                auto &sprite = (enemy? enemy_move : valid_move);
-                for(auto const &it : p.board.pieceTrajectory(p))
+                highlighted = &b;
+                revision = b.revision();
+                highlights.assign(highlights.size(), Highlights{});
+                capturable.assign(std::size_t(b.config.boardWidth())*b.config.boardHeight(), {});
+                for(auto const &c : b.pieceCapturables())
                 {
-                    if(!p.board.occupied(it.second))
-                    {
-                        if(std::find_if(p.board.pieceCapturables().begin(),
-                                        p.board.pieceCapturables().end(),
-                                        [&](board::Board::Movements_t::value_type const &m)
-                                        {
-                                            return m.second == it.second && (*m.first)->suit != p.suit;
-                                        }) == p.board.pieceCapturables().end())
-                        {
-                            drawSpriteAtCell(sprite, it.second.x, it.second.y);
-                        }
-                    }
+                    capturable[tile(c.tile)].push_back((*b.piece(c.piece))->suit);
                 }
             }
+            if(p.index >= highlights.size())
+            {
+                highlights.resize(std::size_t(p.index) + 1);
+            }
+            auto &h = highlights[p.index];
+            if(h.cached) return h;
+
+            auto enemy = [&](board::Board::Position_t const &pos)
+            {
+                auto const &suits = capturable[tile(pos)];
+                return std::find_if(suits.begin(), suits.end(), [&](board::Suit const &s){ return s != p.suit; }) != suits.end();
+            };
+            for(auto const &it : b.pieceTrajectory(p))
             {
-                auto &sprite = (enemy? enemy_capture : valid_capture);
-                for(auto const &it : p.board.pieceCapturing(p))
+                if(!b.occupied(it.tile) && !enemy(it.tile))
                 {
-                    for(auto const &c : p.board.pieceCapturables())
-                    {
-                        if(c.second == it.second && (*c.first)->suit != p.suit)
-                        {
-                            drawSpriteAtCell(sprite, it.second.x, it.second.y);
-                            auto jt = std::find_if(p.board.pieceTrajectories().begin(),
-                                                   p.board.pieceTrajectories().end(),
-                                                   [&](board::Board::Movements_t::value_type const &m)
-                                                   {
-                                                       return (*m.first)->pos == it.second;
-                                                   });
-                            if(jt != p.board.pieceTrajectories().end())
-                            {
-                                drawPiece(**(jt->first)); //redraw
-                            }
-                            break;
-                        }
-                    }
+                    h.moves.push_back(it.tile);
+                }
+            }
+            for(auto const &it : b.pieceCapturing(p))
+            {
+                if(enemy(it.tile))
+                {
+                    h.captures.push_back(it.tile);
+                }
+            }
+            h.cached = true;
+            return h;
+        }
+        void GraphicsHandler::drawTrajectory(board::Piece const &p, bool enemy)
+        {
+            CHESSPP_PROFILE_SCOPE("GraphicsHandler::drawTrajectory");
+            CHESSPP_PROFILE_ALLOCATIONS("GraphicsHandler::drawTrajectory");
+            auto const &h = highlightsOf(p);
+            for(auto const &tile : h.moves)
+            {
+                addAtCell(overlay, enemy? enemy_move : valid_move, tile.x, tile.y);
+            }
+            for(auto const &tile : h.captures)
+            {
+                addAtCell(overlay, enemy? enemy_capture : valid_capture, tile.x, tile.y);
+                if(p.board.occupied(tile))
+                {
+                    addAtCell(overlay, region(**p.board.pieceAt(tile)), tile.x, tile.y); //redraw over the capture
                 }
             }
         }
         void GraphicsHandler::drawBoard(board::Board const &b)
         {
+            CHESSPP_PROFILE_SCOPE("GraphicsHandler::drawBoard");
+            CHESSPP_PROFILE_ALLOCATIONS("GraphicsHandler::drawBoard");
             drawBackground();
 
             for(auto const &pp : b)
@@ -97,5 +198,16 @@ namespace chesspp
                 drawPiece(*pp);
             }
         }
+
+        void GraphicsHandler::flush()
+        {
+            CHESSPP_PROFILE_SCOPE("GraphicsHandler::flush");
+            sf::RenderStates states {&atlas.getTexture()};
+            display.draw(pieces, states);
+            display.draw(overlay, states);
+            CHESSPP_PROFILE_COUNT("draw calls", 2);
+            pieces.clear();
+            overlay.clear();
+        }
     }
 }
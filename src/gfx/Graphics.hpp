@@ -2,42 +2,78 @@
 #define ChessPlusPlus_Gfx_GraphicsHandlerClass_HeaderPlusPlus
 
 #include "SFML.hpp"
+#include "TextureAtlas.hpp"
+#include "res/ImageLoader.hpp"
 #include "config/ResourcesConfig.hpp"
 #include "config/BoardConfig.hpp"
 #include "board/Board.hpp"
 
 #include <map>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <cstdint>
 
 namespace chesspp
 {
     namespace gfx
     {
+        /**
+         * Draws the board from one texture atlas of every image in
+         * resources.json, decoded ahead of time by an ImageLoader of
+         * the manifest() when there is one. The draw functions only queue quads into a
+         * board layer and an overlay layer, flush() then draws each
+         * layer with a single draw call. The tiles highlighted for a
+         * piece are worked out once per revision of the board.
+         */
         class GraphicsHandler
         {
-            sf::RenderWindow &display;
+            sf::RenderTarget &display; //the window, or a texture to draw offscreen
             config::ResourcesConfig &res_config;
             config::BoardConfig &board_config;
-            res::ResourceManager &res;
+            TextureAtlas atlas;
 
-            sf::Sprite board
-            ,          valid_move
-            ,          enemy_move
-            ,          valid_capture
-            ,          enemy_capture;
+            sf::IntRect board
+            ,           valid_move
+            ,           enemy_move
+            ,           valid_capture
+            ,           enemy_capture
+            ,           missing;
+            std::unordered_map<std::string const *, sf::IntRect> textures; //by what Piece::texture() returns
+
+            sf::VertexArray pieces  {sf::Quads}; //the board and its pieces
+            sf::VertexArray overlay {sf::Quads}; //trajectories and what is drawn over them
+
+            class Highlights
+            {
+            public:
+                bool cached = false;
+                std::vector<board::Board::Position_t> moves, captures;
+            };
+            board::Board const *highlighted = nullptr;
+            std::uint64_t revision = 0;
+            std::vector<std::vector<board::Suit>> capturable; //by tile, the suits that can be captured there
+            std::vector<Highlights> highlights;               //by piece index
+
+            sf::IntRect const &region(board::Piece const &p);
+            Highlights const &highlightsOf(board::Piece const &p);
+            void add(sf::VertexArray &layer, sf::IntRect const &r, sf::Vector2f const &at);
+            void addAtCell(sf::VertexArray &layer, sf::IntRect const &r, std::size_t x, std::size_t y);
 
         public:
-            GraphicsHandler(sf::RenderWindow &display, config::ResourcesConfig &resc, config::BoardConfig &bc);
+            //Images the preloader didn't decode are decoded now
+            GraphicsHandler(sf::RenderTarget &display, config::ResourcesConfig &resc, config::BoardConfig &bc, res::ImageLoader *preloaded = nullptr);
+
+            //The images resources.json lists for the board
+            static std::vector<std::string> manifest(config::ResourcesConfig &resc);
 
             //Draws the board background.
             void drawBackground();
 
-            //Draws any sprite in the center of cell at (x, y).
-            void drawSpriteAtCell(sf::Sprite &s, std::size_t x, std::size_t y);
-
             //Draws a piece
             void drawPiece(board::Piece const &p);
 
-            //Separate version of drawPiece to draw a piece at any location on the screen.
+            //Separate version of drawPiece to draw a piece at any location on the screen, over the board.
             void drawPieceAt(board::Piece const &p, sf::Vector2i const &pos);
 
             //draws the trajectory and captures for the piece
@@ -45,6 +81,9 @@ namespace chesspp
 
             //Draws the board and pieces
             void drawBoard(board::Board const &b);
+
+            //Draws what was queued since the last flush
+            void flush();
         };
     }
 }
@@ -0,0 +1,71 @@
+#include "TextureAtlas.hpp"
+#include "util/Profiler.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace chesspp
+{
+    namespace gfx
+    {
+        TextureAtlas::TextureAtlas(std::vector<std::string> const &paths, res::ImageLoader::Images_t const &images)
+        {
+            CHESSPP_PROFILE_SCOPE("TextureAtlas pack");
+            unsigned widest = 0;
+            std::vector<std::string> order;
+            for(auto const &path : paths)
+            {
+                if(regions.find(path) != regions.end()) continue;
+                auto image = images.find(path);
+                if(image == images.end())
+                {
+                    regions[path] = sf::IntRect{};
+                    continue;
+                }
+                widest = std::max(widest, image->second.getSize().x);
+                regions[path] = sf::IntRect{};
+                order.push_back(path);
+            }
+
+            std::stable_sort(order.begin(), order.end(), [&](std::string const &a, std::string const &b)
+            {
+                return images.at(a).getSize().y > images.at(b).getSize().y;
+            });
+
+            //shelves as wide as the widest image, or wider to keep the texture squarish
+            unsigned const width = std::min(std::max(widest, 1024u), sf::Texture::getMaximumSize());
+            unsigned x = 0, y = 0, shelf = 0;
+            for(auto const &path : order)
+            {
+                auto size = images.at(path).getSize();
+                if(x + size.x > width)
+                {
+                    x = 0;
+                    y += shelf + 1;
+                    shelf = 0;
+                }
+                regions[path] = sf::IntRect(int(x), int(y), int(size.x), int(size.y));
+                x += size.x + 1;
+                shelf = std::max(shelf, size.y);
+            }
+
+            sf::Image packed;
+            packed.create(std::max(width, 1u), std::max(y + shelf, 1u), sf::Color::Transparent);
+            for(auto const &path : order)
+            {
+                auto const &r = regions[path];
+                packed.copy(images.at(path), unsigned(r.left), unsigned(r.top));
+            }
+            if(!texture.loadFromImage(packed))
+            {
+                std::cerr << "Texture atlas of " << packed.getSize().x << "x" << packed.getSize().y
+                          << " is too large for the graphics card" << std::endl;
+            }
+            else
+            {
+                std::clog << "Texture atlas packed " << order.size() << " images into "
+                          << packed.getSize().x << "x" << packed.getSize().y << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef ChessPlusPlus_Gfx_TextureAtlasClass_HeaderPlusPlus
+#define ChessPlusPlus_Gfx_TextureAtlasClass_HeaderPlusPlus
+
+#include "SFML.hpp"
+#include "res/ImageLoader.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace chesspp
+{
+    namespace gfx
+    {
+        /**
+         * Packs many images into one texture, so that everything
+         * drawn from them can be drawn with a single draw call.
+         * Images are placed in rows, tallest first, with a pixel
+         * between them so that their edges don't bleed. Packing and
+         * uploading the texture must happen on the thread that draws.
+         */
+        class TextureAtlas
+        {
+            sf::Texture texture;
+            std::map<std::string, sf::IntRect> regions; //by image path
+
+        public:
+            //Packs the decoded images of the paths, those missing get an empty region
+            TextureAtlas(std::vector<std::string> const &paths, res::ImageLoader::Images_t const &images);
+
+            sf::Texture const &getTexture() const noexcept
+            {
+                return texture;
+            }
+            //Whether the image was packed into the atlas
+            bool contains(std::string const &path) const
+            {
+                return regions.find(path) != regions.end();
+            }
+            //Where the image is in the texture, the image must be contained
+            sf::IntRect const &region(std::string const &path) const
+            {
+                return regions.at(path);
+            }
+        };
+    }
+}
+
+#endif
@@ -9,6 +9,7 @@ namespace chesspp
     {
         class Archer : public virtual Piece
         {
+            template<Piece::Kind> friend class Generator;
         public:
             Archer(board::Board &b, Position_t const &pos, Suit const &s);
 
@@ -9,6 +9,7 @@ namespace chesspp
     {
         class Bishop : public virtual Piece
         {
+            template<Piece::Kind> friend class Generator;
         public:
             Bishop(board::Board &b, Position_t const &pos, Suit const &s);
 
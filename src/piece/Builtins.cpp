@@ -0,0 +1,42 @@
+#include "Pawn.hpp"
+#include "Rook.hpp"
+#include "Knight.hpp"
+#include "Bishop.hpp"
+#include "Queen.hpp"
+#include "King.hpp"
+#include "Archer.hpp"
+
+namespace chesspp
+{
+    namespace board
+    {
+        namespace
+        {
+            template<typename PieceT>
+            static Board::Factory_t::mapped_type make()
+            {
+                return [](Board::Pieces_t &a, Board &b, Board::Position_t const &p, Board::Suit const &s)
+                -> Board::Pieces_t::iterator
+                {
+                    return a.emplace<PieceT>(b, p, s);
+                };
+            }
+        }
+
+        Board::Factory_t Board::builtinPieceClasses()
+        {
+            Factory_t f;
+            f.emplace("Pawn", [](Pieces_t &a, Board &b, Position_t const &p, Suit const &s) -> Pieces_t::iterator
+            {
+                return a.emplace<piece::Pawn>(b, p, s, b.config.facing(p, s));
+            });
+            f.emplace("Rook",   make<piece::Rook>());
+            f.emplace("Knight", make<piece::Knight>());
+            f.emplace("Bishop", make<piece::Bishop>());
+            f.emplace("Queen",  make<piece::Queen>());
+            f.emplace("King",   make<piece::King>());
+            f.emplace("Archer", make<piece::Archer>());
+            return f;
+        }
+    }
+}
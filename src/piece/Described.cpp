@@ -0,0 +1,135 @@
+#include "Described.hpp"
+#include "Generators.hpp"
+#include "Exception.hpp"
+
+#include <string>
+#include <cstdint>
+
+namespace chesspp
+{
+    namespace piece
+    {
+        namespace
+        {
+            static std::vector<Dir> directions(std::uint8_t rays)
+            {
+                std::vector<Dir> dirs;
+                for(unsigned d = 1; d <= 8; ++d)
+                {
+                    if(rays >> (d - 1) & 1)
+                    {
+                        dirs.push_back(Dir(d));
+                    }
+                }
+                return dirs;
+            }
+            static Described::Attacks_t attacks(std::uint8_t rays) noexcept
+            {
+                switch(rays)
+                {
+                case Piece::Orthogonal:                     return board::Bitboards::rookAttacks;
+                case Piece::Diagonal:                       return board::Bitboards::bishopAttacks;
+                case Piece::Orthogonal | Piece::Diagonal:   return board::Bitboards::queenAttacks;
+                default:                                    return nullptr;
+                }
+            }
+            static std::vector<Described::Offset_t> offsets(chesspp_piece_offset const *leaps, std::uint32_t count, char const *name)
+            {
+                std::vector<Described::Offset_t> v;
+                for(std::uint32_t i = 0; i < count; ++i)
+                {
+                    signed x = leaps[i].x, y = leaps[i].y;
+                    if(x < -15 || x > 15 || y < -15 || y > 15)
+                    {
+                        throw Exception{std::string("piece class ") + name + " leaps further than 15 tiles"};
+                    }
+                    v.emplace_back(x, y);
+                }
+                return v;
+            }
+
+            static Described &piece(chesspp_piece_context const *ctx) noexcept
+            {
+                return *static_cast<Described *>(ctx->piece);
+            }
+            static int occupied(chesspp_piece_context const *ctx, int x, int y)
+            {
+                auto &p = piece(ctx);
+                if(x < 0 || y < 0 || x >= ctx->width || y >= ctx->height)
+                {
+                    return CHESSPP_EMPTY;
+                }
+                auto it = p.board.pieceAt(Piece::Position_t(Piece::Position_t::value_type(x), Piece::Position_t::value_type(y)));
+                if(it == p.board.end())
+                {
+                    return CHESSPP_EMPTY;
+                }
+                return (*it)->suit == p.suit? CHESSPP_FRIEND : CHESSPP_ENEMY;
+            }
+        }
+
+        Described::Class::Class(chesspp_piece_class const &c)
+        : abi(c) //can't use {}
+        , name{c.name? c.name : ""}
+        , move_rays(directions(c.move_rays)) //don't use {}
+        , capture_rays(directions(c.capture_rays)) //don't use {}
+        , move_attacks{attacks(c.move_rays)}
+        , capture_attacks{attacks(c.capture_rays)}
+        , move_leaps(offsets(c.move_leaps, c.move_leap_count, c.name)) //don't use {}
+        , capture_leaps(offsets(c.capture_leaps, c.capture_leap_count, c.name)) //don't use {}
+        , move_pattern{move_leaps}
+        , capture_pattern{capture_leaps}
+        {
+        }
+
+        Described::Described(board::Board &b, Position_t const &pos_, Suit const &s_, Class const &c)
+        : Piece{b, pos_, s_}
+        , described(c) //can't use {}
+        {
+            //Legality can only reason about pieces that capture one way
+            if(!c.abi.generate && (c.capture_rays.empty() || c.capture_leaps.empty()))
+            {
+                specialize(Kind::Described, this, c.abi.capture_rays);
+            }
+        }
+
+        config::BoardConfig::Textures_t::mapped_type::mapped_type const &Described::texture() const
+        {
+            return board.config.texture(suit, described.name);
+        }
+
+        void Described::calcTrajectory()
+        {
+            Generator<Kind::Described>::generate(*this);
+        }
+
+        void Described::generatePlugin()
+        {
+            chesspp_piece_context context;
+            context.piece = this;
+            context.x = pos.x;
+            context.y = pos.y;
+            context.width = board.config.boardWidth();
+            context.height = board.config.boardHeight();
+            context.moves = unsigned(moves);
+            context.occupied = occupied;
+            context.add = [](chesspp_piece_context const *ctx, int list, int x, int y)
+            {
+                auto &p = piece(ctx);
+                if(x < 0 || y < 0 || x >= ctx->width || y >= ctx->height)
+                {
+                    return;
+                }
+                Position_t const t {Position_t::value_type(x), Position_t::value_type(y)};
+                switch(list)
+                {
+                case CHESSPP_TRAJECTORY: p.addTrajectory(t); break;
+                case CHESSPP_CAPTURING:  p.addCapturing(t);  break;
+                case CHESSPP_CAPTURABLE: p.addCapturable(t); break;
+                default:                 break;
+                }
+            };
+            described.abi.generate(&context);
+        }
+    }
+}
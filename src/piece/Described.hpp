@@ -0,0 +1,60 @@
+#ifndef ChessPlusPlus_Piece_DescribedChessPiece_HeaderPlusPlus
+#define ChessPlusPlus_Piece_DescribedChessPiece_HeaderPlusPlus
+
+#include "board/Board.hpp"
+#include "PluginAbi.hpp"
+
+#include <vector>
+
+namespace chesspp
+{
+    namespace piece
+    {
+        /**
+         * A piece of a class added by a piece plugin. Its rays and
+         * leaps are generated like those of the built-in classes,
+         * through the switch on Kind::Described, and only the moves
+         * the plugin generates itself go through a function pointer.
+         */
+        class Described : public virtual Piece
+        {
+            template<Piece::Kind> friend class Generator;
+        public:
+            using Offset_t = util::Position<signed>;
+            using Attacks_t = board::Bitboards::Bitboard_t (*)(board::Bitboards::Square_t, board::Bitboards::Bitboard_t);
+
+            /**
+             * The description of a plugin class compiled for
+             * generating its moves, made once when it is loaded.
+             */
+            class Class
+            {
+            public:
+                chesspp_piece_class const &abi;
+                config::BoardConfig::PieceClass_t const name;
+                std::vector<util::Direction> const move_rays, capture_rays;
+                Attacks_t const move_attacks, capture_attacks; //the standard board lookup of the rays, if there is one
+                std::vector<Offset_t> const move_leaps, capture_leaps;
+                board::WideBitboards::Pattern const move_pattern, capture_pattern;
+
+                //Throws chesspp::Exception for offsets out of range
+                explicit Class(chesspp_piece_class const &c);
+            };
+
+            Class const &described;
+
+            Described(board::Board &b, Position_t const &pos, Suit const &s, Class const &c);
+
+            virtual config::BoardConfig::Textures_t::mapped_type::mapped_type const &texture() const override;
+
+        protected:
+            virtual void calcTrajectory() override;
+
+        private:
+            //Calls the generate() of the plugin
+            void generatePlugin();
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,37 @@
+#include "Generators.hpp"
+
+namespace chesspp
+{
+    namespace piece
+    {
+        board::WideBitboards::Pattern const Generator<Kind::Knight>::Pattern {Geometry::KnightOffsets};
+        constexpr Dir Generator<Kind::Bishop>::Directions[];
+        constexpr Dir Generator<Kind::Rook>::Directions[];
+        constexpr Dir Generator<Kind::Queen>::Directions[];
+        board::WideBitboards::Pattern const Generator<Kind::King>::Pattern {Geometry::KingOffsets};
+        constexpr Dir Generator<Kind::Archer>::Moves[];
+        constexpr Dir Generator<Kind::Archer>::Exposed[];
+        board::WideBitboards::Pattern const Generator<Kind::Archer>::RingPattern {Geometry::ArcherOffsets};
+    }
+
+    namespace board
+    {
+        //The classes are known exactly here, so the generators inline into the switch
+        void Board::Piece::generate(Piece &p)
+        {
+            using piece::Generator;
+            switch(p.k)
+            {
+            case Kind::Pawn:   Generator<Kind::Pawn  >::generate(*static_cast<piece::Pawn   *>(p.typed)); break;
+            case Kind::Knight: Generator<Kind::Knight>::generate(*static_cast<piece::Knight *>(p.typed)); break;
+            case Kind::Bishop: Generator<Kind::Bishop>::generate(*static_cast<piece::Bishop *>(p.typed)); break;
+            case Kind::Rook:   Generator<Kind::Rook  >::generate(*static_cast<piece::Rook   *>(p.typed)); break;
+            case Kind::Queen:  Generator<Kind::Queen >::generate(*static_cast<piece::Queen  *>(p.typed)); break;
+            case Kind::King:   Generator<Kind::King  >::generate(*static_cast<piece::King   *>(p.typed)); break;
+            case Kind::Archer: Generator<Kind::Archer>::generate(*static_cast<piece::Archer *>(p.typed)); break;
+            case Kind::Described: Generator<Kind::Described>::generate(*static_cast<piece::Described *>(p.typed)); break;
+            default:           p.calcTrajectory(); break;
+            }
+        }
+    }
+}
@@ -0,0 +1,374 @@
+#ifndef ChessPlusPlus_Piece_BuiltinMoveGenerators_HeaderPlusPlus
+#define ChessPlusPlus_Piece_BuiltinMoveGenerators_HeaderPlusPlus
+
+#include "board/Board.hpp"
+#include "Pawn.hpp"
+#include "Knight.hpp"
+#include "Bishop.hpp"
+#include "Rook.hpp"
+#include "Queen.hpp"
+#include "King.hpp"
+#include "Archer.hpp"
+#include "Described.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace piece
+    {
+        using Kind = Piece::Kind;
+        using Dir = util::Direction;
+        using Geometry = config::BoardGeometry;
+
+        /**
+         * What the generators of the built-in classes share: rays
+         * for sliding pieces and fixed offsets for leaping pieces,
+         * each with the bitboard fast paths where the board has them
+         * and the precomputed BoardGeometry tables otherwise.
+         */
+        template<>
+        class Generator<Kind::Custom>
+        {
+        public:
+            template<typename P, typename Attacks, std::size_t N>
+            static void slide(P &p, Attacks attacks, Dir const (&directions)[N])
+            {
+                auto &board = p.board;
+                if(board.hasBitboards())
+                {
+                    //standard boards look up rays instead of walking them
+                    auto const &bb = board.bitboards();
+                    auto rays = attacks(bb.square(p.pos), bb.occupied());
+                    p.addCapturings(rays);
+                    p.addTrajectories(rays & ~bb.occupied());
+                    return;
+                }
+                if(board.hasWideBitboards())
+                {
+                    //other boards up to 32x32 fill rays with mask operations
+                    auto const &wb = board.wideBitboards();
+                    auto rays = wb.rays(p.pos, directions);
+                    p.addCapturings(rays);
+                    p.addTrajectories(rays.remove(wb.occupied()));
+                    return;
+                }
+
+                auto const &geometry = board.config.geometry();
+                for(auto d : directions)
+                {
+                    for(auto const &t : geometry.ray(p.pos, d))
+                    {
+                        p.addCapturing(t);
+                        if(!board.occupied(t))
+                        {
+                            p.addTrajectory(t);
+                        }
+                        else break; //can't jump over pieces
+                    }
+                }
+            }
+
+            template<typename P, typename Attacks>
+            static void leap(P &p, Attacks attacks, board::WideBitboards::Pattern const &pattern, Geometry::Span tiles)
+            {
+                auto &board = p.board;
+                if(board.hasBitboards())
+                {
+                    auto tiles = attacks(board.bitboards().square(p.pos));
+                    p.addTrajectories(tiles);
+                    p.addCapturings(tiles);
+                    return;
+                }
+                if(board.hasWideBitboards())
+                {
+                    auto tiles = board.wideBitboards().stamp(pattern, p.pos);
+                    p.addTrajectories(tiles);
+                    p.addCapturings(tiles);
+                    return;
+                }
+
+                for(auto const &t : tiles)
+                {
+                    p.addTrajectory(t);
+                    p.addCapturing(t);
+                }
+            }
+        };
+        using Common = Generator<Kind::Custom>;
+
+        template<>
+        class Generator<Kind::Pawn>
+        {
+        public:
+            static void generate(Pawn &p)
+            {
+                //Pawns can move 1 or 2 spaces forward on their first turn,
+                //or only 1 space forward on any other turn.
+                //On any turn they can move diagonally forward to capture,
+                //but may not capture when moving straight forward.
+                //They may be captured via the space behind them
+                //if they just moved forward two spaces (en passant).
+                auto &board = p.board;
+                if(board.hasBitboards())
+                {
+                    auto const &bb = board.bitboards();
+                    auto forward = board::Bitboards::step(p.facing, bb.square(p.pos));
+                    p.addTrajectories(forward);
+                    if(p.moves == 0 && (forward & ~bb.occupied())) //can't jump over pieces
+                    {
+                        p.addTrajectories(board::Bitboards::step(p.facing, bb.lowest(forward)));
+                    }
+                    p.addCapturings(board::Bitboards::step(Rotate(p.facing, +1), bb.square(p.pos))
+                                  | board::Bitboards::step(Rotate(p.facing, -1), bb.square(p.pos)));
+                }
+                else if(p.facing != Dir::None)
+                {
+                    auto const &geometry = board.config.geometry();
+                    auto forward = geometry.ray(p.pos, p.facing);
+                    if(!forward.empty())
+                    {
+                        p.addTrajectory(forward[0]);
+                        if(p.moves == 0 && forward.size() > 1 && !board.occupied(forward[0])) //first move, can't jump over pieces
+                        {
+                            p.addTrajectory(forward[1]);
+                        }
+                    }
+
+                    for(auto const &t : geometry.step(p.pos, Rotate(p.facing, +1))) //diagonally forward-right
+                    {
+                        p.addCapturing(t);
+                    }
+                    for(auto const &t : geometry.step(p.pos, Rotate(p.facing, -1))) //diagonally forward-left
+                    {
+                        p.addCapturing(t);
+                    }
+                }
+
+                if(p.moves == 1 && p.en_passant && p.facing != Dir::None) //just moved 2 spaces forward
+                {
+                    for(auto const &t : p.board.config.geometry().step(p.pos, Rotate(p.facing, 4))) //enable en passant
+                    {
+                        p.addCapturable(t);
+                    }
+                }
+            }
+        };
+
+        template<>
+        class Generator<Kind::Knight>
+        {
+        public:
+            static board::WideBitboards::Pattern const Pattern;
+
+            static void generate(Knight &p)
+            {
+                //Knights can only move in 3-long 2-short L shapes
+                Common::leap(p, board::Bitboards::knightAttacks, Pattern, p.board.config.geometry().knight(p.pos));
+            }
+        };
+
+        template<>
+        class Generator<Kind::Bishop>
+        {
+        public:
+            static constexpr Dir Directions[] = {Dir::NorthEast
+                                                ,Dir::SouthEast
+                                                ,Dir::SouthWest
+                                                ,Dir::NorthWest};
+
+            static void generate(Bishop &p)
+            {
+                //Bishops can move infinitely in the four diagonal directions
+                Common::slide(p, board::Bitboards::bishopAttacks, Directions);
+            }
+        };
+
+        template<>
+        class Generator<Kind::Rook>
+        {
+        public:
+            static constexpr Dir Directions[] = {Dir::North
+                                                ,Dir::East
+                                                ,Dir::South
+                                                ,Dir::West};
+
+            static void generate(Rook &p)
+            {
+                //Rooks can move infinitely in the four straight directions
+                Common::slide(p, board::Bitboards::rookAttacks, Directions);
+            }
+        };
+
+        template<>
+        class Generator<Kind::Queen>
+        {
+        public:
+            static constexpr Dir Directions[] = {Dir::North
+                                                ,Dir::NorthEast
+                                                ,Dir::East
+                                                ,Dir::SouthEast
+                                                ,Dir::South
+                                                ,Dir::SouthWest
+                                                ,Dir::West
+                                                ,Dir::NorthWest};
+
+            static void generate(Queen &p)
+            {
+                //Queens can move infinitely in all eight directions
+                Common::slide(p, board::Bitboards::queenAttacks, Directions);
+            }
+        };
+
+        template<>
+        class Generator<Kind::King>
+        {
+        public:
+            static board::WideBitboards::Pattern const Pattern;
+
+            static void generate(King &p)
+            {
+                //Kings can move one space in all eight directions,
+                //or two towards a Rook to castle
+                Common::leap(p, board::Bitboards::kingAttacks, Pattern, p.board.config.geometry().king(p.pos));
+                p.castling.castles(p, [&](board::Castling::Position_t const &to)
+                {
+                    p.addTrajectory(to);
+                });
+            }
+        };
+
+        template<>
+        class Generator<Kind::Archer>
+        {
+        public:
+            static constexpr Dir Moves[] = {Dir::NorthEast
+                                           ,Dir::SouthEast
+                                           ,Dir::SouthWest
+                                           ,Dir::NorthWest};
+            static constexpr Dir Exposed[] = {Dir::North
+                                             ,Dir::East
+                                             ,Dir::South
+                                             ,Dir::West};
+            static board::WideBitboards::Pattern const RingPattern;
+
+            static void generate(Archer &p)
+            {
+                auto const &geometry = p.board.config.geometry();
+                //Archers can move one space in four directions
+                for(Dir d : Moves)
+                {
+                    for(auto const &t : geometry.step(p.pos, d))
+                    {
+                        p.addTrajectory(t);
+                    }
+                }
+                //Archers can be captured at four spots around them
+                for(Dir d : Exposed)
+                {
+                    for(auto const &t : geometry.step(p.pos, d))
+                    {
+                        p.addCapturable(t);
+                    }
+                }
+                //Archers can only capture at a circle around them
+                if(p.board.hasWideBitboards())
+                {
+                    p.addCapturings(p.board.wideBitboards().stamp(RingPattern, p.pos));
+                }
+                else for(auto const &t : geometry.archer(p.pos))
+                {
+                    p.addCapturing(t);
+                }
+            }
+        };
+
+        template<>
+        class Generator<Kind::Described>
+        {
+            //Like Common::slide(), but for any directions and either moving or capturing along them
+            static void slide(Described &p, std::vector<Dir> const &directions, Described::Attacks_t attacks, bool moves, bool captures)
+            {
+                if(directions.empty()) return;
+                auto &board = p.board;
+                if(attacks && board.hasBitboards())
+                {
+                    auto const &bb = board.bitboards();
+                    auto rays = attacks(bb.square(p.pos), bb.occupied());
+                    if(captures) p.addCapturings(rays);
+                    if(moves) p.addTrajectories(rays & ~bb.occupied());
+                    return;
+                }
+                if(board.hasWideBitboards())
+                {
+                    auto const &wb = board.wideBitboards();
+                    auto rays = wb.rays(p.pos, directions);
+                    if(captures) p.addCapturings(rays);
+                    if(moves) p.addTrajectories(rays.remove(wb.occupied()));
+                    return;
+                }
+
+                auto const &geometry = board.config.geometry();
+                for(auto d : directions)
+                {
+                    for(auto const &t : geometry.ray(p.pos, d))
+                    {
+                        if(captures) p.addCapturing(t);
+                        if(!board.occupied(t))
+                        {
+                            if(moves) p.addTrajectory(t);
+                        }
+                        else break; //can't jump over pieces
+                    }
+                }
+            }
+            static void leap(Described &p, std::vector<Described::Offset_t> const &offsets, board::WideBitboards::Pattern const &pattern, bool moves, bool captures)
+            {
+                if(offsets.empty()) return;
+                auto &board = p.board;
+                if(board.hasWideBitboards())
+                {
+                    auto tiles = board.wideBitboards().stamp(pattern, p.pos);
+                    if(moves) p.addTrajectories(tiles);
+                    if(captures) p.addCapturings(tiles);
+                    return;
+                }
+
+                for(auto const &o : offsets)
+                {
+                    signed x = signed(p.pos.x) + o.x, y = signed(p.pos.y) + o.y;
+                    if(x < 0 || y < 0 || x >= signed(board.config.boardWidth()) || y >= signed(board.config.boardHeight())) continue;
+                    Piece::Position_t const t {Piece::Position_t::value_type(x), Piece::Position_t::value_type(y)};
+                    if(moves) p.addTrajectory(t);
+                    if(captures) p.addCapturing(t);
+                }
+            }
+
+        public:
+            static void generate(Described &p)
+            {
+                //Plugin classes move and capture along the rays and to the offsets
+                //they were loaded with, and anything else they add themselves
+                auto const &c = p.described;
+                if(c.abi.move_rays == c.abi.capture_rays)
+                {
+                    slide(p, c.move_rays, c.move_attacks, true, true);
+                }
+                else
+                {
+                    slide(p, c.move_rays, c.move_attacks, true, false);
+                    slide(p, c.capture_rays, c.capture_attacks, false, true);
+                }
+                leap(p, c.move_leaps, c.move_pattern, true, false);
+                leap(p, c.capture_leaps, c.capture_pattern, false, true);
+                if(c.abi.generate)
+                {
+                    p.generatePlugin();
+                }
+            }
+        };
+    }
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "King.hpp"
+#include "Generators.hpp"
 
 #include <iostream>
 #include <initializer_list>
@@ -7,52 +8,44 @@ namespace chesspp
 {
     namespace piece
     {
-        static auto KingRegistration = board::Board::registerPieceClass
-        (
-            "King",
-            [](board::Board &b, board::Board::Position_t const &p, board::Board::Suit const &s)
-            -> board::Board::Pieces_t::value_type
-            {
-                return board::Board::Pieces_t::value_type(new King(b, p, s));
-            }
-        );
-
         King::King(board::Board &b, Position_t const &pos_, Suit const &s_)
         : Piece{b, pos_, s_}
         , castling(b.getInteraction<board::Castling>()) //can't use {}
         {
+            specialize(Kind::King, this);
             //not yet moved, can castle
             castling.addSlow(this);
         }
 
         config::BoardConfig::Textures_t::mapped_type::mapped_type const &King::texture() const
         {
-            return board.config.texturePaths().at(suit).at("King");
+            static config::BoardConfig::PieceClass_t const name {"King"};
+            return board.config.texture(suit, name);
         }
 
         void King::calcTrajectory()
         {
-            //Kings can move one space in all eight directions
-            using Dir = util::Direction;
-            for(Dir d : {Dir::North
-                        ,Dir::NorthEast
-                        ,Dir::East
-                        ,Dir::SouthEast
-                        ,Dir::South
-                        ,Dir::SouthWest
-                        ,Dir::West
-                        ,Dir::NorthWest})
-            {
-                Position_t t = Position_t(pos).move(d);
-                addTrajectory(t);
-                addCapturing(t);
-            }
+            Generator<Kind::King>::generate(*this);
         }
 
+        bool King::needsTick() const
+        {
+            //castling depends on the tiles up to the Rooks
+            return castling.pending(*this);
+        }
         void King::moveUpdate(Position_t const &from, Position_t const &to)
         {
             //moved, can no longer castle
-            castling.removeSlow(this);
+            castling.kingMoved(*this, from, to);
+        }
+        King::State_t King::saveState() const
+        {
+            //the castling rights it still has
+            return castling.kingState(*this);
+        }
+        void King::restoreState(State_t state)
+        {
+            castling.restoreKing(*this, state);
         }
     }
 }
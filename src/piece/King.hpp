@@ -10,6 +10,7 @@ namespace chesspp
     {
         class King : public virtual Piece
         {
+            template<Piece::Kind> friend class Generator;
             board::Castling &castling;
 
         public:
@@ -21,7 +22,10 @@ namespace chesspp
             virtual void calcTrajectory() override;
 
         private:
+            virtual bool needsTick() const override;
             virtual void moveUpdate(Position_t const &from, Position_t const &to) override;
+            virtual State_t saveState() const override;
+            virtual void restoreState(State_t state) override;
         };
     }
 }
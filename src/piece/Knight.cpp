@@ -1,4 +1,5 @@
 #include "Knight.hpp"
+#include "Generators.hpp"
 
 #include <iostream>
 #include <initializer_list>
@@ -7,43 +8,21 @@ namespace chesspp
 {
     namespace piece
     {
-        static auto KnightRegistration = board::Board::registerPieceClass
-        (
-            "Knight",
-            [](board::Board &b, board::Board::Position_t const &p, board::Board::Suit const &s)
-            -> board::Board::Pieces_t::value_type
-            {
-                return board::Board::Pieces_t::value_type(new Knight(b, p, s));
-            }
-        );
-
         Knight::Knight(board::Board &b, Position_t const &pos_, Suit const &s_)
         : Piece{b, pos_, s_}
         {
+            specialize(Kind::Knight, this);
         }
 
         config::BoardConfig::Textures_t::mapped_type::mapped_type const &Knight::texture() const
         {
-            return board.config.texturePaths().at(suit).at("Knight");
+            static config::BoardConfig::PieceClass_t const name {"Knight"};
+            return board.config.texture(suit, name);
         }
 
         void Knight::calcTrajectory()
         {
-            //Knights can only move in 3-long 2-short L shapes
-
-            for(Position_t m : {Position_t( 1, -2)
-                               ,Position_t( 2, -1)
-                               ,Position_t( 2,  1)
-                               ,Position_t( 1,  2)
-                               ,Position_t(-1,  2)
-                               ,Position_t(-2,  1)
-                               ,Position_t(-2, -1)
-                               ,Position_t(-1, -2)})
-            {
-                Position_t t = Position_t(pos).move(m.x, m.y);
-                addTrajectory(t);
-                addCapturing(t);
-            }
+            Generator<Kind::Knight>::generate(*this);
         }
     }
 }
@@ -9,6 +9,7 @@ namespace chesspp
     {
         class Knight : public virtual Piece
         {
+            template<Piece::Kind> friend class Generator;
         public:
             Knight(board::Board &b, Position_t const &pos, Suit const &s);
 
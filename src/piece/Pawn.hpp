@@ -9,6 +9,7 @@ namespace chesspp
     {
         class Pawn : public virtual Piece
         {
+            template<Piece::Kind> friend class Generator;
             bool en_passant = true;
             util::Direction facing;
 
@@ -18,6 +19,9 @@ namespace chesspp
             virtual config::BoardConfig::Textures_t::mapped_type::mapped_type const &texture() const override;
 
             virtual void tick(Position_t const &p) override;
+            virtual bool needsTick() const override;
+            virtual State_t saveState() const override;
+            virtual void restoreState(State_t state) override;
 
         protected:
             virtual void calcTrajectory() override;
@@ -0,0 +1,107 @@
+#ifndef ChessPlusPlus_Piece_PiecePluginAbi_HeaderPlusPlus
+#define ChessPlusPlus_Piece_PiecePluginAbi_HeaderPlusPlus
+
+/*
+ * The interface of piece plugins, shared libraries listed under "board",
+ * "piece plugins" of board.json that add piece classes to the board.
+ * It is plain C, so plugins only need this header and don't depend on
+ * the compiler, standard library or classes of the game.
+ *
+ * A plugin exports chesspp_piece_classes(), which the board calls once
+ * with CHESSPP_PIECE_PLUGIN_ABI. It returns the plugin's classes and sets
+ * count, or returns a null pointer if it doesn't support that version.
+ * The classes must stay valid until the program exits.
+ *
+ * Most pieces are described entirely by the directions they slide in and
+ * the offsets they leap to, which the board turns into the same bitboard
+ * lookups the built-in classes use. Anything else is left to generate(),
+ * which is called after the described moves for every update of the piece.
+ *
+ * Plugins are loaded by the first board of a configuration, or by
+ * Board::loadPieceClasses(), which programs constructing boards on several
+ * threads call before starting them, as loading must not race with boards
+ * being constructed. generate() may be called on several threads at once,
+ * each for a piece of a different board.
+ */
+
+#include <stdint.h>
+
+#define CHESSPP_PIECE_PLUGIN_ABI 1
+
+//Bits of move_rays and capture_rays, clockwise from north
+#define CHESSPP_RAY_NORTH     0x01u
+#define CHESSPP_RAY_NORTHEAST 0x02u
+#define CHESSPP_RAY_EAST      0x04u
+#define CHESSPP_RAY_SOUTHEAST 0x08u
+#define CHESSPP_RAY_SOUTH     0x10u
+#define CHESSPP_RAY_SOUTHWEST 0x20u
+#define CHESSPP_RAY_WEST      0x40u
+#define CHESSPP_RAY_NORTHWEST 0x80u
+#define CHESSPP_RAYS_ORTHOGONAL 0x55u
+#define CHESSPP_RAYS_DIAGONAL   0xAAu
+
+//The lists chesspp_piece_context::add() adds to
+#define CHESSPP_TRAJECTORY 0 /* where the piece can move */
+#define CHESSPP_CAPTURING  1 /* where the piece can capture */
+#define CHESSPP_CAPTURABLE 2 /* where the piece can be captured, besides its own tile */
+
+//What chesspp_piece_context::occupied() returns
+#define CHESSPP_EMPTY 0
+#define CHESSPP_FRIEND 1 /* a piece of the same suit */
+#define CHESSPP_ENEMY  2
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//Relative to the piece, positive x is east and positive y is south, each within [-15, 15]
+typedef struct chesspp_piece_offset
+{
+    int8_t x, y;
+} chesspp_piece_offset;
+
+//The piece being generated and the board it is on, only valid during generate()
+typedef struct chesspp_piece_context
+{
+    void *piece; //for the callbacks
+    int x, y;    //where the piece is
+    int width, height;
+    unsigned moves; //made by the piece so far
+    int (*occupied)(struct chesspp_piece_context const *ctx, int x, int y); //CHESSPP_EMPTY off the board
+    void (*add)(struct chesspp_piece_context const *ctx, int list, int x, int y); //ignores tiles off the board
+} chesspp_piece_context;
+
+typedef struct chesspp_piece_class
+{
+    char const *name; //as used in board.json
+
+    //Moves to every empty tile in these directions until blocked
+    uint8_t move_rays;
+    //Captures at the first occupied tile in these directions
+    uint8_t capture_rays;
+    uint8_t reserved[2]; //zero
+
+    //Moves to or captures at these offsets whatever is in between
+    uint32_t move_leap_count, capture_leap_count;
+    chesspp_piece_offset const *move_leaps, *capture_leaps;
+
+    //Adds the moves that can't be described above, may be null. Search can
+    //only tell which moves are legal without making them when the enemy
+    //pieces have none and capture either along rays or by leaps, not both.
+    void (*generate)(chesspp_piece_context const *ctx);
+} chesspp_piece_class;
+
+typedef chesspp_piece_class const *(*chesspp_piece_classes_t)(uint32_t abi, uint32_t *count);
+
+#ifdef _WIN32
+    #define CHESSPP_PIECE_PLUGIN_EXPORT __declspec(dllexport)
+#else
+    #define CHESSPP_PIECE_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+#include "Described.hpp"
+#include "PluginAbi.hpp"
+#include "Exception.hpp"
+
+#include <deque>
+#include <set>
+#include <mutex>
+#include <string>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace chesspp
+{
+    namespace board
+    {
+        namespace
+        {
+            static std::mutex loading;
+            static std::set<std::string> loaded;                 //paths
+            static std::deque<piece::Described::Class> described; //never moved, the factory refers to them
+
+            //The entry point of the plugin, which stays loaded until the program exits
+            static chesspp_piece_classes_t open(std::string const &path)
+            {
+#ifdef _WIN32
+                HMODULE library = LoadLibraryA(path.c_str());
+                if(!library)
+                {
+                    throw Exception{"could not load piece plugin " + path};
+                }
+                auto entry = reinterpret_cast<chesspp_piece_classes_t>(GetProcAddress(library, "chesspp_piece_classes"));
+#else
+                void *library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+                if(!library)
+                {
+                    throw Exception{"could not load piece plugin " + path + ": " + dlerror()};
+                }
+                auto entry = reinterpret_cast<chesspp_piece_classes_t>(dlsym(library, "chesspp_piece_classes"));
+#endif
+                if(!entry)
+                {
+                    throw Exception{"piece plugin " + path + " has no chesspp_piece_classes()"};
+                }
+                return entry;
+            }
+        }
+
+        void Board::loadPlugins(std::vector<std::string> const &paths)
+        {
+            std::lock_guard<std::mutex> lock {loading};
+            for(auto const &path : paths)
+            {
+                if(loaded.find(path) != loaded.end()) continue;
+                auto entry = open(path);
+                std::uint32_t count = 0;
+                chesspp_piece_class const *classes = entry(CHESSPP_PIECE_PLUGIN_ABI, &count);
+                if(!classes)
+                {
+                    throw Exception{"piece plugin " + path + " doesn't support version " + std::to_string(CHESSPP_PIECE_PLUGIN_ABI) + " of the interface"};
+                }
+                //every class is checked before any is registered, so a plugin that fails can be tried again
+                std::deque<piece::Described::Class> staged;
+                std::set<std::string> names;
+                for(std::uint32_t i = 0; i < count; ++i)
+                {
+                    if(!classes[i].name || factory().find(Factory_t::key_type(classes[i].name)) != factory().end() || !names.insert(classes[i].name).second)
+                    {
+                        throw Exception{"piece plugin " + path + " adds a class without a name or one that already exists"};
+                    }
+                    staged.emplace_back(classes[i]);
+                }
+                for(auto const &compiled : staged)
+                {
+                    described.push_back(compiled);
+                    auto const &c = described.back();
+                    registerPieceClass(c.name, [&c](Pieces_t &a, Board &b, Position_t const &p, Suit const &s) -> Pieces_t::iterator
+                    {
+                        return a.emplace<piece::Described>(b, p, s, c);
+                    });
+                    std::clog << "Loaded piece class " << c.name << " from " << path << std::endl;
+                }
+                loaded.insert(path);
+            }
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "Queen.hpp"
+#include "Generators.hpp"
 
 #include <iostream>
 #include <initializer_list>
@@ -7,50 +8,21 @@ namespace chesspp
 {
     namespace piece
     {
-        static auto QueenRegistration = board::Board::registerPieceClass
-        (
-            "Queen",
-            [](board::Board &b, board::Board::Position_t const &p, board::Board::Suit const &s)
-            -> board::Board::Pieces_t::value_type
-            {
-                return board::Board::Pieces_t::value_type(new Queen(b, p, s));
-            }
-        );
-
         Queen::Queen(board::Board &b, Position_t const &pos_, Suit const &s_)
         : Piece{b, pos_, s_}
         {
+            specialize(Kind::Queen, this, Orthogonal | Diagonal);
         }
 
         config::BoardConfig::Textures_t::mapped_type::mapped_type const &Queen::texture() const
         {
-            return board.config.texturePaths().at(suit).at("Queen");
+            static config::BoardConfig::PieceClass_t const name {"Queen"};
+            return board.config.texture(suit, name);
         }
 
         void Queen::calcTrajectory()
         {
-            //Queens can move infinitely in all eight directions
-            using Dir = util::Direction;
-            for(Dir d : {Dir::North
-                        ,Dir::NorthEast
-                        ,Dir::East
-                        ,Dir::SouthEast
-                        ,Dir::South
-                        ,Dir::SouthWest
-                        ,Dir::West
-                        ,Dir::NorthWest})
-            {
-                Position_t t;
-                for(signed i = 1; board.valid(t = Position_t(pos).move(d, i)); ++i)
-                {
-                    addCapturing(t);
-                    if(!board.occupied(t))
-                    {
-                        addTrajectory(t);
-                    }
-                    else break; //can't jump over pieces
-                }
-            }
+            Generator<Kind::Queen>::generate(*this);
         }
     }
 }
@@ -9,6 +9,7 @@ namespace chesspp
     {
         class Queen : public virtual Piece
         {
+            template<Piece::Kind> friend class Generator;
         public:
             Queen(board::Board &b, Position_t const &pos, Suit const &s);
 
@@ -1,4 +1,5 @@
 #include "Rook.hpp"
+#include "Generators.hpp"
 
 #include <iostream>
 #include <initializer_list>
@@ -7,55 +8,39 @@ namespace chesspp
 {
     namespace piece
     {
-        static auto RookRegistration = board::Board::registerPieceClass
-        (
-            "Rook",
-            [](board::Board &b, board::Board::Position_t const &p, board::Board::Suit const &s)
-            -> board::Board::Pieces_t::value_type
-            {
-                return board::Board::Pieces_t::value_type(new Rook(b, p, s));
-            }
-        );
-
         Rook::Rook(board::Board &b, Position_t const &pos_, Suit const &s_)
         : Piece{b, pos_, s_}
         , castling(b.getInteraction<board::Castling>()) //can't use {}
         {
+            specialize(Kind::Rook, this, Orthogonal);
             //not yet moved, can castle
             castling.addFast(this);
         }
 
         config::BoardConfig::Textures_t::mapped_type::mapped_type const &Rook::texture() const
         {
-            return board.config.texturePaths().at(suit).at("Rook");
+            static config::BoardConfig::PieceClass_t const name {"Rook"};
+            return board.config.texture(suit, name);
         }
 
         void Rook::calcTrajectory()
         {
-            //Rooks can move infinitely in the four straight directions
-            using Dir = util::Direction;
-            for(Dir d : {Dir::North
-                        ,Dir::East
-                        ,Dir::South
-                        ,Dir::West})
-            {
-                Position_t t;
-                for(signed i = 1; board.valid(t = Position_t(pos).move(d, i)); ++i)
-                {
-                    addCapturing(t);
-                    if(!board.occupied(t))
-                    {
-                        addTrajectory(t);
-                    }
-                    else break; //can't jump over pieces
-                }
-            }
+            Generator<Kind::Rook>::generate(*this);
         }
 
-        void Rook::moveUpdate(Position_t const &from, Position_t const &to)
+        void Rook::moveUpdate(Position_t const &, Position_t const &)
         {
             //moved, can no longer castle
-            castling.removeFast(this);
+            castling.rookMoved(*this);
+        }
+        Rook::State_t Rook::saveState() const
+        {
+            //the castling rights it still has
+            return castling.rookState(*this);
+        }
+        void Rook::restoreState(State_t state)
+        {
+            castling.restoreRook(*this, state);
         }
     }
 }
@@ -10,6 +10,7 @@ namespace chesspp
     {
         class Rook : public virtual Piece
         {
+            template<Piece::Kind> friend class Generator;
             board::Castling &castling;
 
         public:
@@ -22,6 +23,8 @@ namespace chesspp
 
         private:
             virtual void moveUpdate(Position_t const &from, Position_t const &to) override;
+            virtual State_t saveState() const override;
+            virtual void restoreState(State_t state) override;
         };
     }
 }
@@ -0,0 +1,72 @@
+#include "ImageLoader.hpp"
+#include "util/Profiler.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace chesspp
+{
+    namespace res
+    {
+        ImageLoader::ImageLoader(std::vector<std::string> const &paths_, std::size_t threads)
+        : paths(paths_) //can't use {}
+        {
+            std::sort(paths.begin(), paths.end());
+            paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+            images.resize(paths.size());
+            loaded.resize(paths.size(), 0);
+
+            if(threads == 0)
+            {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            threads = std::min(threads, paths.size());
+            for(std::size_t i = 0; i < threads; ++i)
+            {
+                workers.emplace_back([this]{ run(); });
+            }
+        }
+        ImageLoader::~ImageLoader()
+        {
+            next = paths.size(); //the remaining images are not needed
+            join();
+        }
+
+        void ImageLoader::run()
+        {
+            for(std::size_t i; (i = next++) < paths.size(); ++finished)
+            {
+                CHESSPP_PROFILE_SCOPE("ImageLoader decode");
+                loaded[i] = images[i].loadFromFile(paths[i]);
+            }
+        }
+        void ImageLoader::join()
+        {
+            for(auto &w : workers)
+            {
+                if(w.joinable()) w.join();
+            }
+        }
+
+        ImageLoader::Images_t ImageLoader::take()
+        {
+            join();
+            Images_t taken;
+            for(std::size_t i = 0; i < paths.size(); ++i)
+            {
+                if(loaded[i] == 1)
+                {
+                    taken[paths[i]] = std::move(images[i]);
+                    loaded[i] = 2; //taken only once
+                }
+                else if(loaded[i] == 0)
+                {
+                    std::cerr << "Image loader failed to load \"" << paths[i] << "\"" << std::endl;
+                }
+            }
+            std::clog << "Image loader decoded " << taken.size() << " of " << paths.size() << " images on "
+                      << workers.size() << " threads" << std::endl;
+            return taken;
+        }
+    }
+}
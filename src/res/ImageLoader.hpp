@@ -0,0 +1,65 @@
+#ifndef ChessPlusPlus_Res_ParallelImageLoaderClass_HeaderPlusPlus
+#define ChessPlusPlus_Res_ParallelImageLoaderClass_HeaderPlusPlus
+
+#include "SFML.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace res
+    {
+        /**
+         * Decodes image files on a pool of threads as soon as it is
+         * constructed, so that they are ready by the time they are
+         * needed. Only decoding happens on the pool; uploading the
+         * images to the graphics card is up to the thread that takes
+         * them, since that is the thread with the OpenGL context.
+         */
+        class ImageLoader
+        {
+        public:
+            using Images_t = std::map<std::string, sf::Image>;
+
+        private:
+            std::vector<std::string> paths; //without duplicates
+            std::vector<sf::Image> images;  //by path
+            std::vector<char> loaded;       //by path, 0 if it could not be decoded, 2 once taken
+            std::atomic<std::size_t> next {0}, finished {0};
+            std::vector<std::thread> workers;
+
+            void run();
+            void join();
+
+        public:
+            //Zero threads uses one per core
+            ImageLoader(std::vector<std::string> const &paths, std::size_t threads = 0);
+            ImageLoader(ImageLoader const &) = delete;
+            ImageLoader &operator=(ImageLoader const &) = delete;
+            ~ImageLoader();
+
+            std::size_t total() const noexcept
+            {
+                return paths.size();
+            }
+            //The number of images decoded or failed so far
+            std::size_t progress() const noexcept
+            {
+                return finished;
+            }
+            bool done() const noexcept
+            {
+                return finished == paths.size();
+            }
+            //Waits for every image, then moves out those that could be decoded and weren't taken before
+            Images_t take();
+        };
+    }
+}
+
+#endif
@@ -4,18 +4,63 @@
 #include "config/Configuration.hpp"
 #include "util/Utilities.hpp"
 
-#include <map>
+#include <unordered_map>
+#include <functional>
 #include <typeinfo>
 #include <typeindex>
 #include <type_traits>
 #include <utility>
 #include <tuple>
 #include <memory>
+#include <cstddef>
 
 namespace chesspp
 {
     namespace res
     {
+        /**
+         * Refers to a resource held by a ResourceManager, so that
+         * it can be used repeatedly without looking it up again.
+         * Handles are cheap to copy and stay valid for as long as
+         * the ResourceManager that gave them out.
+         * \tparam ResT the type of the resource.
+         */
+        template<typename ResT>
+        class ResourceHandle
+        {
+            ResT *resource = nullptr;
+
+        public:
+            ResourceHandle() noexcept = default;
+            explicit ResourceHandle(ResT &r) noexcept
+            : resource{&r}
+            {
+            }
+
+            //False for a default constructed handle
+            explicit operator bool() const noexcept
+            {
+                return resource != nullptr;
+            }
+            ResT &operator*() const noexcept
+            {
+                return *resource;
+            }
+            ResT *operator->() const noexcept
+            {
+                return resource;
+            }
+
+            friend bool operator==(ResourceHandle const &a, ResourceHandle const &b) noexcept
+            {
+                return a.resource == b.resource;
+            }
+            friend bool operator!=(ResourceHandle const &a, ResourceHandle const &b) noexcept
+            {
+                return a.resource != b.resource;
+            }
+        };
+
         class ResourceManager final
         {
             config::Configuration &conf;
@@ -33,10 +78,60 @@ namespace chesspp
             };
 
         private:
-            using Res_t = std::map<std::pair<std::string, std::type_index>, std::unique_ptr<Resource>>;
+            using Key_t = std::pair<std::string, std::type_index>;
+            class KeyHash
+            {
+            public:
+                std::size_t operator()(Key_t const &key) const noexcept
+                {
+                    return std::hash<std::string>{}(key.first)*31 + key.second.hash_code();
+                }
+            };
+            using Res_t = std::unordered_map<Key_t, std::unique_ptr<Resource>, KeyHash>;
             Res_t res;
 
+            //Looks the key up once, and creates the resource with make() if it is missing
+            template<typename ResT, typename Make>
+            ResourceHandle<ResT> intern(std::string key, Make make)
+            {
+                Key_t k {std::move(key), typeid(ResT)};
+                auto it = res.find(k);
+                if(it == std::end(res))
+                {
+                    it = res.emplace(std::move(k), Res_t::mapped_type{make()}).first;
+                }
+                //This cast is guaranteed to be correct
+                return ResourceHandle<ResT>{static_cast<ResT &>(*it->second)};
+            }
+
         public:
+            template<typename ResT, typename... Path>
+            auto handle_config(Path const &... path)
+            -> typename std::enable_if
+            <
+                std::is_base_of<Resource, ResT>::value,
+                ResourceHandle<ResT>
+            >::type
+            {
+                return intern<ResT>(util::path_concat(std::string("\0", 1), path...), [&]
+                {
+                    return new ResT{conf.setting(path...)};
+                });
+            }
+            template<typename ResT>
+            auto handle_path(std::string const &path)
+            -> typename std::enable_if
+            <
+                std::is_base_of<Resource, ResT>::value,
+                ResourceHandle<ResT>
+            >::type
+            {
+                return intern<ResT>(path, [&]
+                {
+                    return new ResT{path};
+                });
+            }
+
             template<typename ResT, typename... Path>
             auto from_config(Path const &... path)
             -> typename std::enable_if
@@ -45,13 +140,7 @@ namespace chesspp
                 ResT &
             >::type
             {
-                Res_t::key_type key {util::path_concat(std::string("\0", 1), path...), typeid(ResT)};
-                if(res.find(key) == std::end(res))
-                {
-                    res.emplace(key, Res_t::mapped_type{new ResT{conf.setting(path...)}});
-                }
-                //This cast is guaranteed to be correct
-                return static_cast<ResT &>(*res[key]);
+                return *handle_config<ResT>(path...);
             }
             template<typename ResT>
             auto from_path(std::string const &path)
@@ -61,13 +150,7 @@ namespace chesspp
                 ResT &
             >::type
             {
-                Res_t::key_type key {path, typeid(ResT)};
-                if(res.find(key) == std::end(res))
-                {
-                    res.emplace(key, Res_t::mapped_type{new ResT{path}});
-                }
-                //This cast is guaranteed to be correct
-                return static_cast<ResT &>(*res[key]);
+                return *handle_path<ResT>(path);
             }
         };
         inline ResourceManager::Resource::~Resource() = default;
@@ -2,6 +2,7 @@
 #define ChessPlusPlus_Res_SfmlFileResourceClass_HeaderPlusPlus
 
 #include "ResourceManager.hpp"
+#include "util/Profiler.hpp"
 //#include "SFML.hpp"
 
 #include <iostream>
@@ -18,6 +19,7 @@ namespace chesspp
 
             SfmlFileResource(std::string const &file_path) noexcept
             {
+                CHESSPP_PROFILE_SCOPE("SfmlFileResource load");
                 if(!res.loadFromFile(file_path))
                 {
                     std::cerr << "SFML Resource failed to load \""
@@ -0,0 +1,164 @@
+#include "GameShard.hpp"
+
+#include <utility>
+
+namespace chesspp
+{
+    namespace server
+    {
+        GameShard::GameShard(config::BoardConfig const &config_, engine::Players_t const &players_, std::size_t first_, Reply_t reply_)
+        : config(config_)   //can't use {}
+        , players(players_) //can't use {}
+        , first{first_}
+        , reply{std::move(reply_)}
+        , worker{[this]{ run(); }}
+        {
+        }
+        GameShard::~GameShard()
+        {
+            {
+                std::lock_guard<std::mutex> lock {mutex};
+                stopping = true;
+            }
+            wake.notify_one();
+            worker.join();
+        }
+
+        void GameShard::post(Request r)
+        {
+            {
+                std::lock_guard<std::mutex> lock {mutex};
+                queue.push_back(std::move(r));
+            }
+            wake.notify_one();
+        }
+
+        void GameShard::run()
+        {
+            std::deque<Request> batch;
+            for(;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock {mutex};
+                    wake.wait(lock, [this]{ return stopping || !queue.empty(); });
+                    if(queue.empty()) return; //stopping, and nothing left to do
+                    batch.swap(queue);
+                }
+                for(auto &r : batch)
+                {
+                    handle(r);
+                }
+                batch.clear();
+            }
+        }
+
+        GameShard::Game *GameShard::find(Request const &r)
+        {
+            auto it = games.find(r.game);
+            if(it == games.end() || it->second->owner != r.connection)
+            {
+                reply(r.connection, std::to_string(r.game) + " error no such game");
+                return nullptr;
+            }
+            return it->second.get();
+        }
+
+        void GameShard::handle(Request &r)
+        {
+            using Kind = Request::Kind;
+            if(r.kind == Kind::Flush)
+            {
+                return reply(r.connection, std::string());
+            }
+            std::string const id = std::to_string(r.game);
+            if(r.kind == Kind::Drop)
+            {
+                for(auto it = games.begin(); it != games.end(); )
+                {
+                    if(it->second->owner == r.connection) it = games.erase(it);
+                    else ++it;
+                }
+                count.store(games.size(), std::memory_order_relaxed);
+                return;
+            }
+            if(r.kind == Kind::New)
+            {
+                try
+                {
+                    games.emplace(r.game, std::unique_ptr<Game>(new Game(config, r.connection, first)));
+                }
+                catch(std::exception &e)
+                {
+                    return reply(r.connection, id + " error " + e.what());
+                }
+                count.store(games.size(), std::memory_order_relaxed);
+                return reply(r.connection, id + " new " + players[first].name());
+            }
+
+            Game *g = find(r);
+            if(!g) return;
+            auto const &turn = players[g->turn];
+            switch(r.kind)
+            {
+            case Kind::Moves:
+            {
+                std::string line = id + " moves";
+                generate(g->board, turn, moves);
+                for(auto const &m : moves)
+                {
+                    line += ' ';
+                    line += engine::Notation::coordinates(g->board, m);
+                }
+                return reply(r.connection, std::move(line));
+            }
+            case Kind::Move:
+            {
+                engine::Move m;
+                if(engine::draw(g->board) != engine::Draw::None)
+                {
+                    return reply(r.connection, id + " error game over");
+                }
+                if(!notation.parse(g->board, turn, r.argument, m))
+                {
+                    return reply(r.connection, id + " error illegal move " + r.argument);
+                }
+                std::string played = engine::Notation::coordinates(g->board, m);
+                if(!engine::MoveGenerator::play(g->board, m))
+                {
+                    return reply(r.connection, id + " error could not make " + played);
+                }
+                g->turn = (g->turn + 1)%players.size();
+                reply(r.connection, id + " moved " + played + " " + players[g->turn].name());
+
+                generate(g->board, players[g->turn], moves);
+                if(moves.empty())
+                {
+                    reply(r.connection, id + (generate.inCheck()? " over checkmate" : " over stalemate"));
+                }
+                else if(engine::draw(g->board) != engine::Draw::None)
+                {
+                    reply(r.connection, id + (engine::draw(g->board) == engine::Draw::Repetition? " over repetition" : " over fifty"));
+                }
+                return;
+            }
+            case Kind::Pieces:
+            {
+                std::string line = id + " pieces";
+                for(auto const &p : g->board)
+                {
+                    line += ' ';
+                    line += p->suit + ":" + p->pclass + ":" + engine::Notation::tile(g->board, p->pos);
+                }
+                return reply(r.connection, std::move(line));
+            }
+            case Kind::Close:
+            {
+                games.erase(r.game);
+                count.store(games.size(), std::memory_order_relaxed);
+                return reply(r.connection, id + " closed");
+            }
+            default: return;
+            }
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef ChessPlusPlus_Server_GameShardClass_HeaderPlusPlus
+#define ChessPlusPlus_Server_GameShardClass_HeaderPlusPlus
+
+#include "config/BoardConfig.hpp"
+#include "board/Board.hpp"
+#include "engine/MoveGenerator.hpp"
+#include "engine/Notation.hpp"
+
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <string>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace server
+    {
+        /**
+         * The games hosted on one worker thread. Requests are queued
+         * from the I/O thread and handled in order, and each game is
+         * only ever touched by its shard, so the games need no locks.
+         * Every game refers to the same configuration; besides its
+         * board a game only keeps whose turn it is and who owns it.
+         */
+        class GameShard
+        {
+        public:
+            using Id_t = std::uint64_t;
+            using Connection_t = std::uint64_t;
+            //Called on the shard's thread with a line for a connection, without the newline,
+            //empty only for a Flush
+            using Reply_t = std::function<void (Connection_t, std::string)>;
+
+            class Request
+            {
+            public:
+                enum class Kind
+                {
+                    New,    //create game, which the server numbered
+                    Moves,  //list the legal moves
+                    Move,   //make argument, in algebraic notation or by its tiles
+                    Pieces, //list the pieces and where they are
+                    Close,  //end the game
+                    Drop,   //end every game of the connection, which went away
+                    Flush   //reply an empty line once the earlier requests of the connection are answered
+                };
+                Kind kind;
+                Connection_t connection;
+                Id_t game;
+                std::string argument;
+            };
+
+        private:
+            class Game
+            {
+            public:
+                Connection_t owner;
+                std::size_t turn;
+                board::Board board;
+
+                Game(config::BoardConfig const &config, Connection_t owner_, std::size_t turn_)
+                : owner{owner_}
+                , turn{turn_}
+                , board{config}
+                {
+                }
+            };
+
+            config::BoardConfig const &config;
+            engine::Players_t const &players;
+            std::size_t first;
+            Reply_t reply;
+
+            std::unordered_map<Id_t, std::unique_ptr<Game>> games;
+            std::atomic<std::size_t> count {0};
+            //reused for every game
+            engine::MoveGenerator generate;
+            engine::Notation notation;
+            engine::Moves_t moves;
+
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::deque<Request> queue;
+            bool stopping = false;
+            std::thread worker; //last, so everything is ready before it starts
+
+            void run();
+            void handle(Request &r);
+            Game *find(Request const &r);
+
+        public:
+            GameShard(config::BoardConfig const &config, engine::Players_t const &players, std::size_t first, Reply_t reply);
+            GameShard(GameShard const &) = delete;
+            GameShard &operator=(GameShard const &) = delete;
+            //Finishes the queued requests first
+            ~GameShard();
+
+            void post(Request r);
+            //How many games are hosted, from any thread
+            std::size_t gameCount() const noexcept
+            {
+                return count.load(std::memory_order_relaxed);
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,404 @@
+#include "Server.hpp"
+#include "Exception.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+namespace chesspp
+{
+    namespace server
+    {
+        constexpr std::size_t Server::MaxLine;
+        constexpr Server::Connection_t Server::Listener;
+        constexpr Server::Connection_t Server::Wake;
+
+        namespace
+        {
+            static Exception failure(std::string const &what)
+            {
+                return Exception(what + ": " + std::strerror(errno));
+            }
+            static int watch(int poller, int fd, Server::Connection_t id, std::uint32_t events, int op = EPOLL_CTL_ADD)
+            {
+                epoll_event e {};
+                e.events = events;
+                e.data.u64 = id;
+                return ::epoll_ctl(poller, op, fd, &e);
+            }
+            //Splits "move 12 Nf3" into its words
+            static std::vector<std::string> words(std::string const &line)
+            {
+                std::vector<std::string> w;
+                std::istringstream s {line};
+                for(std::string word; s >> word; )
+                {
+                    w.push_back(word);
+                }
+                return w;
+            }
+        }
+
+        Server::Server(config::BoardConfig const &config_, std::string const &address, std::uint16_t port_, std::size_t threads)
+        : config(config_) //can't use {}
+        , players{engine::players(config, first)}
+        {
+            if(players.empty())
+            {
+                throw Exception("the board has no suits");
+            }
+            board::Board::loadPieceClasses(config); //before the shards construct boards
+            sockaddr_in at {};
+            at.sin_family = AF_INET;
+            at.sin_port = htons(port_);
+            if(::inet_pton(AF_INET, address.c_str(), &at.sin_addr) != 1)
+            {
+                throw Exception("\"" + address + "\" is not an IPv4 address");
+            }
+
+            listener = ::socket(AF_INET, SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC, 0);
+            if(listener < 0) throw failure("socket");
+            int yes = 1;
+            ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            if(::bind(listener, reinterpret_cast<sockaddr *>(&at), sizeof(at)) != 0
+            || ::listen(listener, SOMAXCONN) != 0)
+            {
+                Exception e = failure("listening on " + address + ":" + std::to_string(port_));
+                ::close(listener);
+                throw e;
+            }
+            poller = ::epoll_create1(EPOLL_CLOEXEC);
+            waker = ::eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+            if(poller < 0 || waker < 0
+            || watch(poller, listener, Listener, EPOLLIN) != 0
+            || watch(poller, waker, Wake, EPOLLIN) != 0)
+            {
+                Exception e = failure("epoll");
+                if(poller >= 0) ::close(poller);
+                if(waker >= 0) ::close(waker);
+                ::close(listener);
+                throw e;
+            }
+
+            if(threads == 0)
+            {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            for(std::size_t i = 0; i < threads; ++i)
+            {
+                shards.emplace_back(new GameShard(config, players, first, [this](Connection_t c, std::string line)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock {outbox_mutex};
+                        outbox.emplace_back(c, std::move(line));
+                    }
+                    std::uint64_t one = 1;
+                    while(::write(waker, &one, sizeof(one)) < 0 && errno == EINTR) {}
+                }));
+            }
+        }
+        Server::~Server()
+        {
+            shards.clear(); //their threads may still reply
+            for(auto &c : connections)
+            {
+                ::close(c.second.fd);
+            }
+            ::close(waker);
+            ::close(poller);
+            ::close(listener);
+        }
+
+        std::uint16_t Server::port() const
+        {
+            sockaddr_in at {};
+            socklen_t length = sizeof(at);
+            if(::getsockname(listener, reinterpret_cast<sockaddr *>(&at), &length) != 0)
+            {
+                throw failure("getsockname");
+            }
+            return ntohs(at.sin_port);
+        }
+
+        void Server::stop() noexcept
+        {
+            stopping = true;
+            std::uint64_t one = 1;
+            while(::write(waker, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        }
+
+        void Server::run()
+        {
+            epoll_event events[64];
+            while(!stopping)
+            {
+                int n = ::epoll_wait(poller, events, 64, -1);
+                if(n < 0)
+                {
+                    if(errno == EINTR) continue;
+                    throw failure("epoll_wait");
+                }
+                for(int i = 0; i < n; ++i)
+                {
+                    Connection_t id = events[i].data.u64;
+                    if(id == Listener)
+                    {
+                        accept();
+                        continue;
+                    }
+                    if(id == Wake)
+                    {
+                        std::uint64_t count;
+                        while(::read(waker, &count, sizeof(count)) > 0) {}
+                        deliver();
+                        continue;
+                    }
+                    auto it = connections.find(id);
+                    if(it == connections.end()) continue; //closed by an earlier event
+                    if(events[i].events & (EPOLLIN|EPOLLHUP|EPOLLERR))
+                    {
+                        read(id, it->second);
+                    }
+                    it = connections.find(id);
+                    if(it != connections.end() && (events[i].events & EPOLLOUT))
+                    {
+                        write(id, it->second);
+                    }
+                }
+            }
+        }
+
+        void Server::accept()
+        {
+            for(;;)
+            {
+                int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK|SOCK_CLOEXEC);
+                if(fd < 0)
+                {
+                    if(errno == EINTR || errno == ECONNABORTED) continue;
+                    if(errno != EAGAIN && errno != EWOULDBLOCK)
+                    {
+                        std::cerr << "Server could not accept a connection: " << std::strerror(errno) << std::endl;
+                    }
+                    return;
+                }
+                int yes = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)); //replies are small and awaited
+                Connection_t id = next_connection++;
+                if(watch(poller, fd, id, EPOLLIN) != 0)
+                {
+                    ::close(fd);
+                    continue;
+                }
+                Connection c;
+                c.fd = fd;
+                connections.emplace(id, std::move(c));
+            }
+        }
+
+        void Server::read(Connection_t id, Connection &c)
+        {
+            if(!c.reading) return close(id); //hung up after it stopped sending
+            char buffer[4096];
+            bool ended = false;
+            for(;;)
+            {
+                ssize_t n = ::recv(c.fd, buffer, sizeof(buffer), 0);
+                if(n > 0)
+                {
+                    c.in.append(buffer, std::size_t(n));
+                    if(c.in.size() > 16*MaxLine) break; //the rest waits for the next event
+                    continue;
+                }
+                if(n < 0 && errno == EINTR) continue;
+                if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                if(n < 0) return close(id); //the other end went away
+                ended = true; //it has nothing more to send, but still gets the replies
+                break;
+            }
+
+            std::size_t start = 0;
+            for(std::size_t end; !c.closing && (end = c.in.find('\n', start)) != std::string::npos; start = end + 1)
+            {
+                std::string line = c.in.substr(start, end - start);
+                if(!line.empty() && line.back() == '\r') line.pop_back();
+                request(id, c, line);
+            }
+            c.in.erase(0, start);
+            if(c.in.size() > MaxLine && !c.closing)
+            {
+                send(c, "error line too long");
+                c.closing = true;
+            }
+            if(c.closing || ended) return finish(id, c);
+            if(!c.out.empty()) write(id, c);
+        }
+
+        void Server::finish(Connection_t id, Connection &c)
+        {
+            c.closing = true;
+            c.in.clear();
+            if(c.reading)
+            {
+                //the shards answer in order, so each has replied to the connection once it flushes
+                c.reading = false;
+                c.flushes = shards.size();
+                GameShard::Request r;
+                r.kind = GameShard::Request::Kind::Flush;
+                r.connection = id;
+                r.game = 0;
+                for(auto &s : shards)
+                {
+                    s->post(r);
+                }
+                rewatch(id, c);
+            }
+            if(!c.writing) write(id, c);
+        }
+
+        void Server::request(Connection_t id, Connection &c, std::string const &line)
+        {
+            using Kind = GameShard::Request::Kind;
+            auto w = words(line);
+            if(w.empty()) return;
+            if(w[0] == "quit")
+            {
+                c.closing = true;
+                return;
+            }
+            if(w[0] == "games" && w.size() == 1)
+            {
+                std::size_t total = 0;
+                for(auto const &s : shards) total += s->gameCount();
+                return send(c, "games " + std::to_string(total));
+            }
+
+            GameShard::Request r;
+            r.connection = id;
+            if(w[0] == "new" && w.size() == 1)
+            {
+                r.kind = Kind::New;
+                r.game = next_game++;
+            }
+            else
+            {
+                if     (w[0] == "moves"  && w.size() == 2) r.kind = Kind::Moves;
+                else if(w[0] == "move"   && w.size() == 3) r.kind = Kind::Move;
+                else if(w[0] == "pieces" && w.size() == 2) r.kind = Kind::Pieces;
+                else if(w[0] == "close"  && w.size() == 2) r.kind = Kind::Close;
+                else return send(c, "error unknown request \"" + line + "\"");
+                char *end = nullptr;
+                errno = 0;
+                r.game = std::strtoull(w[1].c_str(), &end, 10);
+                if(*end != '\0' || errno != 0 || r.game == 0)
+                {
+                    return send(c, "error \"" + w[1] + "\" is not a game");
+                }
+                if(w.size() == 3) r.argument = w[2];
+            }
+            shards[r.game%shards.size()]->post(std::move(r));
+        }
+
+        void Server::send(Connection &c, std::string const &line)
+        {
+            c.out += line;
+            c.out += '\n';
+        }
+
+        void Server::deliver()
+        {
+            decltype(outbox) replies;
+            {
+                std::lock_guard<std::mutex> lock {outbox_mutex};
+                replies.swap(outbox);
+            }
+            std::vector<Connection_t> touched;
+            for(auto &r : replies)
+            {
+                auto it = connections.find(r.first);
+                if(it == connections.end()) continue; //it went away in the meantime
+                if(r.second.empty())
+                {
+                    //a flush, once the last is in and written it can close
+                    if(--it->second.flushes == 0 && it->second.out.empty()) close(r.first);
+                    continue;
+                }
+                if(it->second.out.empty()) touched.push_back(r.first);
+                send(it->second, r.second);
+            }
+            for(auto id : touched)
+            {
+                auto it = connections.find(id);
+                if(it != connections.end() && !it->second.writing)
+                {
+                    write(id, it->second);
+                }
+            }
+        }
+
+        void Server::write(Connection_t id, Connection &c)
+        {
+            std::size_t sent = 0;
+            while(sent < c.out.size())
+            {
+                ssize_t n = ::send(c.fd, c.out.data() + sent, c.out.size() - sent, MSG_NOSIGNAL);
+                if(n > 0)
+                {
+                    sent += std::size_t(n);
+                    continue;
+                }
+                if(n < 0 && errno == EINTR) continue;
+                if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                return close(id);
+            }
+            c.out.erase(0, sent);
+            if(c.out.empty() && c.closing && c.flushes == 0)
+            {
+                return close(id);
+            }
+            bool writing = !c.out.empty();
+            if(writing != c.writing)
+            {
+                c.writing = writing;
+                rewatch(id, c);
+            }
+        }
+
+        void Server::rewatch(Connection_t id, Connection const &c)
+        {
+            //only wait for the socket to be writable while there is something to write
+            std::uint32_t events = (c.reading? std::uint32_t(EPOLLIN) : 0u) | (c.writing? std::uint32_t(EPOLLOUT) : 0u);
+            watch(poller, c.fd, id, events, EPOLL_CTL_MOD);
+        }
+
+        void Server::close(Connection_t id)
+        {
+            auto it = connections.find(id);
+            if(it == connections.end()) return;
+            ::close(it->second.fd); //also removes it from the poller
+            connections.erase(it);
+
+            GameShard::Request r;
+            r.kind = GameShard::Request::Kind::Drop;
+            r.connection = id;
+            r.game = 0;
+            for(auto &s : shards)
+            {
+                s->post(r);
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef ChessPlusPlus_Server_MultiGameServerClass_HeaderPlusPlus
+#define ChessPlusPlus_Server_MultiGameServerClass_HeaderPlusPlus
+
+#include "GameShard.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <string>
+#include <utility>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace server
+    {
+        /**
+         * Hosts games for clients connected over TCP, one line per
+         * request and one line per reply. A single thread waits on
+         * every socket with epoll, and the games are split across
+         * shards each running on its own thread, by game id.
+         *
+         * Requests, where id is the number given by "new":
+         *  - new             -> id new Suit
+         *  - moves id        -> id moves e2e4 ...
+         *  - move id Nf3     -> id moved g1f3 Suit, then id over checkmate|stalemate|repetition|fifty if it ended
+         *                       (tiles like g1f3 are accepted too)
+         *  - pieces id       -> id pieces Suit:Class:e1 ...
+         *  - close id        -> id closed
+         *  - games           -> games N, the total hosted
+         *  - quit            closes the connection once the earlier requests are answered,
+         *                    as does the client shutting down its side
+         * Failures reply "id error ..." or "error ...". Replies about
+         * one game come in the order of its requests, but replies
+         * about different games may come in any order. Games belong
+         * to the connection that created them and end with it.
+         */
+        class Server
+        {
+        public:
+            using Connection_t = GameShard::Connection_t;
+            static constexpr std::size_t MaxLine = 4096;
+
+        private:
+            class Connection
+            {
+            public:
+                int fd;
+                std::string in, out;
+                bool writing = false; //waiting for the socket to take more of out
+                bool closing = false; //close once out is written
+                bool reading = true;  //until it closes or stops sending
+                std::size_t flushes = 0; //shards yet to answer the requests made before closing
+            };
+            //epoll data of the sockets that aren't connections
+            static constexpr Connection_t Listener = 0, Wake = 1;
+
+            config::BoardConfig const &config;
+            std::size_t first = 0; //before players, which sets it
+            engine::Players_t players;
+            int listener = -1, poller = -1, waker = -1;
+            std::atomic<bool> stopping {false};
+            std::unordered_map<Connection_t, Connection> connections;
+            Connection_t next_connection = Wake + 1;
+            GameShard::Id_t next_game = 1;
+
+            std::mutex outbox_mutex;
+            std::vector<std::pair<Connection_t, std::string>> outbox; //replies from the shards
+            std::vector<std::unique_ptr<GameShard>> shards; //last, as their threads reply into the above
+
+            void accept();
+            void read(Connection_t id, Connection &c);
+            void write(Connection_t id, Connection &c);
+            void close(Connection_t id);
+            void finish(Connection_t id, Connection &c); //stops reading, closes once every reply is written
+            void rewatch(Connection_t id, Connection const &c);
+            void deliver();
+            void request(Connection_t id, Connection &c, std::string const &line);
+            void send(Connection &c, std::string const &line);
+
+        public:
+            //Listens on address:port, port 0 picks a free one. Zero threads uses one per core.
+            Server(config::BoardConfig const &config, std::string const &address, std::uint16_t port, std::size_t threads);
+            Server(Server const &) = delete;
+            Server &operator=(Server const &) = delete;
+            ~Server();
+
+            //Serves until stop() is called
+            void run();
+            //Safe to call from any thread and from signal handlers
+            void stop() noexcept;
+
+            std::uint16_t port() const;
+            std::size_t threadCount() const noexcept
+            {
+                return shards.size();
+            }
+        };
+    }
+}
+
+#endif
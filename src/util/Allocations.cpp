@@ -0,0 +1,94 @@
+#include "Allocations.hpp"
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace util
+    {
+        namespace
+        {
+            //Plain thread_locals need no construction, so operator new can use them from the start
+            static thread_local std::uint64_t thread_count = 0, thread_bytes = 0;
+            static std::atomic<std::uint64_t> all_count {0}, all_bytes {0};
+
+#ifdef CHESSPP_TRACK_ALLOCATIONS
+            static void *allocate(std::size_t size)
+            {
+                ++thread_count;
+                thread_bytes += size;
+                all_count.fetch_add(1, std::memory_order_relaxed);
+                all_bytes.fetch_add(size, std::memory_order_relaxed);
+                for(;;)
+                {
+                    if(void *p = std::malloc(size? size : 1))
+                    {
+                        return p;
+                    }
+                    auto handler = std::get_new_handler();
+                    if(!handler)
+                    {
+                        throw std::bad_alloc{};
+                    }
+                    handler();
+                }
+            }
+#endif
+        }
+
+        Allocations::Totals Allocations::thread() noexcept
+        {
+            return Totals{thread_count, thread_bytes};
+        }
+        Allocations::Totals Allocations::all() noexcept
+        {
+            return Totals{all_count.load(std::memory_order_relaxed), all_bytes.load(std::memory_order_relaxed)};
+        }
+    }
+}
+
+#ifdef CHESSPP_TRACK_ALLOCATIONS
+//Replaced for every program linking this file, which is any that asks for the counts
+void *operator new(std::size_t size)
+{
+    return chesspp::util::allocate(size);
+}
+void *operator new[](std::size_t size)
+{
+    return chesspp::util::allocate(size);
+}
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept
+{
+    try
+    {
+        return chesspp::util::allocate(size);
+    }
+    catch(std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void *p, std::nothrow_t const &) noexcept
+{
+    std::free(p);
+}
+void operator delete[](void *p, std::nothrow_t const &) noexcept
+{
+    std::free(p);
+}
+#endif
@@ -0,0 +1,103 @@
+#ifndef ChessPlusPlus_Util_AllocationCounterClass_HeaderPlusPlus
+#define ChessPlusPlus_Util_AllocationCounterClass_HeaderPlusPlus
+
+#include "Profiler.hpp"
+
+#include <cstdint>
+
+//Counts the allocations made during the rest of the enclosing scope as a profiler counter,
+//named as given followed by " allocations", which must be a string literal.
+//Compiled out unless both CHESSPP_TRACK_ALLOCATIONS and CHESSPP_PROFILE are defined.
+#if defined(CHESSPP_TRACK_ALLOCATIONS) && defined(CHESSPP_PROFILE)
+    #define CHESSPP_PROFILE_ALLOCATIONS(name) \
+        static ::chesspp::util::Profiler::Site const CHESSPP_PROFILE_CONCAT(chesspp_allocations_site_, __LINE__) {name " allocations"}; \
+        ::chesspp::util::Allocations::Counter const CHESSPP_PROFILE_CONCAT(chesspp_allocations_, __LINE__) {CHESSPP_PROFILE_CONCAT(chesspp_allocations_site_, __LINE__)}
+#else
+    #define CHESSPP_PROFILE_ALLOCATIONS(name) ((void)0)
+#endif
+
+namespace chesspp
+{
+    namespace util
+    {
+        /**
+         * Counts heap allocations when built with
+         * CHESSPP_TRACK_ALLOCATIONS, which replaces the global
+         * operator new and operator delete, so that hot paths can be
+         * checked not to allocate once they have warmed up:
+         *
+         *     Allocations::Scope scope;
+         *     board.makeMove(...);
+         *     board.unmakeMove();
+         *     assert(scope.count() == 0);
+         *
+         * Otherwise every count stays zero. Each thread counts its own
+         * allocations, so a scope only sees those of its thread.
+         */
+        class Allocations
+        {
+        public:
+            class Totals
+            {
+            public:
+                std::uint64_t count, bytes;
+            };
+
+            //Made by this thread so far
+            static Totals thread() noexcept;
+            //Made by every thread so far
+            static Totals all() noexcept;
+            //Whether allocations are counted at all
+            static constexpr bool enabled() noexcept
+            {
+#ifdef CHESSPP_TRACK_ALLOCATIONS
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            //The allocations of this thread since construction
+            class Scope
+            {
+                Totals const start;
+
+            public:
+                Scope() noexcept
+                : start(thread()) //can't use {}
+                {
+                }
+
+                std::uint64_t count() const noexcept
+                {
+                    return thread().count - start.count;
+                }
+                std::uint64_t bytes() const noexcept
+                {
+                    return thread().bytes - start.bytes;
+                }
+            };
+
+            //Adds the allocations of its scope to a profiler counter, for CHESSPP_PROFILE_ALLOCATIONS
+            class Counter
+            {
+                Profiler::Site const &site;
+                Scope scope;
+
+            public:
+                Counter(Profiler::Site const &s) noexcept
+                : site(s) //can't use {}
+                {
+                }
+                Counter(Counter const &) = delete;
+                Counter &operator=(Counter const &) = delete;
+                ~Counter()
+                {
+                    Profiler::count(site, scope.count());
+                }
+            };
+        };
+    }
+}
+
+#endif
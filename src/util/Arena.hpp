@@ -0,0 +1,58 @@
+#ifndef ChessPlusPlus_Util_MonotonicArenaClass_HeaderPlusPlus
+#define ChessPlusPlus_Util_MonotonicArenaClass_HeaderPlusPlus
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace util
+    {
+        /**
+         * Hands out memory from large blocks and frees all of it at
+         * once when destroyed, for the many small allocations of
+         * structures that are built once and then only read.
+         */
+        class Arena
+        {
+            static constexpr std::size_t Alignment = alignof(std::max_align_t);
+
+            std::vector<std::unique_ptr<char[]>> blocks;
+            char *at = nullptr;
+            std::size_t left = 0;
+            std::size_t block_size;
+
+        public:
+            explicit Arena(std::size_t block_size_ = 64*1024) noexcept
+            : block_size{block_size_}
+            {
+            }
+            Arena(Arena const &) = delete;
+            Arena &operator=(Arena const &) = delete;
+
+            //Aligned for any type; allocations larger than a block get their own
+            void *allocate(std::size_t n)
+            {
+                n = (n + Alignment - 1)/Alignment*Alignment;
+                if(n > left)
+                {
+                    if(n > block_size/4)
+                    {
+                        blocks.emplace_back(new char[n]);
+                        return blocks.back().get();
+                    }
+                    blocks.emplace_back(new char[block_size]);
+                    at = blocks.back().get();
+                    left = block_size;
+                }
+                void *p = at;
+                at += n;
+                left -= n;
+                return p;
+            }
+        };
+    }
+}
+
+#endif
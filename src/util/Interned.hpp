@@ -0,0 +1,166 @@
+#ifndef ChessPlusPlus_Util_InternedStringClass_HeaderPlusPlus
+#define ChessPlusPlus_Util_InternedStringClass_HeaderPlusPlus
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <ostream>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace util
+    {
+        /**
+         * A string kept once in a table shared by the whole program,
+         * so that a copy is a single pointer and telling two apart is
+         * a pointer comparison. Each tag has its own table, in which
+         * strings are numbered from zero in the order they were first
+         * seen, the empty string being zero. Ordering still follows
+         * the strings, so sorted containers keep their order.
+         * \tparam Tag distinguishes tables, e.g. suits from piece classes.
+         */
+        template<typename Tag>
+        class Interned
+        {
+        public:
+            using Id_t = std::uint32_t;
+
+        private:
+            class Entry
+            {
+            public:
+                std::string name;
+                Id_t id;
+            };
+            class Table
+            {
+            public:
+                std::mutex mutex;
+                std::deque<Entry> entries; //never moved once added
+                std::unordered_map<std::string, Entry const *> index;
+
+                Table()
+                {
+                    entries.push_back(Entry{std::string(), 0});
+                    index.emplace(std::string(), &entries.back());
+                }
+            };
+            static Table &table()
+            {
+                static Table t;
+                return t;
+            }
+            static Entry const *intern(std::string const &s)
+            {
+                Table &t = table();
+                std::lock_guard<std::mutex> lock {t.mutex};
+                auto it = t.index.find(s);
+                if(it != t.index.end())
+                {
+                    return it->second;
+                }
+                t.entries.push_back(Entry{s, Id_t(t.entries.size())});
+                return t.index.emplace(s, &t.entries.back()).first->second;
+            }
+
+            Entry const *e;
+
+        public:
+            //The empty string
+            Interned()
+            : e{intern(std::string())}
+            {
+            }
+            Interned(std::string const &s)
+            : e{intern(s)}
+            {
+            }
+            Interned(char const *s)
+            : e{intern(s)}
+            {
+            }
+
+            std::string const &name() const noexcept
+            {
+                return e->name;
+            }
+            //Small and dense, for indexing tables by
+            Id_t id() const noexcept
+            {
+                return e->id;
+            }
+            operator std::string const &() const noexcept
+            {
+                return e->name;
+            }
+            bool empty() const noexcept
+            {
+                return e->id == 0;
+            }
+
+            friend bool operator==(Interned const &a, Interned const &b) noexcept
+            {
+                return a.e == b.e;
+            }
+            friend bool operator!=(Interned const &a, Interned const &b) noexcept
+            {
+                return a.e != b.e;
+            }
+            friend bool operator<(Interned const &a, Interned const &b) noexcept
+            {
+                return a.e != b.e && a.e->name < b.e->name;
+            }
+            //Against strings that were not interned, without interning them
+            friend bool operator==(Interned const &a, char const *s) noexcept
+            {
+                return a.e->name == s;
+            }
+            friend bool operator!=(Interned const &a, char const *s) noexcept
+            {
+                return a.e->name != s;
+            }
+            friend bool operator==(Interned const &a, std::string const &s) noexcept
+            {
+                return a.e->name == s;
+            }
+            friend bool operator!=(Interned const &a, std::string const &s) noexcept
+            {
+                return a.e->name != s;
+            }
+
+            friend std::ostream &operator<<(std::ostream &os, Interned const &i)
+            {
+                return os << i.e->name;
+            }
+            friend std::string operator+(Interned const &a, std::string const &b)
+            {
+                return a.e->name + b;
+            }
+            friend std::string operator+(std::string const &a, Interned const &b)
+            {
+                return a + b.e->name;
+            }
+            friend std::string operator+(Interned const &a, char const *b)
+            {
+                return a.e->name + b;
+            }
+        };
+    }
+}
+namespace std
+{
+    template<typename Tag>
+    struct hash<::chesspp::util::Interned<Tag>>
+    {
+        std::size_t operator()(::chesspp::util::Interned<Tag> const &i) const noexcept
+        {
+            return std::hash<std::uint32_t>{}(i.id());
+        }
+    };
+}
+
+#endif
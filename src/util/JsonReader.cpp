@@ -0,0 +1,223 @@
+#include "JsonReader.hpp"
+#include "Serialization.hpp"
+
+#include <new>
+#include <cstring>
+#include <cstdint>
+
+namespace chesspp
+{
+    namespace util
+    {
+        namespace
+        {
+            static void *allocate(std::size_t size, int zero, void *arena)
+            {
+                void *p = static_cast<Arena *>(arena)->allocate(size);
+                if(zero) std::memset(p, 0, size);
+                return p;
+            }
+            static void release(void *, void *) noexcept
+            {
+                //freed with the arena
+            }
+
+            static void write(ByteWriter &out, json_value const &v)
+            {
+                out.value(std::uint8_t(v.type));
+                switch(v.type)
+                {
+                case json_boolean: out.value(std::uint8_t(v.u.boolean != 0));   break;
+                case json_integer: out.value(std::int64_t(v.u.integer));        break;
+                case json_double:  out.value(v.u.dbl);                         break;
+                case json_string:  out.string(v.u.string.ptr, v.u.string.length); break;
+                case json_array:
+                {
+                    out.value(std::uint32_t(v.u.array.length));
+                    for(unsigned i = 0; i < v.u.array.length; ++i)
+                    {
+                        write(out, *v.u.array.values[i]);
+                    }
+                    break;
+                }
+                case json_object:
+                {
+                    out.value(std::uint32_t(v.u.object.length));
+                    for(unsigned i = 0; i < v.u.object.length; ++i)
+                    {
+                        out.string(v.u.object.values[i].name, v.u.object.values[i].name_length);
+                        write(out, *v.u.object.values[i].value);
+                    }
+                    break;
+                }
+                default: break;
+                }
+            }
+
+            /**
+             * Counts what the values in a compiled JSON need, so that
+             * they can all be allocated at once, and checks that the
+             * data is well formed before anything is built from it.
+             */
+            class Measure
+            {
+            public:
+                std::size_t nodes = 0, entries = 0, pointers = 0, chars = 0;
+
+                bool operator()(ByteReader &in)
+                {
+                    ++nodes;
+                    std::size_t length;
+                    switch(json_type(in.value<std::uint8_t>()))
+                    {
+                    case json_null:                             break;
+                    case json_boolean: in.value<std::uint8_t>(); break;
+                    case json_integer: in.value<std::int64_t>(); break;
+                    case json_double:  in.value<double>();       break;
+                    case json_string:
+                    {
+                        in.string(length);
+                        chars += length + 1;
+                        break;
+                    }
+                    case json_array:
+                    {
+                        auto n = in.value<std::uint32_t>();
+                        pointers += n;
+                        for(std::uint32_t i = 0; i < n && in.ok(); ++i)
+                        {
+                            if(!(*this)(in)) return false;
+                        }
+                        break;
+                    }
+                    case json_object:
+                    {
+                        auto n = in.value<std::uint32_t>();
+                        entries += n;
+                        for(std::uint32_t i = 0; i < n && in.ok(); ++i)
+                        {
+                            in.string(length);
+                            chars += length + 1;
+                            if(!(*this)(in)) return false;
+                        }
+                        break;
+                    }
+                    default: return false;
+                    }
+                    return in.ok();
+                }
+            };
+
+            //Builds values from data that Measure accepted, into the space it asked for
+            class Build
+            {
+            public:
+                json_value *node;
+                json_object_entry *entry;
+                json_value **pointer;
+                char *chars;
+
+                char *string(ByteReader &in, unsigned &length)
+                {
+                    std::size_t n;
+                    char const *s = in.string(n);
+                    char *copy = chars;
+                    std::memcpy(copy, s, n);
+                    copy[n] = '\0';
+                    chars += n + 1;
+                    length = unsigned(n);
+                    return copy;
+                }
+                json_value *operator()(ByteReader &in, json_value *parent)
+                {
+                    json_value *v = new (node++) json_value; //zeroes the value
+                    v->parent = parent;
+                    v->type = json_type(in.value<std::uint8_t>());
+                    switch(v->type)
+                    {
+                    case json_boolean: v->u.boolean = in.value<std::uint8_t>();         break;
+                    case json_integer: v->u.integer = json_int_t(in.value<std::int64_t>()); break;
+                    case json_double:  v->u.dbl = in.value<double>();                  break;
+                    case json_string:  v->u.string.ptr = string(in, v->u.string.length);   break;
+                    case json_array:
+                    {
+                        v->u.array.length = in.value<std::uint32_t>();
+                        v->u.array.values = pointer;
+                        pointer += v->u.array.length;
+                        for(unsigned i = 0; i < v->u.array.length; ++i)
+                        {
+                            v->u.array.values[i] = (*this)(in, v);
+                        }
+                        break;
+                    }
+                    case json_object:
+                    {
+                        v->u.object.length = in.value<std::uint32_t>();
+                        v->u.object.values = entry;
+                        entry += v->u.object.length;
+                        for(unsigned i = 0; i < v->u.object.length; ++i)
+                        {
+                            auto &e = v->u.object.values[i];
+                            e.name = string(in, e.name_length);
+                            e.value = (*this)(in, v);
+                        }
+                        break;
+                    }
+                    default: break;
+                    }
+                    return v;
+                }
+            };
+        }
+
+        void JsonReader::parse(char const *text, std::size_t length)
+        {
+            json_settings options {};
+            options.mem_alloc = allocate;
+            options.mem_free = release;
+            options.user_data = arena.get();
+            char error[json_error_max];
+            json = json_parse_ex(&options, text, length, error);
+            if(json == nullptr)
+            {
+                //no manual cleanup needed
+                throw Exception(std::string("Error loading JSON: ") + error);
+            }
+        }
+
+        std::string JsonReader::compile() const
+        {
+            std::string out;
+            ByteWriter writer {out};
+            write(writer, *json);
+            return out;
+        }
+
+        JsonReader JsonReader::load(void const *data, std::size_t size)
+        {
+            Measure measure;
+            ByteReader in {data, size};
+            if(!measure(in) || in.remaining() != 0)
+            {
+                throw Exception("Error loading compiled JSON: malformed data");
+            }
+
+            //values first, as they have the strictest alignment
+            std::size_t entries  = measure.nodes*sizeof(json_value);
+            std::size_t pointers = entries + measure.entries*sizeof(json_object_entry);
+            std::size_t chars    = pointers + measure.pointers*sizeof(json_value *);
+            std::unique_ptr<Arena> arena {new Arena};
+            char *block = static_cast<char *>(arena->allocate(chars + measure.chars));
+
+            Build build;
+            build.node    = reinterpret_cast<json_value *>(block);
+            build.entry   = reinterpret_cast<json_object_entry *>(block + entries);
+            build.pointer = reinterpret_cast<json_value **>(block + pointers);
+            build.chars   = block + chars;
+            ByteReader again {data, size};
+            JsonReader loaded {std::move(arena)};
+            loaded.json = build(again, nullptr);
+            return loaded;
+        }
+    }
+}
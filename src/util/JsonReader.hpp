@@ -2,6 +2,8 @@
 #define ChessPlusPlus_Util_JsonReaderClass_HeaderPlusPlus
 
 #include "Exception.hpp"
+#include "Arena.hpp"
+#include "MappedFile.hpp"
 
 #include <json.h>
 
@@ -9,7 +11,9 @@
 #include <istream>
 #include <streambuf>
 #include <cstdint>
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <utility>
 
 namespace chesspp
@@ -27,6 +31,16 @@ namespace chesspp
              * Underlying json_value pointer.
              */
             json_value *json {nullptr};
+            /**
+             * Holds every json_value, so that they are all
+             * freed at once instead of one by one.
+             */
+            std::unique_ptr<Arena> arena {new Arena};
+
+            explicit JsonReader(std::unique_ptr<Arena> arena_) noexcept
+            : arena{std::move(arena_)}
+            {
+            }
         public:
             JsonReader() = delete;
             JsonReader(JsonReader const &) = delete;
@@ -43,14 +57,30 @@ namespace chesspp
                     throw Exception("stream given to JsonReader in bad state");
                 }
                 std::string str ((std::istreambuf_iterator<char>(s)), std::istreambuf_iterator<char>());
-                json_settings options {0, 0, nullptr, nullptr, nullptr};
-                char error[json_error_max];
-                json = json_parse_ex(&options, str.c_str(), str.length(), error);
-                if(json == nullptr)
+                parse(str.c_str(), str.length());
+            }
+            /**
+             * Constructs this JsonReader from a mapped file,
+             * parsing the file where it lies without copying it.
+             * \param file The mapped file containing the JSON.
+             */
+            explicit JsonReader(MappedFile const &file)
+            {
+                if(!file.valid())
                 {
-                    //no manual cleanup needed
-                    throw Exception(std::string("Error loading JSON: ") + error);
+                    throw Exception("file given to JsonReader is not mapped");
                 }
+                parse(static_cast<char const *>(file.data()), file.size());
+            }
+            /**
+             * Constructs this JsonReader from JSON text in memory,
+             * which need not be null-terminated.
+             * \param text The JSON.
+             * \param length The length of the text.
+             */
+            JsonReader(char const *text, std::size_t length)
+            {
+                parse(text, length);
             }
             /**
              * Constructs this JsonReader from the given temporary stream.
@@ -67,6 +97,7 @@ namespace chesspp
              */
             JsonReader(JsonReader &&from)
             : json{from.json}
+            , arena{std::move(from.arena)}
             {
                 from.json = nullptr;
             }
@@ -87,15 +118,29 @@ namespace chesspp
             JsonReader &operator=(JsonReader &&from)
             {
                 std::swap(json, from.json);
+                std::swap(arena, from.arena);
                 return *this;
             }
             /**
              * Destructs this JsonReader freeing any allocated memory.
              */
-            ~JsonReader()
-            {
-                json_value_free(json), json = nullptr;
-            }
+            ~JsonReader() = default;
+
+            /**
+             * Serializes the parsed values to a binary form that
+             * load() turns back into a JsonReader without parsing.
+             * The form depends on the machine that wrote it.
+             * \return the binary form.
+             */
+            std::string compile() const;
+            /**
+             * Rebuilds a JsonReader from what compile() returned,
+             * allocating all of its values in one block.
+             * \param data the binary form.
+             * \param size the size of the binary form in bytes.
+             * \throws ::chesspp::Exception if the data is malformed.
+             */
+            static JsonReader load(void const *data, std::size_t size);
 
             /**
              * Represents a value in the JSON.
@@ -303,6 +348,10 @@ namespace chesspp
                 return navigate(access(), path...);
             }
         private:
+            /**
+             * Helper for the constructors, allocates from the arena.
+             */
+            void parse(char const *text, std::size_t length);
             /**
              * Helper for the public navigate.
              */
@@ -0,0 +1,97 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace chesspp
+{
+    namespace util
+    {
+        MappedFile::MappedFile(std::string const &path) noexcept
+        {
+#if defined(_WIN32)
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if(file == INVALID_HANDLE_VALUE)
+            {
+                file = nullptr;
+                return;
+            }
+            LARGE_INTEGER size;
+            if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+            {
+                close();
+                return;
+            }
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(!mapping)
+            {
+                close();
+                return;
+            }
+            address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            length = address? std::size_t(size.QuadPart) : 0;
+#else
+            descriptor = ::open(path.c_str(), O_RDONLY);
+            if(descriptor < 0)
+            {
+                return;
+            }
+            struct stat info;
+            if(::fstat(descriptor, &info) != 0 || info.st_size == 0) //empty files can't be mapped
+            {
+                close();
+                return;
+            }
+            void *a = ::mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+            if(a == MAP_FAILED)
+            {
+                close();
+                return;
+            }
+            address = a;
+            length = std::size_t(info.st_size);
+#endif
+        }
+
+        MappedFile::MappedFile(MappedFile &&from) noexcept
+        {
+            *this = std::move(from);
+        }
+        MappedFile &MappedFile::operator=(MappedFile &&from) noexcept
+        {
+            std::swap(address, from.address);
+            std::swap(length, from.length);
+#if defined(_WIN32)
+            std::swap(file, from.file);
+            std::swap(mapping, from.mapping);
+#else
+            std::swap(descriptor, from.descriptor);
+#endif
+            return *this;
+        }
+
+        void MappedFile::close() noexcept
+        {
+#if defined(_WIN32)
+            if(address) UnmapViewOfFile(address);
+            if(mapping) CloseHandle(mapping);
+            if(file)    CloseHandle(file);
+            file = mapping = nullptr;
+#else
+            if(address)         ::munmap(const_cast<void *>(address), length);
+            if(descriptor >= 0) ::close(descriptor);
+            descriptor = -1;
+#endif
+            address = nullptr;
+            length = 0;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef ChessPlusPlus_Util_MappedFileClass_HeaderPlusPlus
+#define ChessPlusPlus_Util_MappedFileClass_HeaderPlusPlus
+
+#include <string>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace util
+    {
+        /**
+         * A whole file mapped read-only into memory, so that binary
+         * data can be used where it lies without being read or parsed.
+         * Pages are loaded by the operating system as they are touched
+         * and shared between processes mapping the same file.
+         */
+        class MappedFile
+        {
+            void const *address = nullptr;
+            std::size_t length = 0;
+#if defined(_WIN32)
+            void *file = nullptr, *mapping = nullptr;
+#else
+            int descriptor = -1;
+#endif
+            void close() noexcept;
+
+        public:
+            MappedFile() = default;
+            //Check valid() to see whether the file could be mapped
+            MappedFile(std::string const &path) noexcept;
+            MappedFile(MappedFile const &) = delete;
+            MappedFile &operator=(MappedFile const &) = delete;
+            MappedFile(MappedFile &&from) noexcept;
+            MappedFile &operator=(MappedFile &&from) noexcept;
+            ~MappedFile()
+            {
+                close();
+            }
+
+            bool valid() const noexcept
+            {
+                return address != nullptr;
+            }
+            void const *data() const noexcept
+            {
+                return address;
+            }
+            std::size_t size() const noexcept
+            {
+                return length;
+            }
+        };
+    }
+}
+
+#endif
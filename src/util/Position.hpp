@@ -5,16 +5,21 @@
 
 #include <tuple>
 #include <ostream>
+#include <istream>
+#include <string>
 #include <cstdint>
+#include <cstddef>
 
 namespace chesspp
 {
     namespace util
     {
         /**
-         * Represents a direction.
+         * Represents a direction, one byte. The compass directions
+         * go clockwise from North, so they can be rotated and looked
+         * up in tables by value.
          */
-        enum class Direction
+        enum class Direction : std::uint8_t
         {
             None,
             North,
@@ -26,47 +31,39 @@ namespace chesspp
             West,
             NorthWest
         };
+        //Offsets of one step in each direction by value, positive x is east and positive y is south
+        constexpr signed char DirectionDeltaX[] = {0,  0,  1, 1, 1, 0, -1, -1, -1};
+        constexpr signed char DirectionDeltaY[] = {0, -1, -1, 0, 1, 1,  1,  0, -1};
+        constexpr char const *DirectionNames[] = {"None", "North", "NorthEast", "East", "SouthEast", "South", "SouthWest", "West", "NorthWest"};
+        /**
+         * Returns the x offset of one step in a direction.
+         * \param d the direction.
+         * \return -1, 0 or 1, positive is east.
+         */
+        constexpr signed DeltaX(Direction d) noexcept
+        {
+            return DirectionDeltaX[static_cast<std::uint8_t>(d)];
+        }
+        /**
+         * Returns the y offset of one step in a direction.
+         * \param d the direction.
+         * \return -1, 0 or 1, positive is south.
+         */
+        constexpr signed DeltaY(Direction d) noexcept
+        {
+            return DirectionDeltaY[static_cast<std::uint8_t>(d)];
+        }
         /**
          * Returns a new direction which is a rotation of the
          * provided direction.
          * \param d the direction to rotate.
-         * \param r the number of times to rotate, may be negative.
-         * \return the rotated direction.
+         * \param r the number of times to rotate by 45 degrees
+         * clockwise, may be negative.
+         * \return the rotated direction, None if d is None.
          */
-        inline Direction Rotate(Direction d, signed r) noexcept
+        constexpr Direction Rotate(Direction d, signed r) noexcept
         {
-            using D = Direction;
-            for(signed i = 0; i < r; ++i) //rotate positively
-            {
-                switch(d)
-                {
-                case D::North:     d = D::NorthEast; break;
-                case D::NorthEast: d = D::East;      break;
-                case D::East:      d = D::SouthEast; break;
-                case D::SouthEast: d = D::South;     break;
-                case D::South:     d = D::SouthWest; break;
-                case D::SouthWest: d = D::West;      break;
-                case D::West:      d = D::NorthWest; break;
-                case D::NorthWest: d = D::North;     break;
-                default:                             break;
-                }
-            }
-            for(signed i = 0; i > r; --i) //rotate negatively
-            {
-                switch(d)
-                {
-                case D::North:     d = D::NorthWest; break;
-                case D::NorthEast: d = D::North;     break;
-                case D::East:      d = D::NorthEast; break;
-                case D::SouthEast: d = D::East;      break;
-                case D::South:     d = D::SouthEast; break;
-                case D::SouthWest: d = D::South;     break;
-                case D::West:      d = D::SouthWest; break;
-                case D::NorthWest: d = D::West;      break;
-                default:                             break;
-                }
-            }
-            return d;
+            return d == Direction::None? d : Direction(1 + (static_cast<signed>(d) - 1 + r%8 + 8)%8);
         }
         /**
          * Serializes a direction to a stream in string format.
@@ -76,34 +73,21 @@ namespace chesspp
          */
         inline std::ostream &operator<<(std::ostream &os, Direction const &d) noexcept
         {
-            using D = Direction;
-            switch(d)
-            {
-            case D::North:     return os << "North";
-            case D::NorthEast: return os << "NorthEast";
-            case D::East:      return os << "East";
-            case D::SouthEast: return os << "SouthEast";
-            case D::South:     return os << "South";
-            case D::SouthWest: return os << "SouthWest";
-            case D::West:      return os << "West";
-            case D::NorthWest: return os << "NorthWest";
-            case D::None:      return os << "None";
-            }
+            return os << (d <= Direction::NorthWest? DirectionNames[static_cast<std::uint8_t>(d)] : "None");
         }
         inline std::istream &operator>>(std::istream &is, Direction &d)
         {
-            using D = Direction;
             std::string ds;
             is >> ds;
-            if     (ds == "North"    ) return (d = D::North    ), is;
-            else if(ds == "NorthEast") return (d = D::NorthEast), is;
-            else if(ds == "East"     ) return (d = D::East     ), is;
-            else if(ds == "SouthEast") return (d = D::SouthEast), is;
-            else if(ds == "South"    ) return (d = D::South    ), is;
-            else if(ds == "SouthWest") return (d = D::SouthWest), is;
-            else if(ds == "West"     ) return (d = D::West     ), is;
-            else if(ds == "NorthWest") return (d = D::NorthWest), is;
-            else                       return (d = D::None     ), is;
+            d = Direction::None;
+            for(std::uint8_t i = 1; i <= static_cast<std::uint8_t>(Direction::NorthWest); ++i)
+            {
+                if(ds == DirectionNames[i])
+                {
+                    d = Direction(i);
+                }
+            }
+            return is;
         }
 
         /**
@@ -138,7 +122,7 @@ namespace chesspp
              * \param x_ the x coordinate of this position, or T()
              * \param y_ the y coordinate of this position, or T()
              */
-            Position(T x_ = T(), T y_ = T()) noexcept
+            constexpr Position(T x_ = T(), T y_ = T()) noexcept
             : x{x_}
             , y{y_}
             {
@@ -185,30 +169,29 @@ namespace chesspp
              */
             Position &move(Direction const &d, signed times = 1) noexcept
             {
-                using D = Direction;
-                for(signed i = 0; i < times; ++i)
-                {
-                    //move forward
-                    switch(d)
-                    {
-                    case D::North:          --y; break;
-                    case D::NorthEast: ++x; --y; break;
-                    case D::East:      ++x;      break;
-                    case D::SouthEast: ++x; ++y; break;
-                    case D::South:          ++y; break;
-                    case D::SouthWest: --x; ++y; break;
-                    case D::West:      --x;      break;
-                    case D::NorthWest: --x; --y; break;
-                    default:                     break;
-                    }
-                }
-                if(times < 0)
+                x += DeltaX(d)*times;
+                y += DeltaY(d)*times;
+                return *this;
+            }
+            /**
+             * Writes the positions of a ray, the first n steps from
+             * this position in a direction, without checking bounds.
+             * Each step is worked out on its own from this position
+             * so that the loop can be vectorized.
+             * \param d the direction of the ray.
+             * \param n the number of positions to write.
+             * \param out where to write them, nearest first.
+             * \return out past the last position written.
+             */
+            template<typename OutputIt>
+            OutputIt ray(Direction d, std::size_t n, OutputIt out) const
+            {
+                signed const dx = DeltaX(d), dy = DeltaY(d);
+                for(std::size_t i = 1; i <= n; ++i, ++out)
                 {
-                    //move backward
-                    Position t = Position(0, 0).move(d, -times);
-                    move(-t.x, -t.y);
+                    *out = Position(T(x + dx*signed(i)), T(y + dy*signed(i)));
                 }
-                return *this;
+                return out;
             }
 
             /**
@@ -0,0 +1,244 @@
+#include "Profiler.hpp"
+
+#include <fstream>
+#include <memory>
+#include <algorithm>
+#include <iomanip>
+
+namespace chesspp
+{
+    namespace util
+    {
+        constexpr std::size_t Profiler::MaxSites;
+        constexpr std::size_t Profiler::MaxEvents;
+
+        namespace
+        {
+            using Clock_t = Profiler::Clock_t;
+
+            class Event
+            {
+            public:
+                char const *name;
+                Clock_t::time_point start;
+                Clock_t::duration length;
+            };
+
+            /**
+             * What one thread has recorded. Only the thread itself
+             * writes the totals, so they need no more than relaxed
+             * atomics to be read from elsewhere.
+             */
+            class Local
+            {
+            public:
+                std::atomic<std::uint64_t> counts[Profiler::MaxSites];
+                std::atomic<std::uint64_t> nanos[Profiler::MaxSites];
+                std::mutex events_mutex; //only contended when a trace stops
+                std::vector<Event> events;
+                std::size_t const tid;
+
+                Local(std::size_t tid_) noexcept;
+                ~Local();
+            };
+
+            class Registry
+            {
+            public:
+                std::mutex mutex;
+                std::vector<Local *> threads;
+                std::size_t next_tid = 0;
+                //totals of threads that have exited
+                std::uint64_t retired_counts[Profiler::MaxSites] {};
+                std::uint64_t retired_nanos[Profiler::MaxSites] {};
+                //totals at the end of the previous frame
+                std::uint64_t last_counts[Profiler::MaxSites] {};
+                std::uint64_t last_nanos[Profiler::MaxSites] {};
+
+                std::atomic<char const *> names[Profiler::MaxSites] {};
+                std::atomic<std::size_t> sites {0};
+
+                std::atomic<bool> tracing {false};
+                std::atomic<std::size_t> traced {0};
+                Clock_t::time_point trace_start;
+                std::vector<Event> retired_events;
+                std::vector<std::size_t> retired_tids;
+            };
+            //never destroyed, as threads may still exit after main returns
+            static Registry &registry()
+            {
+                static Registry *r = new Registry;
+                return *r;
+            }
+
+            Local::Local(std::size_t tid_) noexcept
+            : tid{tid_}
+            {
+                for(std::size_t i = 0; i < Profiler::MaxSites; ++i)
+                {
+                    counts[i].store(0, std::memory_order_relaxed);
+                    nanos[i].store(0, std::memory_order_relaxed);
+                }
+            }
+            Local::~Local()
+            {
+                Registry &r = registry();
+                std::lock_guard<std::mutex> lock {r.mutex};
+                for(std::size_t i = 0; i < Profiler::MaxSites; ++i)
+                {
+                    r.retired_counts[i] += counts[i].load(std::memory_order_relaxed);
+                    r.retired_nanos[i] += nanos[i].load(std::memory_order_relaxed);
+                }
+                {
+                    std::lock_guard<std::mutex> events_lock {events_mutex};
+                    r.retired_events.insert(r.retired_events.end(), events.begin(), events.end());
+                    r.retired_tids.insert(r.retired_tids.end(), events.size(), tid);
+                }
+                r.threads.erase(std::remove(r.threads.begin(), r.threads.end(), this), r.threads.end());
+            }
+
+            static Local &local()
+            {
+                static thread_local std::unique_ptr<Local> l;
+                if(!l)
+                {
+                    Registry &r = registry();
+                    std::lock_guard<std::mutex> lock {r.mutex};
+                    l.reset(new Local(r.next_tid++));
+                    r.threads.push_back(l.get());
+                }
+                return *l;
+            }
+
+            static void add(std::atomic<std::uint64_t> &total, std::uint64_t n) noexcept
+            {
+                //only this thread writes it
+                total.store(total.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+        }
+
+        Profiler::Site::Site(char const *name_) noexcept
+        : name{name_}
+        , id{registry().sites.fetch_add(1)}
+        {
+            //sites past the limit are ignored
+            if(id < MaxSites)
+            {
+                registry().names[id].store(name, std::memory_order_release);
+            }
+        }
+
+        void Profiler::time(Site const &site, Clock_t::time_point start, Clock_t::time_point end) noexcept
+        {
+            if(site.id >= MaxSites) return;
+            Local &l = local();
+            add(l.counts[site.id], 1);
+            add(l.nanos[site.id], std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+            Registry &r = registry();
+            if(r.tracing.load(std::memory_order_relaxed)
+            && r.traced.fetch_add(1, std::memory_order_relaxed) < MaxEvents)
+            {
+                std::lock_guard<std::mutex> lock {l.events_mutex};
+                try
+                {
+                    l.events.push_back(Event{site.name, start, end - start});
+                }
+                catch(...)
+                {
+                    //the trace is missing an event, which is no reason to stop
+                }
+            }
+        }
+        void Profiler::count(Site const &site, std::uint64_t n) noexcept
+        {
+            if(site.id >= MaxSites) return;
+            add(local().counts[site.id], n);
+        }
+
+        Profiler::Frame_t Profiler::frame()
+        {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> lock {r.mutex};
+            std::size_t sites = std::min(r.sites.load(), MaxSites);
+            Frame_t f;
+            for(std::size_t i = 0; i < sites; ++i)
+            {
+                char const *name = r.names[i].load(std::memory_order_acquire);
+                if(!name) continue; //still being registered
+                std::uint64_t counts = r.retired_counts[i], nanos = r.retired_nanos[i];
+                for(Local const *l : r.threads)
+                {
+                    counts += l->counts[i].load(std::memory_order_relaxed);
+                    nanos += l->nanos[i].load(std::memory_order_relaxed);
+                }
+                if(counts != r.last_counts[i])
+                {
+                    f.push_back(Sample{name, counts - r.last_counts[i], double(nanos - r.last_nanos[i])/1e6});
+                }
+                r.last_counts[i] = counts;
+                r.last_nanos[i] = nanos;
+            }
+            return f;
+        }
+
+        void Profiler::startTrace()
+        {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> lock {r.mutex};
+            for(Local *l : r.threads)
+            {
+                std::lock_guard<std::mutex> events_lock {l->events_mutex};
+                l->events.clear();
+            }
+            r.retired_events.clear();
+            r.retired_tids.clear();
+            r.traced.store(0);
+            r.trace_start = Clock_t::now();
+            r.tracing.store(true);
+        }
+        bool Profiler::tracing() noexcept
+        {
+            return registry().tracing.load(std::memory_order_relaxed);
+        }
+        bool Profiler::stopTrace(std::string const &path)
+        {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> lock {r.mutex};
+            r.tracing.store(false);
+
+            std::ofstream out {path, std::ios::out|std::ios::trunc};
+            if(!out) return false;
+            bool first = true;
+            auto write = [&](Event const &e, std::size_t tid)
+            {
+                using us = std::chrono::duration<double, std::micro>;
+                out << (first? "\n" : ",\n")
+                    << R"({"name":")" << e.name
+                    << R"(","ph":"X","ts":)" << us(e.start - r.trace_start).count()
+                    << R"(,"dur":)" << us(e.length).count()
+                    << R"(,"pid":1,"tid":)" << tid << "}";
+                first = false;
+            };
+            out << std::fixed << std::setprecision(3) << R"({"traceEvents":[)";
+            for(Local *l : r.threads)
+            {
+                std::lock_guard<std::mutex> events_lock {l->events_mutex};
+                for(Event const &e : l->events)
+                {
+                    write(e, l->tid);
+                }
+                l->events.clear();
+                l->events.shrink_to_fit();
+            }
+            for(std::size_t i = 0; i < r.retired_events.size(); ++i)
+            {
+                write(r.retired_events[i], r.retired_tids[i]);
+            }
+            r.retired_events.clear();
+            r.retired_tids.clear();
+            out << "\n]}\n";
+            return bool(out);
+        }
+    }
+}
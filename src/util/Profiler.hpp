@@ -0,0 +1,111 @@
+#ifndef ChessPlusPlus_Util_ScopedProfilerClass_HeaderPlusPlus
+#define ChessPlusPlus_Util_ScopedProfilerClass_HeaderPlusPlus
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+//Times the rest of the enclosing scope under a name, which must be a string literal
+//Counts under a name, e.g. draw calls
+//Both are compiled out unless CHESSPP_PROFILE is defined, which CMake does outside of Release builds
+#define CHESSPP_PROFILE_CONCAT_(a, b) a##b
+#define CHESSPP_PROFILE_CONCAT(a, b) CHESSPP_PROFILE_CONCAT_(a, b)
+#ifdef CHESSPP_PROFILE
+    #define CHESSPP_PROFILE_SCOPE(name) \
+        static ::chesspp::util::Profiler::Site const CHESSPP_PROFILE_CONCAT(chesspp_profile_site_, __LINE__) {name}; \
+        ::chesspp::util::Profiler::Scope const CHESSPP_PROFILE_CONCAT(chesspp_profile_scope_, __LINE__) {CHESSPP_PROFILE_CONCAT(chesspp_profile_site_, __LINE__)}
+    #define CHESSPP_PROFILE_COUNT(name, n) do \
+        { \
+            static ::chesspp::util::Profiler::Site const chesspp_profile_site {name}; \
+            ::chesspp::util::Profiler::count(chesspp_profile_site, n); \
+        } while(false)
+#else
+    #define CHESSPP_PROFILE_SCOPE(name) ((void)0)
+    #define CHESSPP_PROFILE_COUNT(name, n) ((void)0)
+#endif
+
+namespace chesspp
+{
+    namespace util
+    {
+        /**
+         * Collects how often and for how long named places in the code
+         * run, on every thread, without taking locks on the way. Totals
+         * are read once per frame with frame(), and while a trace is
+         * being recorded every timed scope is also kept as an event,
+         * to be written in the Chrome trace-event format.
+         */
+        class Profiler
+        {
+        public:
+            using Clock_t = std::chrono::steady_clock;
+            static constexpr std::size_t MaxSites = 64;
+            static constexpr std::size_t MaxEvents = 1 << 20; //per trace
+
+            //A named place in the code, registered once
+            class Site
+            {
+            public:
+                char const *const name;
+                std::size_t const id;
+
+                Site(char const *name) noexcept;
+            };
+
+            class Scope
+            {
+                Site const &site;
+                Clock_t::time_point start;
+
+            public:
+                Scope(Site const &s) noexcept
+                : site(s) //can't use {}
+                , start{Clock_t::now()}
+                {
+                }
+                Scope(Scope const &) = delete;
+                Scope &operator=(Scope const &) = delete;
+                ~Scope()
+                {
+                    Profiler::time(site, start, Clock_t::now());
+                }
+            };
+
+            //What a site did since the previous frame
+            class Sample
+            {
+            public:
+                char const *name;
+                std::uint64_t count;
+                double milliseconds; //zero for counters
+            };
+            using Frame_t = std::vector<Sample>;
+
+            static void time(Site const &site, Clock_t::time_point start, Clock_t::time_point end) noexcept;
+            static void count(Site const &site, std::uint64_t n) noexcept;
+
+            //Ends a frame, returning the sites that ran during it
+            static Frame_t frame();
+            //Whether CHESSPP_PROFILE_SCOPE and CHESSPP_PROFILE_COUNT were compiled in
+            static constexpr bool enabled() noexcept
+            {
+#ifdef CHESSPP_PROFILE
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            static void startTrace();
+            static bool tracing() noexcept;
+            //Stops recording and writes the events as Chrome trace-event JSON, returns false if it can't
+            static bool stopTrace(std::string const &path);
+        };
+    }
+}
+
+#endif
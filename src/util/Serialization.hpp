@@ -0,0 +1,112 @@
+#ifndef ChessPlusPlus_Util_ByteSerializationClasses_HeaderPlusPlus
+#define ChessPlusPlus_Util_ByteSerializationClasses_HeaderPlusPlus
+
+#include <string>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace chesspp
+{
+    namespace util
+    {
+        /**
+         * Appends scalars and length-prefixed strings to a byte
+         * string. Values are written in the byte order of the machine,
+         * so this is only meant for caches that are read back by the
+         * machine that wrote them.
+         */
+        class ByteWriter
+        {
+            std::string &out;
+
+        public:
+            ByteWriter(std::string &out_) noexcept
+            : out(out_) //can't use {}
+            {
+            }
+
+            template<typename T>
+            void value(T const &v)
+            {
+                static_assert(std::is_scalar<T>::value, "Only scalars can be written");
+                out.append(reinterpret_cast<char const *>(&v), sizeof(v));
+            }
+            void string(char const *s, std::size_t length)
+            {
+                value(std::uint32_t(length));
+                out.append(s, length);
+            }
+            void string(std::string const &s)
+            {
+                string(s.data(), s.size());
+            }
+        };
+
+        /**
+         * Reads back what a ByteWriter wrote. Reading past the end
+         * fails the reader instead of reading out of bounds, and
+         * every value read after that is zero or empty.
+         */
+        class ByteReader
+        {
+            char const *at, *end;
+            bool failed = false;
+
+        public:
+            ByteReader(void const *data, std::size_t size) noexcept
+            : at {static_cast<char const *>(data)}
+            , end{at + size}
+            {
+            }
+
+            template<typename T>
+            T value() noexcept
+            {
+                static_assert(std::is_scalar<T>::value, "Only scalars can be read");
+                T v {};
+                char const *s = take(sizeof(v));
+                if(s) std::memcpy(&v, s, sizeof(v));
+                return v;
+            }
+            //The bytes of a string, which stay where they are; nullptr on failure
+            char const *string(std::size_t &length) noexcept
+            {
+                length = value<std::uint32_t>();
+                char const *s = take(length);
+                if(!s) length = 0;
+                return s;
+            }
+            std::string string()
+            {
+                std::size_t length;
+                char const *s = string(length);
+                return s? std::string(s, length) : std::string();
+            }
+            //The next n bytes, or nullptr if there are fewer left
+            char const *take(std::size_t n) noexcept
+            {
+                if(failed || std::size_t(end - at) < n)
+                {
+                    failed = true;
+                    return nullptr;
+                }
+                char const *s = at;
+                at += n;
+                return s;
+            }
+
+            bool ok() const noexcept
+            {
+                return !failed;
+            }
+            std::size_t remaining() const noexcept
+            {
+                return failed? 0 : std::size_t(end - at);
+            }
+        };
+    }
+}
+
+#endif
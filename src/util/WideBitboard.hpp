@@ -0,0 +1,361 @@
+#ifndef ChessPlusPlus_Util_WideBitboardClass_HeaderPlusPlus
+#define ChessPlusPlus_Util_WideBitboardClass_HeaderPlusPlus
+
+#include "Position.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define CHESSPP_WIDE_SSE2 1
+#endif
+
+namespace chesspp
+{
+    namespace util
+    {
+        /**
+         * A set of tiles on a board of up to 32x32 tiles.
+         * Each row is stored as one 32-bit word, so that
+         * shifting by columns is a bit shift within each word
+         * and shifting by rows moves whole words. Bitwise
+         * operations and column shifts use AVX2 or SSE2
+         * kernels when available.
+         */
+        class WideBitboard
+        {
+        public:
+            using Row_t = std::uint32_t;
+            static constexpr std::size_t MaxWidth = 32;
+            static constexpr std::size_t MaxHeight = 32;
+
+        private:
+            Row_t rows[MaxHeight];
+
+            template<typename Op>
+            WideBitboard &apply(WideBitboard const &other, Op op) noexcept
+            {
+                for(std::size_t i = 0; i < MaxHeight; ++i)
+                {
+                    rows[i] = op(rows[i], other.rows[i]);
+                }
+                return *this;
+            }
+
+            //Shifts every row by n columns, east if n is positive
+            void shiftColumns(signed n) noexcept
+            {
+                if(n == 0) return;
+                if(n >= signed(MaxWidth) || -n >= signed(MaxWidth))
+                {
+                    *this = WideBitboard();
+                    return;
+                }
+            #if defined(__AVX2__)
+                __m128i count = _mm_cvtsi32_si128(n > 0? n : -n);
+                for(std::size_t i = 0; i < MaxHeight; i += 8)
+                {
+                    __m256i *p = reinterpret_cast<__m256i *>(rows + i);
+                    __m256i r = _mm256_loadu_si256(p);
+                    _mm256_storeu_si256(p, n > 0? _mm256_sll_epi32(r, count) : _mm256_srl_epi32(r, count));
+                }
+            #elif defined(CHESSPP_WIDE_SSE2)
+                __m128i count = _mm_cvtsi32_si128(n > 0? n : -n);
+                for(std::size_t i = 0; i < MaxHeight; i += 4)
+                {
+                    __m128i *p = reinterpret_cast<__m128i *>(rows + i);
+                    __m128i r = _mm_loadu_si128(p);
+                    _mm_storeu_si128(p, n > 0? _mm_sll_epi32(r, count) : _mm_srl_epi32(r, count));
+                }
+            #else
+                for(auto &r : rows)
+                {
+                    r = n > 0? Row_t(r << n) : Row_t(r >> -n);
+                }
+            #endif
+            }
+
+            //Moves every row by n rows, south if n is positive
+            void shiftRows(signed n) noexcept
+            {
+                if(n > 0)
+                {
+                    for(std::size_t i = MaxHeight; i-- > 0; )
+                    {
+                        rows[i] = (i >= std::size_t(n))? rows[i - n] : 0;
+                    }
+                }
+                else if(n < 0)
+                {
+                    for(std::size_t i = 0; i < MaxHeight; ++i)
+                    {
+                        rows[i] = (i + std::size_t(-n) < MaxHeight)? rows[i + std::size_t(-n)] : 0;
+                    }
+                }
+            }
+
+        public:
+            /**
+             * Constructs an empty set.
+             */
+            WideBitboard() noexcept
+            : rows{}
+            {
+            }
+
+            /**
+             * Returns the set of every tile on a board of the
+             * given size.
+             * \param width the number of columns, at most MaxWidth.
+             * \param height the number of rows, at most MaxHeight.
+             * \return the set of all tiles on the board.
+             */
+            static WideBitboard board(std::size_t width, std::size_t height) noexcept
+            {
+                WideBitboard b;
+                Row_t row = (width >= MaxWidth)? ~Row_t(0) : ((Row_t(1) << width) - 1);
+                for(std::size_t i = 0; i < height && i < MaxHeight; ++i)
+                {
+                    b.rows[i] = row;
+                }
+                return b;
+            }
+
+            template<typename T>
+            static WideBitboard tile(Position<T> const &p) noexcept
+            {
+                WideBitboard b;
+                b.set(p);
+                return b;
+            }
+
+            /**
+             * Returns the offsets to move one tile in a direction,
+             * positive x is east and positive y is south.
+             * \param d the direction.
+             * \return the offsets, or (0, 0) for Direction::None.
+             */
+            static Position<signed> delta(Direction d) noexcept
+            {
+                return Position<signed>(DeltaX(d), DeltaY(d));
+            }
+
+            template<typename T>
+            bool test(Position<T> const &p) const noexcept
+            {
+                return std::size_t(p.x) < MaxWidth && std::size_t(p.y) < MaxHeight
+                    && ((rows[p.y] >> p.x) & 1u);
+            }
+            template<typename T>
+            void set(Position<T> const &p) noexcept
+            {
+                if(std::size_t(p.x) < MaxWidth && std::size_t(p.y) < MaxHeight)
+                {
+                    rows[p.y] |= Row_t(1) << p.x;
+                }
+            }
+            template<typename T>
+            void reset(Position<T> const &p) noexcept
+            {
+                if(std::size_t(p.x) < MaxWidth && std::size_t(p.y) < MaxHeight)
+                {
+                    rows[p.y] &= ~(Row_t(1) << p.x);
+                }
+            }
+
+            bool any() const noexcept
+            {
+                Row_t r = 0;
+                for(auto row : rows)
+                {
+                    r |= row;
+                }
+                return r != 0;
+            }
+            explicit operator bool() const noexcept
+            {
+                return any();
+            }
+
+            WideBitboard &operator&=(WideBitboard const &other) noexcept
+            {
+            #if defined(__AVX2__)
+                for(std::size_t i = 0; i < MaxHeight; i += 8)
+                {
+                    __m256i *p = reinterpret_cast<__m256i *>(rows + i);
+                    _mm256_storeu_si256(p, _mm256_and_si256(_mm256_loadu_si256(p), _mm256_loadu_si256(reinterpret_cast<__m256i const *>(other.rows + i))));
+                }
+                return *this;
+            #elif defined(CHESSPP_WIDE_SSE2)
+                for(std::size_t i = 0; i < MaxHeight; i += 4)
+                {
+                    __m128i *p = reinterpret_cast<__m128i *>(rows + i);
+                    _mm_storeu_si128(p, _mm_and_si128(_mm_loadu_si128(p), _mm_loadu_si128(reinterpret_cast<__m128i const *>(other.rows + i))));
+                }
+                return *this;
+            #else
+                return apply(other, [](Row_t a, Row_t b){ return a & b; });
+            #endif
+            }
+            WideBitboard &operator|=(WideBitboard const &other) noexcept
+            {
+            #if defined(__AVX2__)
+                for(std::size_t i = 0; i < MaxHeight; i += 8)
+                {
+                    __m256i *p = reinterpret_cast<__m256i *>(rows + i);
+                    _mm256_storeu_si256(p, _mm256_or_si256(_mm256_loadu_si256(p), _mm256_loadu_si256(reinterpret_cast<__m256i const *>(other.rows + i))));
+                }
+                return *this;
+            #elif defined(CHESSPP_WIDE_SSE2)
+                for(std::size_t i = 0; i < MaxHeight; i += 4)
+                {
+                    __m128i *p = reinterpret_cast<__m128i *>(rows + i);
+                    _mm_storeu_si128(p, _mm_or_si128(_mm_loadu_si128(p), _mm_loadu_si128(reinterpret_cast<__m128i const *>(other.rows + i))));
+                }
+                return *this;
+            #else
+                return apply(other, [](Row_t a, Row_t b){ return a | b; });
+            #endif
+            }
+            WideBitboard &operator^=(WideBitboard const &other) noexcept
+            {
+                return apply(other, [](Row_t a, Row_t b){ return a ^ b; });
+            }
+            /**
+             * Removes every tile in other from this set.
+             * \param other the tiles to remove.
+             * \return *this
+             */
+            WideBitboard &remove(WideBitboard const &other) noexcept
+            {
+            #if defined(__AVX2__)
+                for(std::size_t i = 0; i < MaxHeight; i += 8)
+                {
+                    __m256i *p = reinterpret_cast<__m256i *>(rows + i);
+                    _mm256_storeu_si256(p, _mm256_andnot_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(other.rows + i)), _mm256_loadu_si256(p)));
+                }
+                return *this;
+            #elif defined(CHESSPP_WIDE_SSE2)
+                for(std::size_t i = 0; i < MaxHeight; i += 4)
+                {
+                    __m128i *p = reinterpret_cast<__m128i *>(rows + i);
+                    _mm_storeu_si128(p, _mm_andnot_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(other.rows + i)), _mm_loadu_si128(p)));
+                }
+                return *this;
+            #else
+                return apply(other, [](Row_t a, Row_t b){ return a & ~b; });
+            #endif
+            }
+
+            friend WideBitboard operator&(WideBitboard a, WideBitboard const &b) noexcept
+            {
+                return a &= b;
+            }
+            friend WideBitboard operator|(WideBitboard a, WideBitboard const &b) noexcept
+            {
+                return a |= b;
+            }
+            friend WideBitboard operator^(WideBitboard a, WideBitboard const &b) noexcept
+            {
+                return a ^= b;
+            }
+            friend bool operator==(WideBitboard const &a, WideBitboard const &b) noexcept
+            {
+                for(std::size_t i = 0; i < MaxHeight; ++i)
+                {
+                    if(a.rows[i] != b.rows[i]) return false;
+                }
+                return true;
+            }
+            friend bool operator!=(WideBitboard const &a, WideBitboard const &b) noexcept
+            {
+                return !(a == b);
+            }
+
+            /**
+             * Returns this set moved by the given offsets.
+             * Tiles moved outside of the MaxWidth by MaxHeight
+             * area are dropped, callers should mask the result
+             * with the board if it is smaller.
+             * \param dx columns to move, positive is east.
+             * \param dy rows to move, positive is south.
+             * \return the moved set.
+             */
+            WideBitboard shifted(signed dx, signed dy) const noexcept
+            {
+                WideBitboard b = *this;
+                b.shiftRows(dy);
+                b.shiftColumns(dx);
+                return b;
+            }
+            WideBitboard shifted(Direction d, signed times = 1) const noexcept
+            {
+                Position<signed> o = delta(d);
+                return shifted(o.x*times, o.y*times);
+            }
+
+            /**
+             * Kogge-Stone occluded fill: extends every tile in
+             * this set in direction d for as long as the tiles
+             * passed through are in empty.
+             * \param d the direction to fill in.
+             * \param empty the tiles that may be filled.
+             * \return this set plus the filled tiles.
+             */
+            WideBitboard fill(Direction d, WideBitboard empty) const noexcept
+            {
+                WideBitboard gen = *this;
+                for(signed n = 1; n < signed(MaxWidth); n *= 2)
+                {
+                    gen |= empty & gen.shifted(d, n);
+                    empty &= empty.shifted(d, n);
+                }
+                return gen;
+            }
+            /**
+             * Returns the tiles a slider in this set attacks in
+             * direction d, up to and including the first tile
+             * that is not empty.
+             * \param d the direction of the ray.
+             * \param empty the unoccupied tiles of the board.
+             * \param board all tiles of the board.
+             * \return the attacked tiles.
+             */
+            WideBitboard ray(Direction d, WideBitboard const &empty, WideBitboard const &board) const noexcept
+            {
+                return fill(d, empty).shifted(d) & board;
+            }
+
+            /**
+             * Calls f with the position of every tile in this set.
+             * \tparam T the coordinate type of the positions.
+             * \param f callable taking Position<T> const &.
+             */
+            template<typename T, typename F>
+            void forEach(F f) const
+            {
+                for(std::size_t y = 0; y < MaxHeight; ++y)
+                {
+                    for(Row_t r = rows[y]; r; r &= r - 1)
+                    {
+                    #if defined(_MSC_VER)
+                        unsigned long x;
+                        _BitScanForward(&x, r);
+                    #else
+                        unsigned x = __builtin_ctz(r);
+                    #endif
+                        f(Position<T>(T(x), T(y)));
+                    }
+                }
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,267 @@
+#include "config/BoardConfig.hpp"
+#include "board/Board.hpp"
+#include "engine/MoveGenerator.hpp"
+#include "util/JsonReader.hpp"
+#include "util/Position.hpp"
+#include "util/Allocations.hpp"
+#ifdef CHESSPP_BENCH_GRAPHICS
+#include "config/ResourcesConfig.hpp"
+#include "gfx/Graphics.hpp"
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <set>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Micro-benchmarks of the board, the pieces and drawing, run with the
+ * options of Google Benchmark. Unless --benchmark_out is given the
+ * results also go to chesspp_bench.json in its JSON format, so runs of
+ * different releases can be compared with its compare.py. Built with
+ * CHESSPP_TRACK_ALLOCATIONS, each benchmark also reports its allocations
+ * per iteration, and those of the board fail if they allocate at all
+ * once warmed up.
+ */
+namespace
+{
+    using namespace chesspp;
+    using engine::Board;
+    using Position_t = Board::Position_t;
+
+    static char const BoardPath[] = "config/chesspp/board.json";
+
+    static config::BoardConfig const &boardConfig()
+    {
+        static config::BoardConfig const c {BoardPath};
+        return c;
+    }
+
+    //Reports the allocations since scope per iteration, failing if any were made and steady is set
+    static void allocations(benchmark::State &state, util::Allocations::Scope const &scope, bool steady)
+    {
+        if(!util::Allocations::enabled()) return;
+        auto const count = scope.count(), bytes = scope.bytes(); //before the counters allocate
+        state.counters["allocations"] = benchmark::Counter(double(count), benchmark::Counter::kAvgIterations);
+        state.counters["allocated_bytes"] = benchmark::Counter(double(bytes), benchmark::Counter::kAvgIterations);
+        if(steady && count != 0)
+        {
+            state.SkipWithError("allocated after warming up");
+        }
+    }
+
+    static void BoardConstruction(benchmark::State &state)
+    {
+        auto const &config = boardConfig();
+        util::Allocations::Scope scope;
+        for(auto _ : state)
+        {
+            Board b {config};
+            benchmark::DoNotOptimize(&b);
+        }
+        allocations(state, scope, false);
+    }
+
+    //Makes and unmakes every move of the initial position, which runs Board::update() both ways
+    static void BoardUpdate(benchmark::State &state)
+    {
+        auto const &config = boardConfig();
+        Board b {config};
+        std::size_t first = 0;
+        auto players = engine::players(config, first);
+        engine::MoveGenerator generate;
+        engine::Moves_t moves;
+        generate(b, players[first], moves);
+        for(auto const &m : moves)
+        {
+            engine::MoveGenerator::make(b, m);
+            b.unmakeMove();
+        }
+        std::size_t i = 0;
+        util::Allocations::Scope scope;
+        for(auto _ : state)
+        {
+            engine::MoveGenerator::make(b, moves[i]);
+            b.unmakeMove();
+            i = (i + 1)%moves.size();
+        }
+        allocations(state, scope, true);
+        state.SetItemsProcessed(std::int64_t(state.iterations())*2);
+    }
+
+    //The moves of one piece alone in the middle of the board, worked out by a full
+    //rebuild on both the move and its undo, so the piece's trajectory dominates
+    static void Trajectory(benchmark::State &state, config::BoardConfig::PieceClass_t pclass)
+    {
+        auto const &config = boardConfig();
+        Position_t const middle {Position_t::value_type(config.boardWidth()/2), Position_t::value_type(config.boardHeight()/2)};
+        config::BoardConfig::Layout_t layout;
+        layout[middle] = std::make_pair(pclass, *config.suits().begin());
+        Board b {config, layout};
+        b.incrementalUpdates(false);
+        auto piece = b.pieceAt(middle);
+        if(b.pieceTrajectory(**piece).begin() == b.pieceTrajectory(**piece).end())
+        {
+            state.SkipWithError("the piece can't move from the middle of the board");
+            return;
+        }
+        b.makeMove(piece, b.pieceTrajectory(**piece).begin());
+        b.unmakeMove();
+        piece = b.pieceAt(middle);
+        util::Allocations::Scope scope;
+        for(auto _ : state)
+        {
+            b.makeMove(piece, b.pieceTrajectory(**piece).begin());
+            b.unmakeMove();
+            piece = b.pieceAt(middle);
+        }
+        allocations(state, scope, true);
+        state.SetItemsProcessed(std::int64_t(state.iterations())*2);
+    }
+
+    static void Occupied(benchmark::State &state)
+    {
+        auto const &config = boardConfig();
+        Board b {config};
+        std::size_t tiles = 0;
+        util::Allocations::Scope scope;
+        for(auto _ : state)
+        {
+            for(Position_t::value_type y = 0; y < config.boardHeight(); ++y)
+            {
+                for(Position_t::value_type x = 0; x < config.boardWidth(); ++x)
+                {
+                    benchmark::DoNotOptimize(b.occupied(Position_t{x, y}));
+                }
+            }
+            tiles += config.boardWidth()*config.boardHeight();
+        }
+        allocations(state, scope, true);
+        state.SetItemsProcessed(std::int64_t(tiles));
+    }
+
+    //Steps a position around in every direction, rotated a little both ways
+    static void MoveAndRotate(benchmark::State &state)
+    {
+        using util::Direction;
+        static Direction const Compass[] = {Direction::North, Direction::NorthEast, Direction::East, Direction::SouthEast,
+                                            Direction::South, Direction::SouthWest, Direction::West, Direction::NorthWest};
+        Position_t p {4, 4};
+        util::Allocations::Scope scope;
+        for(auto _ : state)
+        {
+            for(auto d : Compass)
+            {
+                for(signed r = -2; r <= 2; ++r)
+                {
+                    benchmark::DoNotOptimize(d); //so the rotations aren't folded away
+                    p.move(util::Rotate(d, r));
+                    benchmark::DoNotOptimize(p);
+                }
+            }
+        }
+        allocations(state, scope, true);
+        state.SetItemsProcessed(std::int64_t(state.iterations())*8*5);
+    }
+
+    static void JsonParsing(benchmark::State &state)
+    {
+        std::ifstream in {BoardPath, std::ios::binary};
+        std::string const text ((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if(text.empty())
+        {
+            state.SkipWithError("could not read board.json");
+            return;
+        }
+        util::Allocations::Scope scope;
+        for(auto _ : state)
+        {
+            util::JsonReader reader {text.data(), text.size()};
+            benchmark::DoNotOptimize(&reader);
+        }
+        allocations(state, scope, false);
+        state.SetBytesProcessed(std::int64_t(state.iterations())*std::int64_t(text.size()));
+    }
+
+#ifdef CHESSPP_BENCH_GRAPHICS
+    //Queues the initial position and draws it into a texture, needs an OpenGL context
+    static void DrawBoard(benchmark::State &state)
+    {
+        config::ResourcesConfig res_config;
+        config::BoardConfig board_config {res_config};
+        sf::RenderTexture target;
+        if(!target.create(unsigned(board_config.boardWidth()*board_config.cellWidth()), unsigned(board_config.boardHeight()*board_config.cellHeight())))
+        {
+            state.SkipWithError("could not create a render texture");
+            return;
+        }
+        gfx::GraphicsHandler graphics {target, res_config, board_config};
+        Board b {board_config};
+        graphics.drawBoard(b);
+        graphics.flush();
+        util::Allocations::Scope scope;
+        for(auto _ : state)
+        {
+            graphics.drawBoard(b);
+            graphics.flush();
+            target.display();
+        }
+        allocations(state, scope, false); //SFML and the driver may allocate for themselves
+    }
+#endif
+}
+
+BENCHMARK(BoardConstruction);
+BENCHMARK(BoardUpdate);
+BENCHMARK(Occupied);
+BENCHMARK(MoveAndRotate);
+BENCHMARK(JsonParsing);
+#ifdef CHESSPP_BENCH_GRAPHICS
+BENCHMARK(DrawBoard);
+#endif
+
+int main(int argc, char **argv)
+{
+    std::clog.rdbuf(nullptr); //creating pieces is logged, which would drown out the results
+
+    //one benchmark for each class in the initial layout
+    std::set<config::BoardConfig::PieceClass_t> classes;
+    for(auto const &slot : boardConfig().initialLayout())
+    {
+        classes.insert(slot.second.first);
+    }
+    for(auto const &pclass : classes)
+    {
+        benchmark::RegisterBenchmark(("Trajectory/" + pclass.name()).c_str(), Trajectory, pclass);
+    }
+
+    std::string out = "--benchmark_out=chesspp_bench.json", format = "--benchmark_out_format=json";
+    std::vector<char *> args (argv, argv + argc); //don't use {}
+    bool given = false;
+    for(int i = 1; i < argc; ++i)
+    {
+        given = given || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    if(!given)
+    {
+        args.push_back(&out[0]);
+        args.push_back(&format[0]);
+    }
+    args.push_back(nullptr);
+    int n = int(args.size()) - 1;
+    benchmark::Initialize(&n, args.data());
+    if(benchmark::ReportUnrecognizedArguments(n, args.data()))
+    {
+        return 1;
+    }
+    benchmark::AddCustomContext("board", BoardPath);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+}
@@ -0,0 +1,191 @@
+#include "config/BoardConfig.hpp"
+#include "board/Board.hpp"
+#include "engine/MoveGenerator.hpp"
+#include "engine/Notation.hpp"
+#include "engine/Pgn.hpp"
+#include "engine/Book.hpp"
+#include "Exception.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <typeinfo>
+#include <cstddef>
+
+namespace
+{
+    using namespace chesspp;
+    using engine::Board;
+    using engine::Players_t;
+    using engine::Book;
+
+    //A game as it was read, either algebraic moves or from/to tiles
+    class Game
+    {
+    public:
+        std::vector<std::string> san;
+        std::vector<std::pair<Board::Position_t, Board::Position_t>> tiles;
+
+        bool empty() const noexcept
+        {
+            return san.empty() && tiles.empty();
+        }
+    };
+    using Games_t = std::vector<Game>;
+
+    //PGN: games set up from a FEN are skipped, as they don't start from the opening
+    static void readPgn(std::string const &text, Games_t &games)
+    {
+        engine::Pgn::read(text.data(), text.data() + text.size(), [&](engine::Pgn::Game const &pgn)
+        {
+            if(!pgn.fen.empty()) return;
+            Game game;
+            game.san = pgn.san;
+            games.push_back(game);
+        });
+    }
+
+    //The engine's and the GUI's logs: "Moved piece at (x, y) to (x, y)"
+    static void readLog(std::istream &in, Games_t &games)
+    {
+        Game game;
+        std::string line;
+        while(std::getline(in, line))
+        {
+            if(line.compare(0, 11, "Creation of") == 0 && !game.tiles.empty())
+            {
+                games.push_back(game);
+                game = Game{};
+            }
+            auto at = line.find("Moved piece at ");
+            if(at == std::string::npos) continue;
+            std::istringstream s {line.substr(at + 15)};
+            int fx, fy, tx, ty;
+            char ch;
+            std::string to;
+            if(s >> ch >> fx >> ch >> fy >> ch >> to >> ch >> tx >> ch >> ty >> ch && to == "to")
+            {
+                using Size_t = Board::Position_t::value_type;
+                game.tiles.emplace_back(Board::Position_t(Size_t(fx), Size_t(fy)), Board::Position_t(Size_t(tx), Size_t(ty)));
+            }
+        }
+        if(!game.empty()) games.push_back(game);
+    }
+}
+
+int main(int argc, char const *const *argv)
+{
+    std::size_t plies = 20;
+    std::string path = "config/chesspp/board.json";
+    std::vector<std::string> args (argv + 1, argv + argc); //don't use {}
+    while(args.size() >= 2 && (args[0] == "--plies" || args[0] == "--board"))
+    {
+        if(args[0] == "--board")
+        {
+            path = args[1];
+        }
+        else if(!(std::istringstream{args[1]} >> plies))
+        {
+            std::cerr << "--plies needs a number" << std::endl;
+            return 1;
+        }
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if(args.size() < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " [--plies N] [--board board.json] book.bin games.pgn|moves.log..." << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        Games_t games;
+        for(auto it = args.begin() + 1; it != args.end(); ++it)
+        {
+            std::ifstream in {*it};
+            if(!in)
+            {
+                std::cerr << "could not open " << *it << std::endl;
+                return 1;
+            }
+            std::stringstream text;
+            text << in.rdbuf();
+            if(text.str().find("Moved piece at ") != std::string::npos)
+            {
+                readLog(text, games);
+            }
+            else
+            {
+                readPgn(text.str(), games);
+            }
+        }
+
+        std::clog.rdbuf(nullptr); //creating pieces is logged for every game
+        config::BoardConfig board_config {path};
+        std::size_t first = 0;
+        Players_t players = engine::players(board_config, first);
+
+        engine::MoveGenerator generate;
+        engine::Notation notation;
+        engine::Moves_t moves;
+        Book::Entries_t entries;
+        std::size_t stopped = 0;
+        for(auto const &game : games)
+        {
+            Board board {board_config};
+            std::size_t turn = first;
+            std::size_t length = std::max(game.san.size(), game.tiles.size());
+            for(std::size_t ply = 0; ply < length && ply < plies; ++ply)
+            {
+                engine::Move move;
+                bool found = false;
+                if(!game.san.empty())
+                {
+                    found = notation.parse(board, players[turn], game.san[ply], move);
+                }
+                else
+                {
+                    generate(board, players[turn], moves);
+                    for(auto const &m : moves)
+                    {
+                        if(m.from == game.tiles[ply].first && m.to == game.tiles[ply].second)
+                        {
+                            move = m;
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+                auto key = board.hash(players[turn]);
+                if(!found || !engine::MoveGenerator::make(board, move))
+                {
+                    ++stopped;
+                    break;
+                }
+                entries.push_back(Book::Entry{key, move.code(), 1, 0});
+                turn = (turn + 1)%players.size();
+            }
+        }
+
+        if(!Book::write(args[0], entries))
+        {
+            std::cerr << "could not write " << args[0] << std::endl;
+            return 1;
+        }
+        Book book {args[0]};
+        std::cout << games.size() << " games, " << entries.size() << " moves, " << book.size() << " book entries";
+        if(stopped > 0)
+        {
+            std::cout << " (" << stopped << " games stopped early at a move that is not legal here)";
+        }
+        std::cout << std::endl;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << typeid(e).name() << " caught in main: " << e.what() << std::endl;
+        return -1;
+    }
+}
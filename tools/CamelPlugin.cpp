@@ -0,0 +1,42 @@
+#include "piece/PluginAbi.hpp"
+
+/*
+ * An example piece plugin, adding the Camel of fairy chess, which leaps
+ * 3 tiles one way and 1 the other, and the Wazir, which steps 1 tile in
+ * a straight line, listed in board.json as
+ *
+ *     "piece plugins": ["chesspp_camel.so"]
+ *
+ * Both are described entirely by their leaps, so they are generated with
+ * the same bitboard lookups as a Knight or King.
+ */
+namespace
+{
+    static chesspp_piece_offset const CamelLeaps[] =
+    {
+        { 1, -3}, { 3, -1}, { 3,  1}, { 1,  3},
+        {-1,  3}, {-3,  1}, {-3, -1}, {-1, -3}
+    };
+    static chesspp_piece_offset const WazirLeaps[] =
+    {
+        { 0, -1}, { 1,  0}, { 0,  1}, {-1,  0}
+    };
+
+    static chesspp_piece_class Classes[2];
+}
+
+extern "C" CHESSPP_PIECE_PLUGIN_EXPORT chesspp_piece_class const *chesspp_piece_classes(uint32_t abi, uint32_t *count)
+{
+    if(abi != CHESSPP_PIECE_PLUGIN_ABI)
+    {
+        return nullptr;
+    }
+    Classes[0].name = "Camel";
+    Classes[0].move_leap_count = Classes[0].capture_leap_count = 8;
+    Classes[0].move_leaps = Classes[0].capture_leaps = CamelLeaps;
+    Classes[1].name = "Wazir";
+    Classes[1].move_leap_count = Classes[1].capture_leap_count = 4;
+    Classes[1].move_leaps = Classes[1].capture_leaps = WazirLeaps;
+    *count = 2;
+    return Classes;
+}
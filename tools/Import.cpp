@@ -0,0 +1,291 @@
+#include "config/BoardConfig.hpp"
+#include "board/Board.hpp"
+#include "engine/MoveGenerator.hpp"
+#include "engine/Notation.hpp"
+#include "engine/Pgn.hpp"
+#include "engine/Fen.hpp"
+#include "engine/PackedPosition.hpp"
+#include "util/MappedFile.hpp"
+#include "Exception.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_set>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <typeinfo>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Imports the positions of PGN archives into a file of distinct positions:
+ * a 16 byte header, the magic "CPPPOSN1", the board width and height and
+ * the number of positions, all little-endian, then the positions packed by
+ * engine::PackedPosition one after another, in the order the games first
+ * reach them. Positions are told apart by Board::hash(turn).
+ */
+namespace
+{
+    using namespace chesspp;
+    using engine::Board;
+    using engine::Players_t;
+    using Key_t = board::Zobrist::Key_t;
+
+    static char const Magic[8] = {'C', 'P', 'P', 'P', 'O', 'S', 'N', '1'};
+    class Header
+    {
+    public:
+        char magic[8];
+        std::uint16_t width, height;
+        std::uint32_t count;
+    };
+    static_assert(sizeof(Header) == 16, "position file headers are stored as they are in memory");
+
+    static std::size_t const MinChunk = 1 << 20; //bytes of PGN, so small files aren't split needlessly
+
+    //A part of an input that starts at a game, and the positions its games reached
+    class Chunk
+    {
+    public:
+        char const *first, *last;
+        std::string packed;
+        std::vector<std::pair<Key_t, std::size_t>> entries; //key and offset in packed of each distinct position
+        std::size_t games = 0, positions = 0, stopped = 0, skipped = 0;
+
+        Chunk(char const *first_, char const *last_) noexcept
+        : first{first_}
+        , last{last_}
+        {
+        }
+    };
+
+    class Importer
+    {
+        config::BoardConfig const &config;
+        Players_t const &players;
+        std::size_t first;
+        engine::PackedPosition const &packer;
+        std::size_t plies;
+        engine::Notation notation;
+        std::set<Board::Position_t> const unmoved;
+
+    public:
+        Importer(config::BoardConfig const &config_, Players_t const &players_, std::size_t first_, engine::PackedPosition const &packer_, std::size_t plies_)
+        : config(config_) //can't use {}
+        , players(players_) //can't use {}
+        , first{first_}
+        , packer(packer_) //can't use {}
+        , plies{plies_}
+        {
+        }
+
+        void operator()(Chunk &chunk)
+        {
+            std::unordered_set<Key_t> seen;
+            engine::Pgn::read(chunk.first, chunk.last, [&](engine::Pgn::Game const &game)
+            {
+                ++chunk.games;
+                try
+                {
+                    std::unique_ptr<engine::Fen> fen;
+                    if(!game.fen.empty())
+                    {
+                        fen.reset(new engine::Fen{config, game.fen});
+                    }
+                    Board board {config, fen? fen->layout : config.initialLayout(), fen? fen->moved : unmoved};
+                    std::size_t turn = fen? fen->turn : first;
+                    auto reached = [&]
+                    {
+                        ++chunk.positions;
+                        Key_t key = board.hash(players[turn]);
+                        if(!seen.insert(key).second) return;
+                        std::size_t at = chunk.packed.size();
+                        packer.pack(board, turn, chunk.packed);
+                        chunk.entries.emplace_back(key, at);
+                    };
+                    reached();
+                    for(std::size_t ply = 0; ply < game.san.size() && ply < plies; ++ply)
+                    {
+                        engine::Move move;
+                        if(!notation.parse(board, players[turn], game.san[ply], move) || !engine::MoveGenerator::make(board, move))
+                        {
+                            ++chunk.stopped;
+                            break;
+                        }
+                        turn = (turn + 1)%players.size();
+                        reached();
+                    }
+                }
+                catch(std::exception &)
+                {
+                    ++chunk.skipped; //a FEN or piece that doesn't fit the board
+                }
+            });
+        }
+    };
+}
+
+int main(int argc, char const *const *argv)
+{
+    std::size_t plies = std::numeric_limits<std::size_t>::max();
+    std::size_t threads = 0;
+    std::string path = "config/chesspp/board.json";
+    std::vector<std::string> args (argv + 1, argv + argc); //don't use {}
+    while(args.size() >= 2 && (args[0] == "--plies" || args[0] == "--board" || args[0] == "--threads"))
+    {
+        if(args[0] == "--board")
+        {
+            path = args[1];
+        }
+        else if(!(std::istringstream{args[1]} >> (args[0] == "--plies"? plies : threads)))
+        {
+            std::cerr << args[0] << " needs a number" << std::endl;
+            return 1;
+        }
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if(args.size() < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " [--plies N] [--threads N] [--board board.json] positions.bin games.pgn..." << std::endl;
+        return 1;
+    }
+    if(threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    try
+    {
+        std::clog.rdbuf(nullptr); //creating pieces is logged for every game
+        config::BoardConfig board_config {path};
+        std::size_t first = 0;
+        Players_t players = engine::players(board_config, first);
+        if(players.empty())
+        {
+            std::cerr << "no suits in " << path << std::endl;
+            return 1;
+        }
+        engine::PackedPosition packer {board_config};
+        Board::loadPieceClasses(board_config); //before the workers construct boards
+
+        //split every input at games into a few chunks per thread
+        std::vector<util::MappedFile> files;
+        std::vector<Chunk> chunks;
+        for(auto it = args.begin() + 1; it != args.end(); ++it)
+        {
+            util::MappedFile file {*it};
+            if(!file.valid())
+            {
+                std::cerr << "could not map " << *it << std::endl;
+                return 1;
+            }
+            auto const *begin = static_cast<char const *>(file.data()), *end = begin + file.size();
+            std::size_t step = std::max(MinChunk, file.size()/(threads*8));
+            for(char const *at = begin; at != end; )
+            {
+                char const *next = std::size_t(end - at) > step? engine::Pgn::nextGame(at + step, begin, end) : end;
+                chunks.emplace_back(at, next);
+                at = next;
+            }
+            files.push_back(std::move(file));
+        }
+
+        //chunks are merged in order as they are done, so the output doesn't depend on the threads
+        std::ofstream out {args[0], std::ios::binary};
+        Header h;
+        std::memcpy(h.magic, Magic, sizeof(Magic));
+        h.width = board_config.boardWidth();
+        h.height = board_config.boardHeight();
+        h.count = 0;
+        out.write(reinterpret_cast<char const *>(&h), sizeof(h));
+
+        auto start = std::chrono::steady_clock::now();
+        std::atomic<std::size_t> next {0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::vector<bool> done (chunks.size(), false); //don't use {}
+        std::vector<std::thread> workers;
+        for(std::size_t t = 0; t < std::min(threads, chunks.size()); ++t)
+        {
+            workers.emplace_back([&]
+            {
+                Importer import {board_config, players, first, packer, plies};
+                for(std::size_t c; (c = next.fetch_add(1)) < chunks.size(); )
+                {
+                    import(chunks[c]);
+                    std::lock_guard<std::mutex> lock {mutex};
+                    done[c] = true;
+                    finished.notify_one();
+                }
+            });
+        }
+
+        std::unordered_set<Key_t> seen;
+        std::size_t games = 0, positions = 0, stopped = 0, skipped = 0;
+        for(std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            {
+                std::unique_lock<std::mutex> lock {mutex};
+                finished.wait(lock, [&]{ return bool(done[i]); });
+            }
+            auto &c = chunks[i];
+            for(std::size_t e = 0; e < c.entries.size(); ++e)
+            {
+                if(!seen.insert(c.entries[e].first).second) continue;
+                std::size_t end = e + 1 < c.entries.size()? c.entries[e + 1].second : c.packed.size();
+                out.write(c.packed.data() + c.entries[e].second, std::streamsize(end - c.entries[e].second));
+            }
+            games += c.games;
+            positions += c.positions;
+            stopped += c.stopped;
+            skipped += c.skipped;
+            std::string{}.swap(c.packed);
+            decltype(c.entries){}.swap(c.entries);
+        }
+        for(auto &w : workers)
+        {
+            w.join();
+        }
+        h.count = std::uint32_t(seen.size());
+        out.seekp(0);
+        out.write(reinterpret_cast<char const *>(&h), sizeof(h));
+        if(!out)
+        {
+            std::cerr << "could not write " << args[0] << std::endl;
+            return 1;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << games << " games, " << positions << " positions, " << seen.size() << " distinct, in "
+                  << elapsed.count() << "s on " << workers.size() << " threads";
+        if(elapsed.count() > 0)
+        {
+            std::cout << " (" << std::uint64_t(games/elapsed.count()) << " games/sec)";
+        }
+        std::cout << std::endl;
+        if(stopped > 0)
+        {
+            std::cout << stopped << " games stopped early at a move that is not legal here" << std::endl;
+        }
+        if(skipped > 0)
+        {
+            std::cout << skipped << " games skipped, set up from a FEN that doesn't fit the board" << std::endl;
+        }
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << typeid(e).name() << " caught in main: " << e.what() << std::endl;
+        return -1;
+    }
+}
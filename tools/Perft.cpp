@@ -0,0 +1,131 @@
+#include "config/BoardConfig.hpp"
+#include "board/Board.hpp"
+#include "engine/Perft.hpp"
+#include "engine/Batch.hpp"
+#include "util/Allocations.hpp"
+#include "Exception.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <typeinfo>
+#include <cstdint>
+#include <cstddef>
+
+namespace
+{
+    using namespace chesspp;
+    using engine::Board;
+    using engine::Players_t;
+    using Nodes_t = engine::Perft::Nodes_t;
+
+    static void rate(Nodes_t nodes, double seconds)
+    {
+        if(seconds > 0)
+        {
+            std::cout << " (" << Nodes_t(nodes/seconds) << " nodes/sec)";
+        }
+    }
+}
+
+int main(int argc, char const *const *argv)
+{
+    unsigned depth = 4;
+    std::size_t threads = 0; //zero for the serial perft only
+    std::string path = "config/chesspp/board.json";
+    std::vector<std::string> args (argv + 1, argv + argc); //don't use {}
+    if(args.size() >= 2 && args[0] == "--perft-parallel")
+    {
+        if(!(std::istringstream{args[1]} >> threads) || threads == 0)
+        {
+            std::cerr << "--perft-parallel needs a number of threads" << std::endl;
+            return 1;
+        }
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if((args.size() > 0 && !(std::istringstream{args[0]} >> depth)) || args.size() > 2)
+    {
+        std::cerr << "usage: " << argv[0] << " [--perft-parallel threads] [depth] [board.json]" << std::endl;
+        return 1;
+    }
+    if(args.size() > 1)
+    {
+        path = args[1];
+    }
+
+    try
+    {
+        std::clog.rdbuf(nullptr); //creating pieces is logged, which would drown out the results
+
+        config::BoardConfig board_config {path};
+        Board board {board_config};
+
+        std::size_t first = 0;
+        Players_t players = engine::players(board_config, first);
+        if(players.empty())
+        {
+            std::cerr << "no suits in " << path << std::endl;
+            return 1;
+        }
+
+        std::cout << "perft of " << path << " (" << int(board_config.boardWidth()) << "x" << int(board_config.boardHeight())
+                  << ", " << players[first] << " to move)" << std::endl;
+        for(unsigned d = 1; d <= depth; ++d)
+        {
+            engine::Perft perft {board, players};
+            auto start = std::chrono::steady_clock::now();
+            Nodes_t nodes = perft(first, d);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if(perft.failed)
+            {
+                std::cerr << "a generated move could not be made at depth " << d << std::endl;
+                return 1;
+            }
+            std::cout << "depth " << d << ": " << nodes << " nodes in " << elapsed.count() << "s";
+            rate(nodes, elapsed.count());
+            std::cout << std::endl;
+
+            if(threads == 0) continue;
+            engine::Batch batch {board, players, threads};
+            auto report = batch.perft(first, d);
+            if(report.failed || report.nodes != nodes)
+            {
+                std::cerr << "parallel perft counted " << report.nodes << " nodes at depth " << d << std::endl;
+                return 1;
+            }
+            double speedup = report.seconds > 0? elapsed.count()/report.seconds : 0;
+            std::cout << "  " << report.workers.size() << " threads: " << report.seconds << "s";
+            rate(report.nodes, report.seconds);
+            std::cout << ", speedup " << speedup << ", efficiency " << 100*speedup/report.workers.size() << "%" << std::endl;
+            for(std::size_t i = 0; i < report.workers.size(); ++i)
+            {
+                auto const &w = report.workers[i];
+                std::cout << "    thread " << i << ": " << w.roots << " root moves, " << w.nodes << " nodes in " << w.seconds << "s";
+                rate(w.nodes, w.seconds);
+                std::cout << std::endl;
+            }
+        }
+
+        if(util::Allocations::enabled() && depth > 0)
+        {
+            //once a perft has been to the depth every list it needs is big enough, so it shouldn't allocate again
+            engine::Perft perft {board, players};
+            perft(first, depth);
+            util::Allocations::Scope steady;
+            perft(first, depth);
+            std::cout << "steady state: " << steady.count() << " allocations of " << steady.bytes() << " bytes at depth " << depth << std::endl;
+            if(steady.count() != 0)
+            {
+                std::cerr << "perft allocated after warming up" << std::endl;
+                return 1;
+            }
+        }
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << typeid(e).name() << " caught in main: " << e.what() << std::endl;
+        return -1;
+    }
+}
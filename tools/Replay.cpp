@@ -0,0 +1,155 @@
+#include "config/BoardConfig.hpp"
+#include "board/Board.hpp"
+#include "engine/MoveGenerator.hpp"
+#include "engine/GameRecord.hpp"
+#include "Exception.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <typeinfo>
+#include <cstdint>
+#include <cstddef>
+
+namespace
+{
+    using namespace chesspp;
+    using engine::Board;
+    using engine::Players_t;
+    using Key_t = board::Zobrist::Key_t;
+
+    static std::size_t const MaxPlies = 400; //of the random games, which rarely end by themselves
+
+    //Plays random legal moves from the initial layout, recording them,
+    //and returns the hash of the final position
+    static Key_t playRandom(config::BoardConfig const &config, Players_t const &players, std::size_t first, engine::GameRecorder &recorder, std::mt19937 &rng)
+    {
+        Board board {config};
+        engine::MoveGenerator generate;
+        engine::Moves_t moves;
+        recorder.begin(board, first);
+        std::size_t turn = first;
+        for(std::size_t ply = 0; ply < MaxPlies; ++ply)
+        {
+            generate(board, players[turn], moves);
+            if(moves.empty()) break;
+            if(!engine::MoveGenerator::play(board, moves[rng() % moves.size()])) break;
+            turn = (turn + 1) % players.size();
+        }
+        recorder.end();
+        return board.hash();
+    }
+}
+
+int main(int argc, char const *const *argv)
+{
+    std::string path = "config/chesspp/board.json";
+    std::size_t record = 0;
+    unsigned seed = 1;
+    std::vector<std::string> args (argv + 1, argv + argc); //don't use {}
+    if(args.size() >= 3 && args[0] == "--board")
+    {
+        path = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if(args.size() >= 3 && args[0] == "--record")
+    {
+        if(!(std::istringstream{args[1]} >> record) || record == 0)
+        {
+            std::cerr << "--record needs a number of games" << std::endl;
+            return 1;
+        }
+        args.erase(args.begin(), args.begin() + 2);
+        if(args.size() >= 3 && args[0] == "--seed" && (std::istringstream{args[1]} >> seed))
+        {
+            args.erase(args.begin(), args.begin() + 2);
+        }
+    }
+    if(args.size() != 1)
+    {
+        std::cerr << "usage: " << argv[0] << " [--board board.json] [--record games [--seed N]] games.rec" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::clog.rdbuf(nullptr); //creating pieces is logged, which would drown out the results
+
+        config::BoardConfig board_config {path};
+        std::size_t first = 0;
+        Players_t players = engine::players(board_config, first);
+        if(players.empty())
+        {
+            std::cerr << "no suits in " << path << std::endl;
+            return 1;
+        }
+
+        Key_t recorded = 0; //xor of the hashes of the final positions
+        if(record > 0)
+        {
+            std::mt19937 rng {seed};
+            engine::GameRecorder recorder {board_config, args[0]};
+            auto start = std::chrono::steady_clock::now();
+            for(std::size_t g = 0; g < record; ++g)
+            {
+                recorded ^= playRandom(board_config, players, first, recorder, rng);
+            }
+            if(!recorder.flush())
+            {
+                std::cerr << "could not write " << args[0] << std::endl;
+                return 1;
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "recorded " << record << " random games in " << elapsed.count() << "s" << std::endl;
+        }
+
+        engine::GameReplay replay {board_config, args[0]};
+        if(!replay.valid())
+        {
+            std::cerr << args[0] << " is not a record of games on this board" << std::endl;
+            return 1;
+        }
+        std::vector<Key_t> finals; //hashes of the final positions, by game
+        auto start = std::chrono::steady_clock::now();
+        while(replay.next([&](Board const &b, std::size_t, engine::PackedMove const &m)
+        {
+            if(!m) finals.push_back(b.hash());
+        }))
+        {
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "replayed " << replay.games() << " games, " << replay.moves() << " moves in " << elapsed.count() << "s";
+        if(elapsed.count() > 0)
+        {
+            std::cout << " (" << std::uint64_t(replay.moves()/elapsed.count()) << " moves/sec)";
+        }
+        std::cout << std::endl;
+        if(replay.failed())
+        {
+            std::cerr << "game " << replay.games() + 1 << " is malformed or a move of it could not be made" << std::endl;
+            return 1;
+        }
+        if(record > 0)
+        {
+            //the recorded games are the last ones, after any the file already held
+            Key_t replayed = 0;
+            for(std::size_t g = finals.size() - record; g < finals.size(); ++g)
+            {
+                replayed ^= finals[g];
+            }
+            if(replayed != recorded)
+            {
+                std::cerr << "the final positions of the replayed games differ from the recorded ones" << std::endl;
+                return 1;
+            }
+        }
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << typeid(e).name() << " caught in main: " << e.what() << std::endl;
+        return -1;
+    }
+}
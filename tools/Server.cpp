@@ -0,0 +1,76 @@
+#include "config/BoardConfig.hpp"
+#include "server/Server.hpp"
+#include "Debug.hpp"
+#include "Exception.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <typeinfo>
+#include <csignal>
+#include <cstdlib>
+#include <cstdint>
+
+namespace
+{
+    chesspp::server::Server *serving = nullptr;
+
+    extern "C" void interrupted(int)
+    {
+        if(serving) serving->stop();
+    }
+}
+
+int main(int argc, char const *const *argv)
+{
+    using namespace chesspp;
+    std::string path = "config/chesspp/board.json";
+    std::string address = "127.0.0.1";
+    unsigned port = 7878;
+    std::size_t threads = 0;
+    std::vector<std::string> args (argv + 1, argv + argc); //don't use {}
+    for(std::size_t i = 0; i + 1 < args.size(); i += 2)
+    {
+        bool ok = true;
+        if     (args[i] == "--board")   path = args[i + 1];
+        else if(args[i] == "--address") address = args[i + 1];
+        else if(args[i] == "--port")    ok = bool(std::istringstream{args[i + 1]} >> port) && port <= 65535;
+        else if(args[i] == "--threads") ok = bool(std::istringstream{args[i + 1]} >> threads);
+        else ok = false;
+        if(!ok)
+        {
+            args.clear();
+            args.push_back("");
+            break;
+        }
+    }
+    if(args.size()%2 != 0)
+    {
+        std::cerr << "usage: " << argv[0] << " [--board board.json] [--address 127.0.0.1] [--port 7878] [--threads N]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        if(!std::getenv("CHESSPP_LOG_LEVEL"))
+        {
+            LogUtil::setLevel(LogUtil::Level::Warning); //every new game creates its pieces, which is logged
+        }
+        config::BoardConfig board_config {path}; //shared by every game
+        server::Server server {board_config, address, std::uint16_t(port), threads};
+        std::cout << "serving " << path << " on " << address << ":" << server.port()
+                  << " with " << server.threadCount() << " threads" << std::endl;
+
+        serving = &server;
+        std::signal(SIGINT, interrupted);
+        std::signal(SIGTERM, interrupted);
+        server.run();
+        serving = nullptr;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << typeid(e).name() << " caught in main: " << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,51 @@
+#include "config/BoardConfig.hpp"
+#include "engine/RetrogradeTablebase.hpp"
+#include "Exception.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <typeinfo>
+
+int main(int argc, char const *const *argv)
+{
+    using namespace chesspp;
+    std::string path = "config/chesspp/board.json";
+    std::vector<std::string> args (argv + 1, argv + argc); //don't use {}
+    if(args.size() >= 2 && args[0] == "--board")
+    {
+        path = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if(args.size() < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " [--board board.json] output.tb Suit:Class..." << std::endl;
+        std::cerr << "e.g. " << argv[0] << " kak.tb White:King White:Archer Black:King" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::clog.rdbuf(nullptr); //every position sets up a board, which is logged
+        config::BoardConfig board_config {path};
+        engine::RetrogradeTablebase::Material_t material (args.begin() + 1, args.end()); //don't use {}
+
+        auto start = std::chrono::steady_clock::now();
+        engine::RetrogradeTablebase::generate(board_config, material, args[0]);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        engine::RetrogradeTablebase check {{args[0]}};
+        if(check.size() != 1)
+        {
+            std::cerr << "could not read back " << args[0] << std::endl;
+            return 1;
+        }
+        std::cout << "wrote " << args[0] << " in " << elapsed.count() << "s" << std::endl;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << typeid(e).name() << " caught in main: " << e.what() << std::endl;
+        return -1;
+    }
+}